@@ -92,10 +92,15 @@ bool runClear(const json &args) {
 
   const bool promptCheck = !options["yes"];
 
-  if (options["all"] &&
-      safeRmrf(env::OCCA_CACHE_DIR, promptCheck)) {
-    printRemovedMessage(true);
-    return true;
+  if (options["all"]) {
+    bool removedSomething = safeRmrf(env::OCCA_CACHE_DIR, promptCheck);
+    if (env::OCCA_LOCAL_CACHE_DIR.size()) {
+      removedSomething |= safeRmrf(env::OCCA_LOCAL_CACHE_DIR, promptCheck);
+    }
+    if (removedSomething) {
+      printRemovedMessage(true);
+      return true;
+    }
   }
 
   bool removedSomething = false;
@@ -111,7 +116,11 @@ bool runClear(const json &args) {
   }
 
   if (options["kernels"]) {
-    removedSomething |= safeRmrf(io::cachePath(), promptCheck);
+    removedSomething |= safeRmrf(env::OCCA_CACHE_DIR + "cache/", promptCheck);
+    if (io::localCachePath().size()) {
+      removedSomething |= safeRmrf(io::localCachePath(), promptCheck);
+    }
+    removedSomething |= safeRmrf(io::cachePackFilename(), promptCheck);
   }
   if (options["locks"]) {
     const std::string lockPath = env::OCCA_CACHE_DIR + "locks/";
@@ -245,6 +254,9 @@ bool runEnv(const json &args) {
   std::cout << "  Basic:\n"
             << "    - OCCA_DIR                   : " << envEcho("OCCA_DIR") << "\n"
             << "    - OCCA_CACHE_DIR             : " << envEcho("OCCA_CACHE_DIR") << "\n"
+            << "    - OCCA_LOCAL_CACHE_DIR       : " << envEcho("OCCA_LOCAL_CACHE_DIR") << "\n"
+            << "    - OCCA_CACHE_PACK            : " << envEcho("OCCA_CACHE_PACK") << "\n"
+            << "    - OCCA_CACHE_PACK_MAX_BYTES  : " << envEcho("OCCA_CACHE_PACK_MAX_BYTES") << "\n"
             << "    - OCCA_VERBOSE               : " << envEcho("OCCA_VERBOSE") << "\n"
             << "    - OCCA_UNSAFE                : " << OCCA_UNSAFE << "\n"
 
@@ -4,6 +4,7 @@
 #include <occa/defines.hpp>
 #include <occa/core/base.hpp>
 #include <occa/tools/misc.hpp>
+#include <occa/array/expression.hpp>
 #include <occa/array/linalg.hpp>
 
 namespace occa {
@@ -375,6 +376,22 @@ namespace occa {
 
     template <class TM2, const int idxType2>
     array& operator /= (const array<TM2,idxType2> &vec);
+
+    // Fused into one kernel, see occa/array/expression.hpp
+    template <class EXPR>
+    array& operator = (const arrayExpr<EXPR> &expr);
+
+    template <class EXPR>
+    array& operator += (const arrayExpr<EXPR> &expr);
+
+    template <class EXPR>
+    array& operator -= (const arrayExpr<EXPR> &expr);
+
+    template <class EXPR>
+    array& operator *= (const arrayExpr<EXPR> &expr);
+
+    template <class EXPR>
+    array& operator /= (const arrayExpr<EXPR> &expr);
     //==================================
 
     //---[ Linear Algebra ]-------------
@@ -1088,6 +1088,41 @@ namespace occa {
     linalg::operator_div_eq<TM2,TM>(vec.memory_, memory_);
     return *this;
   }
+
+  template <class TM, const int idxType>
+  template <class EXPR>
+  array<TM,idxType>& array<TM,idxType>::operator = (const arrayExpr<EXPR> &expr) {
+    runArrayExpr<TM>(memory_, size(), "=", expr);
+    return *this;
+  }
+
+  template <class TM, const int idxType>
+  template <class EXPR>
+  array<TM,idxType>& array<TM,idxType>::operator += (const arrayExpr<EXPR> &expr) {
+    runArrayExpr<TM>(memory_, size(), "+=", expr);
+    return *this;
+  }
+
+  template <class TM, const int idxType>
+  template <class EXPR>
+  array<TM,idxType>& array<TM,idxType>::operator -= (const arrayExpr<EXPR> &expr) {
+    runArrayExpr<TM>(memory_, size(), "-=", expr);
+    return *this;
+  }
+
+  template <class TM, const int idxType>
+  template <class EXPR>
+  array<TM,idxType>& array<TM,idxType>::operator *= (const arrayExpr<EXPR> &expr) {
+    runArrayExpr<TM>(memory_, size(), "*=", expr);
+    return *this;
+  }
+
+  template <class TM, const int idxType>
+  template <class EXPR>
+  array<TM,idxType>& array<TM,idxType>::operator /= (const arrayExpr<EXPR> &expr) {
+    runArrayExpr<TM>(memory_, size(), "/=", expr);
+    return *this;
+  }
   //====================================
 
   //---[ Linear Algebra ]---------------
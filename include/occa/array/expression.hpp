@@ -0,0 +1,219 @@
+#ifndef OCCA_ARRAY_EXPRESSION_HEADER
+#define OCCA_ARRAY_EXPRESSION_HEADER
+
+#include <sstream>
+
+#include <occa/defines.hpp>
+#include <occa/array/linalg.hpp>
+
+namespace occa {
+  template <class TM, const int idxType>
+  class array;
+
+  //---[ Array Expressions ]------------
+  // Lazy elementwise expressions on occa::array
+  //
+  //   a = b + alpha * c * d;
+  //
+  // builds the formula "v0[i] = (v1[i] + ((c0 * v2[i]) * v3[i]));" and runs
+  //   it as one generated kernel when assigned to an array.
+  // Kernels are cached by the expression shape and argument types.
+  //
+  // Only float and double scalars take part in expressions, integers
+  //   keep their array subarray meaning (array + offset)
+  template <class EXPR>
+  class arrayExpr {
+  public:
+    inline const EXPR& derived() const {
+      return static_cast<const EXPR&>(*this);
+    }
+
+    // Appends the expression to the formula and its operands to args
+    inline void build(std::stringstream &formula,
+                      linalg::linearMethodArgs &args) const {
+      derived().build(formula, args);
+    }
+  };
+
+  template <class TM>
+  class arrayExprVector : public arrayExpr<arrayExprVector<TM> > {
+  public:
+    occa::memory vec;
+
+    arrayExprVector(const occa::memory &vec_) :
+      vec(vec_) {}
+
+    inline void build(std::stringstream &formula,
+                      linalg::linearMethodArgs &args) const {
+      formula << 'v' << args.addVector(vec,
+                                       sizeof(TM),
+                                       primitiveinfo<TM>::name)
+              << "[i]";
+    }
+  };
+
+  template <class TM>
+  class arrayExprConstant : public arrayExpr<arrayExprConstant<TM> > {
+  public:
+    TM value;
+
+    arrayExprConstant(const TM value_) :
+      value(value_) {}
+
+    inline void build(std::stringstream &formula,
+                      linalg::linearMethodArgs &args) const {
+      formula << 'c' << args.addConstant(value,
+                                         primitiveinfo<TM>::name);
+    }
+  };
+
+  namespace arrayExprOp {
+    class add { public: static inline char symbol() { return '+'; } };
+    class sub { public: static inline char symbol() { return '-'; } };
+    class mul { public: static inline char symbol() { return '*'; } };
+    class div { public: static inline char symbol() { return '/'; } };
+  }
+
+  template <class LHS, class RHS, class OP>
+  class arrayExprBinary : public arrayExpr<arrayExprBinary<LHS, RHS, OP> > {
+  public:
+    LHS lhs;
+    RHS rhs;
+
+    arrayExprBinary(const LHS &lhs_,
+                    const RHS &rhs_) :
+      lhs(lhs_),
+      rhs(rhs_) {}
+
+    inline void build(std::stringstream &formula,
+                      linalg::linearMethodArgs &args) const {
+      formula << '(';
+      lhs.build(formula, args);
+      formula << ' ' << OP::symbol() << ' ';
+      rhs.build(formula, args);
+      formula << ')';
+    }
+  };
+
+  //---[ Operands ]---------------------
+  // Maps operator arguments to expression nodes
+  // Types without a specialization can't be used in expressions
+  template <class TM>
+  class arrayExprOperand {
+  public:
+    static const bool isOperand = false;
+    static const bool isExpr = false;
+  };
+
+  template <class TM, const int idxType>
+  class arrayExprOperand<array<TM, idxType> > {
+  public:
+    static const bool isOperand = true;
+    static const bool isExpr = true;
+    typedef arrayExprVector<TM> type;
+
+    static inline type get(const array<TM, idxType> &arr) {
+      return type(arr.memory());
+    }
+  };
+
+  template <class TM>
+  class arrayExprOperand<arrayExprVector<TM> > {
+  public:
+    static const bool isOperand = true;
+    static const bool isExpr = true;
+    typedef arrayExprVector<TM> type;
+
+    static inline const type& get(const type &expr) {
+      return expr;
+    }
+  };
+
+  template <class LHS, class RHS, class OP>
+  class arrayExprOperand<arrayExprBinary<LHS, RHS, OP> > {
+  public:
+    static const bool isOperand = true;
+    static const bool isExpr = true;
+    typedef arrayExprBinary<LHS, RHS, OP> type;
+
+    static inline const type& get(const type &expr) {
+      return expr;
+    }
+  };
+
+#define OCCA_ARRAY_EXPR_SCALAR(TYPE)                    \
+  template <>                                           \
+  class arrayExprOperand<TYPE> {                        \
+  public:                                               \
+    static const bool isOperand = true;                 \
+    static const bool isExpr = false;                   \
+    typedef arrayExprConstant<TYPE> type;               \
+                                                        \
+    static inline type get(const TYPE value) {          \
+      return type(value);                               \
+    }                                                   \
+  }
+
+  OCCA_ARRAY_EXPR_SCALAR(float);
+  OCCA_ARRAY_EXPR_SCALAR(double);
+
+#undef OCCA_ARRAY_EXPR_SCALAR
+
+  // Only defines [type] if at least one side is an array expression
+  template <class LHS, class RHS, class OP,
+            const bool isValid = (arrayExprOperand<LHS>::isOperand
+                                  && arrayExprOperand<RHS>::isOperand
+                                  && (arrayExprOperand<LHS>::isExpr
+                                      || arrayExprOperand<RHS>::isExpr))>
+  class arrayExprResult {};
+
+  template <class LHS, class RHS, class OP>
+  class arrayExprResult<LHS, RHS, OP, true> {
+  public:
+    typedef arrayExprBinary<typename arrayExprOperand<LHS>::type,
+                            typename arrayExprOperand<RHS>::type,
+                            OP> type;
+
+    static inline type get(const LHS &lhs, const RHS &rhs) {
+      return type(arrayExprOperand<LHS>::get(lhs),
+                  arrayExprOperand<RHS>::get(rhs));
+    }
+  };
+  //====================================
+
+  //---[ Operators ]--------------------
+#define OCCA_ARRAY_EXPR_OPERATOR(OPERATOR, OP)                          \
+  template <class LHS, class RHS>                                       \
+  inline typename arrayExprResult<LHS, RHS, arrayExprOp::OP>::type      \
+  operator OPERATOR (const LHS &lhs, const RHS &rhs) {                  \
+    return arrayExprResult<LHS, RHS, arrayExprOp::OP>::get(lhs, rhs);   \
+  }
+
+  OCCA_ARRAY_EXPR_OPERATOR(+, add)
+  OCCA_ARRAY_EXPR_OPERATOR(-, sub)
+  OCCA_ARRAY_EXPR_OPERATOR(*, mul)
+  OCCA_ARRAY_EXPR_OPERATOR(/, div)
+
+#undef OCCA_ARRAY_EXPR_OPERATOR
+  //====================================
+
+  // Runs "v0[i] <assignment> <expr>;" with [out] as v0
+  template <class TM, class EXPR>
+  void runArrayExpr(occa::memory out,
+                    const dim_t entries,
+                    const std::string &assignment,
+                    const arrayExpr<EXPR> &expr) {
+    linalg::linearMethodArgs args;
+    args.addVector(out, sizeof(TM), primitiveinfo<TM>::name);
+
+    std::stringstream formula;
+    formula << "v0[i] " << assignment << ' ';
+    expr.build(formula, args);
+    formula << ';';
+
+    linalg::runLinearMethod(formula.str(), args, entries);
+  }
+  //====================================
+}
+
+#endif
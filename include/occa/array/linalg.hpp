@@ -1,6 +1,7 @@
 #ifndef OCCA_ARRAY_LINALG_HEADER
 #define OCCA_ARRAY_LINALG_HEADER
 
+#include <algorithm>
 #include <cmath>
 
 #include <occa/defines.hpp>
@@ -16,13 +17,10 @@ namespace occa {
     };
 
     template <class VTYPE_IN, class VTYPE_OUT>
-    kernelBuilder makeAssignmentBuilder(const std::string &kernelName,
-                                        const int tileSize);
+    kernelBuilder makeAssignmentBuilder(const std::string &kernelName);
 
-    template <class VTYPE_IN, class VTYPE_OUT>
-    kernelBuilderVector makeAssignmentBuilders(const std::string &kernelName);
-
-    inline occa::kernel getTiledKernel(kernelBuilderVector &builders,
+    // Builds the kernel with TILESIZE rounded down to a used tile size
+    inline occa::kernel getTiledKernel(kernelBuilder &builder,
                                        occa::device dev,
                                        const int tileSize) {
       int i;
@@ -31,9 +29,74 @@ namespace occa {
           break;
         }
       }
-      return builders[i - 1].build(dev);
+      occa::properties props;
+      props["defines/TILESIZE"] = usedTileSizes[i - 1];
+      return builder.build(dev, props);
     }
 
+    //---[ Autotuning ]-----------------
+    // Reductions write at most this many partial results
+    static const int maxReductionBufferSize = 4096;
+
+    // Entries launched by each autotuning run
+    static const int maxTuningEntries = (1 << 20);
+
+    // Launches linalg kernels while autotuning
+    // The output argument is swapped for a scratch copy of its first
+    //   maxTuningEntries entries so tuning runs don't modify the user's data
+    // Kernels with an output take the entry count as their first argument
+    class launchBenchmark : public kernelBenchmark {
+    public:
+      std::vector<kernelArg> args;
+      int outputIndex;
+      int outputEntryBytes;
+      dim_t tuningEntries;
+      occa::memory output, scratchOutput;
+
+      launchBenchmark();
+
+      void setOutput(occa::memory output_,
+                     const dim_t entries,
+                     const int outputEntryBytes_);
+
+      virtual void run(occa::kernel kernel);
+    };
+
+    const occa::json& tileSizeSpace();
+
+    const occa::json& reductionSpace(occa::device dev);
+
+    int reductionBufferSize(occa::kernel kernel);
+
+    // A tileSize of 0 autotunes it
+    // Tuning runs are capped to maxTuningEntries, so larger problem sizes
+    //   share a single tuned kernel
+    occa::kernel getTiledKernel(kernelBuilder &builder,
+                                occa::device dev,
+                                const int tileSize,
+                                launchBenchmark &benchmark,
+                                const dim_t entries);
+
+    // Entries launched at once by a tiled kernel, or 0 if unlimited
+    // Backends cap the number of work-groups per launch, which can be
+    //   lowered with the device property linalg/max_launch_entries
+    dim_t maxLaunchEntries(occa::kernel kernel);
+
+    occa::memory sliceEntries(occa::memory mem,
+                              const int entryBytes,
+                              const dim_t offset,
+                              const dim_t count);
+
+    // [arg] is sliced alongside [out] if it's an occa::memory
+    void runTiledKernel(kernelBuilder &builder,
+                        const int tileSize,
+                        const dim_t entries,
+                        const kernelArg &arg,
+                        const int argEntryBytes,
+                        occa::memory out,
+                        const int outEntryBytes);
+    //==================================
+
     template <class VTYPE, class RETTYPE>
     kernelBuilder makeLinalgBuilder(const std::string &kernelName);
 
@@ -44,71 +107,151 @@ namespace occa {
     template <class VTYPE_OUT>
     void operator_eq(occa::memory vec,
                      const VTYPE_OUT value,
-                     const int tileSize = 128);
+                     const int tileSize = 0);
 
     template <class VTYPE_OUT>
     void operator_plus_eq(occa::memory vec,
                           const VTYPE_OUT value,
-                          const int tileSize = 128);
+                          const int tileSize = 0);
 
     template <class VTYPE_IN, class VTYPE_OUT>
     void operator_plus_eq(occa::memory in,
                           occa::memory out,
-                          const int tileSize = 128);
+                          const int tileSize = 0);
 
     template <class VTYPE_OUT>
     void operator_sub_eq(occa::memory vec,
                          const VTYPE_OUT value,
-                         const int tileSize = 128);
+                         const int tileSize = 0);
 
     template <class VTYPE_IN, class VTYPE_OUT>
     void operator_sub_eq(occa::memory in,
                          occa::memory out,
-                         const int tileSize = 128);
+                         const int tileSize = 0);
 
     template <class VTYPE_OUT>
     void operator_mult_eq(occa::memory vec,
                           const VTYPE_OUT value,
-                          const int tileSize = 128);
+                          const int tileSize = 0);
 
     template <class VTYPE_IN, class VTYPE_OUT>
     void operator_mult_eq(occa::memory in,
                           occa::memory out,
-                          const int tileSize = 128);
+                          const int tileSize = 0);
 
     template <class VTYPE_OUT>
     void operator_div_eq(occa::memory vec,
                          const VTYPE_OUT value,
-                         const int tileSize = 128);
+                         const int tileSize = 0);
 
     template <class VTYPE_IN, class VTYPE_OUT>
     void operator_div_eq(occa::memory in,
                          occa::memory out,
-                         const int tileSize = 128);
+                         const int tileSize = 0);
     //==================================
 
     //---[ Linear Algebra ]-------------
-    template <class TM>
-    inline std::map<int, TM*>& hostBufferMap() {
-      static std::map<int, TM*> bufferMap;
-      return bufferMap;
-    }
-
-    inline hashedMemoryMap& deviceBufferMap() {
-      static hashedMemoryMap bufferMap;
-      return bufferMap;
-    }
-
+    // Reused between calls, only valid until the next reduction
     template <class TM>
     TM *hostReductionBuffer(const int size);
 
+    // Must be called inside an occa::scratchScope
     template <class TM>
     occa::memory deviceReductionBuffer(occa::device device,
                                        const int size);
 
-    template <class VTYPE, class RETTYPE>
-    RETTYPE* reduce(occa::memory vec,
-                    occa::kernelBuilder &builder);
+    // Kernels write [outputsPerBlock] partial results per block
+    template <class RETTYPE>
+    RETTYPE* reduce(occa::device dev,
+                    occa::kernelBuilder &builder,
+                    launchBenchmark &launch,
+                    const dim_t entries,
+                    int &bufferSize,
+                    const int outputsPerBlock = 1);
+
+    //---[ Async Reductions ]-----------
+    // Reduction result kept on the device
+    //
+    //   linalg::asyncReduction<double> rr = linalg::dotAsync<double, double, double>(r, r);
+    //   updateKernel(rr.result, ...);
+    //   const double rrValue = rr.value();
+    //
+    // Both stages are queued on the current stream without synchronizing
+    template <class TM>
+    class asyncReduction {
+    public:
+      occa::device device;
+      // Single entry with the final result
+      occa::memory result;
+      occa::streamTag tag;
+
+      bool isInitialized() const {
+        return result.isInitialized();
+      }
+
+      void wait() {
+        if (tag.isInitialized()) {
+          device.waitFor(tag);
+        }
+      }
+
+      TM value() {
+        TM value_;
+        wait();
+        result.copyTo(&value_, sizeof(TM));
+        return value_;
+      }
+    };
+
+    // Operation used to combine partial results on the device
+    namespace finalOp {
+      static const int sum = 0;
+      static const int max = 1;
+      static const int min = 2;
+    }
+
+    // Floating type used on the device for roots and exponents of RETTYPE
+    //   results (ROOTTYPE in linalg.okl)
+    // Float results stay in float for backends without fp64 support
+    template <class RETTYPE>
+    class rootType {
+    public:
+      typedef float type;
+    };
+
+    template <>
+    class rootType<double> {
+    public:
+      typedef double type;
+    };
+
+    // Device buffers reused by reductions on the device's current stream
+    // Work on a stream runs in order, so a reduction is done with them
+    //   before the next reduction queued on the stream overwrites them
+    occa::memory streamReductionBuffer(occa::device dev,
+                                       const udim_t bytes);
+
+    occa::memory streamResultBuffer(occa::device dev,
+                                    const udim_t bytes);
+
+    template <class RETTYPE>
+    occa::kernel getFinalReductionKernel(occa::device dev,
+                                         const int op,
+                                         const bool useExponent);
+
+    // Writes the reduction into result[0], allocating it if needed
+    // The result is raised to [exponent] if [useExponent] is set
+    // Partial results live in the stream's reduction buffer
+    template <class RETTYPE>
+    asyncReduction<RETTYPE> reduceAsync(occa::device dev,
+                                        occa::kernelBuilder &builder,
+                                        launchBenchmark &launch,
+                                        const dim_t entries,
+                                        const int op,
+                                        occa::memory result,
+                                        const bool useExponent = false,
+                                        const double exponent = 1.0);
+    //==================================
 
     template <class VTYPE, class RETTYPE>
     RETTYPE l1Norm(occa::memory vec);
@@ -119,6 +262,9 @@ namespace occa {
     template <class VTYPE, class RETTYPE>
     RETTYPE lpNorm(const float p, occa::memory vec);
 
+    template <class VTYPE, class RETTYPE>
+    RETTYPE lpNormPower(const float p, occa::memory vec);
+
     template <class VTYPE, class RETTYPE>
     RETTYPE lInfNorm(occa::memory vec);
 
@@ -131,21 +277,224 @@ namespace occa {
     template <class VTYPE1, class VTYPE2, class RETTYPE>
     RETTYPE dot(occa::memory vec1, occa::memory vec2);
 
+    //---[ Reduction Tuples ]-----------
+    // User-composed reductions computed together with one pass over a
+    //   vector, each term reduces a formula of the entry [v] (as VTYPE)
+    //   converted to RETTYPE
+    //
+    //   linalg::reductionTuple terms;
+    //   const int cubes = terms.sum("(double) v * v * v");
+    //   const int maxAbs = terms.max("fabs(v)");
+    //   std::vector<double> values = linalg::reduce<float, double>(vec, terms);
+    //   values[cubes], values[maxAbs]
+    class reductionTuple {
+    public:
+      enum op_t {
+        sum_,
+        min_,
+        max_
+      };
+
+      std::vector<op_t> ops;
+      std::vector<std::string> formulas;
+
+      // Each returns the index of the term's result
+      int sum(const std::string &formula);
+      int min(const std::string &formula);
+      int max(const std::string &formula);
+
+      int size() const;
+
+      // Key for the generated kernel
+      std::string toString() const;
+
+      // Macros used by the stats kernel in linalg.okl
+      std::string kernelDefines() const;
+
+    private:
+      int add(const op_t op,
+              const std::string &formula);
+    };
+
+    // Stats kernel from linalg.okl computing [terms]
+    kernelBuilder makeReductionTupleBuilder(const reductionTuple &terms,
+                                            const occa::properties &props);
+
+    // Zero-initialized results for empty vectors
+    template <class VTYPE, class RETTYPE>
+    std::vector<RETTYPE> reduce(occa::memory vec,
+                                const reductionTuple &terms);
+
+    // Statistics computed together by linalg::stats, combined with |
+    //   linalg::stats<float, double>(vec, stat::min | stat::max)
+    namespace stat {
+      static const int min      = (1 << 0);
+      static const int max      = (1 << 1);
+      static const int sum      = (1 << 2);
+      static const int l1Norm   = (1 << 3);
+      static const int l2Norm   = (1 << 4);
+      static const int lInfNorm = (1 << 5);
+      static const int all      = (1 << 6) - 1;
+    }
+
+    // Only statistics set in [flags] are computed
+    template <class TM>
+    class vectorStats {
+    public:
+      int flags;
+      TM min, max, sum;
+      TM l1Norm, l2Norm, lInfNorm;
+
+      vectorStats(const int flags_ = 0) :
+        flags(flags_),
+        min(0),
+        max(0),
+        sum(0),
+        l1Norm(0),
+        l2Norm(0),
+        lInfNorm(0) {}
+
+      bool has(const int stat) const {
+        return (flags & stat);
+      }
+    };
+
+    // Computes all requested statistics with one pass over [vec]
+    //   as a reductionTuple of the built-in terms
+    template <class VTYPE, class RETTYPE>
+    vectorStats<RETTYPE> stats(occa::memory vec,
+                               const int flags = stat::all);
+    //==================================
+
     template <class VTYPE1, class VTYPE2, class RETTYPE>
     RETTYPE distance(occa::memory vec1, occa::memory vec2);
 
     template <class VTYPE, class RETTYPE>
     RETTYPE sum(occa::memory vec);
 
+    template <class VTYPE, class RETTYPE>
+    asyncReduction<RETTYPE> l1NormAsync(occa::memory vec,
+                                        occa::memory result = occa::memory());
+
+    template <class VTYPE, class RETTYPE>
+    asyncReduction<RETTYPE> l2NormAsync(occa::memory vec,
+                                        occa::memory result = occa::memory());
+
+    template <class VTYPE, class RETTYPE>
+    asyncReduction<RETTYPE> lpNormAsync(const float p,
+                                        occa::memory vec,
+                                        occa::memory result = occa::memory());
+
+    // Sum of |vec[i]|^p, the lpNorm before taking its p-th root
+    template <class VTYPE, class RETTYPE>
+    asyncReduction<RETTYPE> lpNormPowerAsync(const float p,
+                                             occa::memory vec,
+                                             occa::memory result = occa::memory());
+
+    template <class VTYPE, class RETTYPE>
+    asyncReduction<RETTYPE> lInfNormAsync(occa::memory vec,
+                                          occa::memory result = occa::memory());
+
+    template <class VTYPE, class RETTYPE>
+    asyncReduction<RETTYPE> maxAsync(occa::memory vec,
+                                     occa::memory result = occa::memory());
+
+    template <class VTYPE, class RETTYPE>
+    asyncReduction<RETTYPE> minAsync(occa::memory vec,
+                                     occa::memory result = occa::memory());
+
+    template <class VTYPE1, class VTYPE2, class RETTYPE>
+    asyncReduction<RETTYPE> dotAsync(occa::memory vec1,
+                                     occa::memory vec2,
+                                     occa::memory result = occa::memory());
+
+    template <class VTYPE1, class VTYPE2, class RETTYPE>
+    asyncReduction<RETTYPE> distanceAsync(occa::memory vec1,
+                                          occa::memory vec2,
+                                          occa::memory result = occa::memory());
+
+    template <class VTYPE, class RETTYPE>
+    asyncReduction<RETTYPE> sumAsync(occa::memory vec,
+                                     occa::memory result = occa::memory());
+
     template <class TYPE_A, class VTYPE_X, class VTYPE_Y>
     void axpy(const TYPE_A &alpha,
               occa::memory x,
               occa::memory y,
-              const int tileSize = 128);
+              const int tileSize = 0);
+
+    //---[ Batched ]--------------------
+    // Operations on many short vectors with one launch
+    //
+    //   occa::memory rr = linalg::batchedDot<double, double, double>(
+    //     batches, lengths, r, rOffsets, r, rOffsets
+    //   );
+    //
+    // Vector b of each operand holds the entries
+    //   vec[offsets[b]], ..., vec[offsets[b] + lengths[b] - 1]
+    //   where [lengths] and [offsets] are device buffers of [batches] dim_t
+    // Operands can share a buffer or live in separate ones
+    // Results are written to a device buffer with [batches] entries,
+    //   allocated if not given, without synchronizing
+    template <class VTYPE1, class VTYPE2, class RETTYPE>
+    occa::memory batchedDot(const int batches,
+                            occa::memory lengths,
+                            occa::memory vec1,
+                            occa::memory offsets1,
+                            occa::memory vec2,
+                            occa::memory offsets2,
+                            occa::memory result = occa::memory());
+
+    // l2 norms
+    template <class VTYPE, class RETTYPE>
+    occa::memory batchedNorm(const int batches,
+                             occa::memory lengths,
+                             occa::memory vec,
+                             occa::memory offsets,
+                             occa::memory result = occa::memory());
+
+    // y_b += alpha[b] * x_b, [alpha] is a device buffer with [batches] entries
+    //   such as the result of a batched reduction
+    template <class TYPE_A, class VTYPE_X, class VTYPE_Y>
+    void batchedAxpy(const int batches,
+                     occa::memory lengths,
+                     occa::memory alpha,
+                     occa::memory x,
+                     occa::memory xOffsets,
+                     occa::memory y,
+                     occa::memory yOffsets);
+    //==================================
 
     kernelBuilder customLinearMethod(const std::string &kernelName,
                                      const std::string &formula,
                                      const occa::properties &props = occa::properties());
+
+    // Arguments of a generated customLinearMethod kernel
+    //   Vector v0 is the output, constants are c0, c1, ...
+    class linearMethodArgs {
+    public:
+      std::vector<occa::memory> vectors;
+      std::vector<int> vectorBytes;
+      strVector vectorTypes;
+
+      std::vector<kernelArg> constants;
+      strVector constantTypes;
+
+      // Returns the vector/constant index used in the formula
+      int addVector(occa::memory vec,
+                    const int entryBytes,
+                    const std::string &type);
+
+      int addConstant(const kernelArg &value,
+                      const std::string &type);
+    };
+
+    // Runs [formula] on [entries] entries of the vectors in [args]
+    // Kernels are cached by formula and argument types
+    void runLinearMethod(const std::string &formula,
+                         const linearMethodArgs &args,
+                         const dim_t entries,
+                         const int tileSize = 0);
     //==================================
   }
 }
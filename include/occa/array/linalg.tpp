@@ -1,27 +1,16 @@
 namespace occa {
   namespace linalg {
     template <class VTYPE_IN, class VTYPE_OUT>
-    kernelBuilder makeAssignmentBuilder(const std::string &kernelName,
-                                        const int tileSize) {
+    kernelBuilder makeAssignmentBuilder(const std::string &kernelName) {
       return kernelBuilder::fromFile(env::OCCA_DIR + "include/occa/array/kernels/assignment.okl",
                                      kernelName,
                                      "defines: {"
                                      "  VTYPE_IN: '"  + primitiveinfo<VTYPE_IN>::name  + "',"
                                      "  VTYPE_OUT: '" + primitiveinfo<VTYPE_OUT>::name + "',"
-                                     "  TILESIZE: '"  + toString(tileSize) + "',"
+                                     "  TILESIZE: 128,"
                                      "}");
     }
 
-    template <class VTYPE_IN, class VTYPE_OUT>
-    kernelBuilderVector makeAssignmentBuilders(const std::string &kernelName) {
-      kernelBuilderVector builders;
-      for (int i = 0; i < usedTileSizeCount; ++i) {
-        builders.push_back(makeAssignmentBuilder<VTYPE_IN,VTYPE_OUT>(kernelName,
-                                                                     usedTileSizes[i]));
-      }
-      return builders;
-    }
-
     template <class VTYPE, class RETTYPE>
     kernelBuilder makeLinalgBuilder(const std::string &kernelName) {
       return kernelBuilder::fromFile(env::OCCA_DIR + "include/occa/array/kernels/linalg.okl",
@@ -30,6 +19,7 @@ namespace occa {
                                      "  VTYPE: '" + primitiveinfo<VTYPE>::name + "',"
                                      "  VTYPE2: '" + primitiveinfo<VTYPE>::name + "',"
                                      "  RETTYPE: '" + primitiveinfo<RETTYPE>::name + "',"
+                                     "  ROOTTYPE: '" + primitiveinfo<typename rootType<RETTYPE>::type>::name + "',"
                                      "  CPU_DOT_OUTER: 1024,"
                                      "  GPU_DOT_OUTER: 1024,"
                                      "  GPU_DOT_INNER: 128,"
@@ -44,6 +34,7 @@ namespace occa {
                                      "  VTYPE: '"   + primitiveinfo<VTYPE1>::name  + "',"
                                      "  VTYPE2: '"  + primitiveinfo<VTYPE2>::name  + "',"
                                      "  RETTYPE: '" + primitiveinfo<RETTYPE>::name + "',"
+                                     "  ROOTTYPE: '" + primitiveinfo<typename rootType<RETTYPE>::type>::name + "',"
                                      "  CPU_DOT_OUTER: 1024,"
                                      "  GPU_DOT_OUTER: 1024,"
                                      "  GPU_DOT_INNER: 128,"
@@ -55,356 +46,713 @@ namespace occa {
     void operator_eq(occa::memory vec,
                      const VTYPE_OUT value,
                      const int tileSize) {
-      static kernelBuilderVector builders =
-        makeAssignmentBuilders<VTYPE_OUT,VTYPE_OUT>("eq_const");
-
-      const int entries = vec.size() / sizeof(VTYPE_OUT);
-      getTiledKernel(builders,
-                     vec.getDevice(),
-                     tileSize)(entries, value, vec);
+      static kernelBuilder builder =
+        makeAssignmentBuilder<VTYPE_OUT,VTYPE_OUT>("eq_const");
+
+      const dim_t entries = vec.size() / sizeof(VTYPE_OUT);
+      runTiledKernel(builder,
+                     tileSize,
+                     entries,
+                     value, 0,
+                     vec, sizeof(VTYPE_OUT));
     }
 
     template <class VTYPE_OUT>
     void operator_plus_eq(occa::memory vec,
                           const VTYPE_OUT value,
                           const int tileSize) {
-      static kernelBuilderVector builders =
-        makeAssignmentBuilders<VTYPE_OUT,VTYPE_OUT>("plus_eq_const");
-
-      const int entries = vec.size() / sizeof(VTYPE_OUT);
-      getTiledKernel(builders,
-                     vec.getDevice(),
-                     tileSize)(entries, value, vec);
+      static kernelBuilder builder =
+        makeAssignmentBuilder<VTYPE_OUT,VTYPE_OUT>("plus_eq_const");
+
+      const dim_t entries = vec.size() / sizeof(VTYPE_OUT);
+      runTiledKernel(builder,
+                     tileSize,
+                     entries,
+                     value, 0,
+                     vec, sizeof(VTYPE_OUT));
     }
 
     template <class VTYPE_IN, class VTYPE_OUT>
     void operator_plus_eq(occa::memory in,
                           occa::memory out,
                           const int tileSize) {
-      static kernelBuilderVector builders =
-        makeAssignmentBuilders<VTYPE_IN,VTYPE_OUT>("plus_eq");
-
-      const int entries = in.size() / sizeof(VTYPE_OUT);
-      getTiledKernel(builders,
-                     in.getDevice(),
-                     tileSize)(entries, in, out);
+      static kernelBuilder builder =
+        makeAssignmentBuilder<VTYPE_IN,VTYPE_OUT>("plus_eq");
+
+      const dim_t entries = out.size() / sizeof(VTYPE_OUT);
+      runTiledKernel(builder,
+                     tileSize,
+                     entries,
+                     in, sizeof(VTYPE_IN),
+                     out, sizeof(VTYPE_OUT));
     }
 
     template <class VTYPE_OUT>
     void operator_sub_eq(occa::memory vec,
                          const VTYPE_OUT value,
                          const int tileSize) {
-      static kernelBuilderVector builders =
-        makeAssignmentBuilders<VTYPE_OUT,VTYPE_OUT>("sub_eq_const");
-
-      const int entries = vec.size() / sizeof(VTYPE_OUT);
-      getTiledKernel(builders,
-                     vec.getDevice(),
-                     tileSize)(entries, value, vec);
+      static kernelBuilder builder =
+        makeAssignmentBuilder<VTYPE_OUT,VTYPE_OUT>("sub_eq_const");
+
+      const dim_t entries = vec.size() / sizeof(VTYPE_OUT);
+      runTiledKernel(builder,
+                     tileSize,
+                     entries,
+                     value, 0,
+                     vec, sizeof(VTYPE_OUT));
     }
 
     template <class VTYPE_IN, class VTYPE_OUT>
     void operator_sub_eq(occa::memory in,
                          occa::memory out,
                          const int tileSize) {
-      static kernelBuilderVector builders =
-        makeAssignmentBuilders<VTYPE_IN,VTYPE_OUT>("sub_eq");
-
-      const int entries = in.size() / sizeof(VTYPE_OUT);
-      getTiledKernel(builders,
-                     in.getDevice(),
-                     tileSize)(entries, in, out);
+      static kernelBuilder builder =
+        makeAssignmentBuilder<VTYPE_IN,VTYPE_OUT>("sub_eq");
+
+      const dim_t entries = out.size() / sizeof(VTYPE_OUT);
+      runTiledKernel(builder,
+                     tileSize,
+                     entries,
+                     in, sizeof(VTYPE_IN),
+                     out, sizeof(VTYPE_OUT));
     }
 
     template <class VTYPE_OUT>
     void operator_mult_eq(occa::memory vec,
                           const VTYPE_OUT value,
                           const int tileSize) {
-      static kernelBuilderVector builders =
-        makeAssignmentBuilders<VTYPE_OUT,VTYPE_OUT>("mult_eq_const");
-
-      const int entries = vec.size() / sizeof(VTYPE_OUT);
-      getTiledKernel(builders,
-                     vec.getDevice(),
-                     tileSize)(entries, value, vec);
+      static kernelBuilder builder =
+        makeAssignmentBuilder<VTYPE_OUT,VTYPE_OUT>("mult_eq_const");
+
+      const dim_t entries = vec.size() / sizeof(VTYPE_OUT);
+      runTiledKernel(builder,
+                     tileSize,
+                     entries,
+                     value, 0,
+                     vec, sizeof(VTYPE_OUT));
     }
 
     template <class VTYPE_IN, class VTYPE_OUT>
     void operator_mult_eq(occa::memory in,
                           occa::memory out,
                           const int tileSize) {
-      static kernelBuilderVector builders =
-        makeAssignmentBuilders<VTYPE_IN,VTYPE_OUT>("mult_eq");
-
-      const int entries = in.size() / sizeof(VTYPE_OUT);
-      getTiledKernel(builders,
-                     in.getDevice(),
-                     tileSize)(entries, in, out);
+      static kernelBuilder builder =
+        makeAssignmentBuilder<VTYPE_IN,VTYPE_OUT>("mult_eq");
+
+      const dim_t entries = out.size() / sizeof(VTYPE_OUT);
+      runTiledKernel(builder,
+                     tileSize,
+                     entries,
+                     in, sizeof(VTYPE_IN),
+                     out, sizeof(VTYPE_OUT));
     }
 
     template <class VTYPE_OUT>
     void operator_div_eq(occa::memory vec,
                          const VTYPE_OUT value,
                          const int tileSize) {
-      static kernelBuilderVector builders =
-        makeAssignmentBuilders<VTYPE_OUT,VTYPE_OUT>("div_eq_const");
-
-      const int entries = vec.size() / sizeof(VTYPE_OUT);
-      getTiledKernel(builders,
-                     vec.getDevice(),
-                     tileSize)(entries, value, vec);
+      static kernelBuilder builder =
+        makeAssignmentBuilder<VTYPE_OUT,VTYPE_OUT>("div_eq_const");
+
+      const dim_t entries = vec.size() / sizeof(VTYPE_OUT);
+      runTiledKernel(builder,
+                     tileSize,
+                     entries,
+                     value, 0,
+                     vec, sizeof(VTYPE_OUT));
     }
 
     template <class VTYPE_IN, class VTYPE_OUT>
     void operator_div_eq(occa::memory in,
                          occa::memory out,
                          const int tileSize) {
-      static kernelBuilderVector builders =
-        makeAssignmentBuilders<VTYPE_IN,VTYPE_OUT>("div_eq");
-
-      const int entries = in.size() / sizeof(VTYPE_OUT);
-      getTiledKernel(builders,
-                     in.getDevice(),
-                     tileSize)(entries, in, out);
+      static kernelBuilder builder =
+        makeAssignmentBuilder<VTYPE_IN,VTYPE_OUT>("div_eq");
+
+      const dim_t entries = out.size() / sizeof(VTYPE_OUT);
+      runTiledKernel(builder,
+                     tileSize,
+                     entries,
+                     in, sizeof(VTYPE_IN),
+                     out, sizeof(VTYPE_OUT));
     }
     //==================================
 
     //---[ Linear Algebra ]-------------
     template <class TM>
     TM *hostReductionBuffer(const int size) {
-      return new TM[size];
+      static std::vector<TM> buffer;
+      if ((int) buffer.size() < size) {
+        buffer.resize(size);
+      }
+      return &(buffer[0]);
     }
 
     template <class TM>
     occa::memory deviceReductionBuffer(occa::device device,
                                        const int size) {
-      memory &mapBuffer = deviceBufferMap()[hash(device)];
-      const size_t bytes = size * sizeof(TM);
-      // Not initialized or too small
-      if (!mapBuffer.isInitialized() ||
-          (mapBuffer.size() < bytes)) {
-        mapBuffer = device.malloc(bytes);
-        return mapBuffer;
+      return device.scratch(size * sizeof(TM));
+    }
+
+    template <class RETTYPE>
+    RETTYPE* reduce(occa::device dev,
+                    occa::kernelBuilder &builder,
+                    launchBenchmark &launch,
+                    const dim_t entries,
+                    int &bufferSize,
+                    const int outputsPerBlock) {
+      occa::scratchScope scope(dev);
+
+      // Partial results are recomputed after tuning, no need for scratch copies
+      memory deviceBuffer = deviceReductionBuffer<RETTYPE>(
+        dev, maxReductionBufferSize * outputsPerBlock
+      );
+      launch.args.push_back(deviceBuffer);
+
+      occa::kernel kernel = builder.autotune(dev,
+                                             reductionSpace(dev),
+                                             launch,
+                                             entries);
+      bufferSize = reductionBufferSize(kernel);
+
+      launch.run(kernel);
+      dev.finish();
+
+      RETTYPE *hostBuffer = hostReductionBuffer<RETTYPE>(bufferSize * outputsPerBlock);
+      deviceBuffer.copyTo(hostBuffer,
+                          bufferSize * outputsPerBlock * sizeof(RETTYPE));
+      return hostBuffer;
+    }
+
+    template <class RETTYPE>
+    occa::kernel getFinalReductionKernel(occa::device dev,
+                                         const int op,
+                                         const bool useExponent) {
+      static std::map<int, kernelBuilder> builders;
+
+      kernelBuilder &builder = builders[(2 * op) + useExponent];
+      if (!builder.isInitialized()) {
+        builder = kernelBuilder::fromFile(env::OCCA_DIR + "include/occa/array/kernels/linalg.okl",
+                                          "reduceFinal",
+                                          "defines: {"
+                                          "  RETTYPE: '" + primitiveinfo<RETTYPE>::name + "',"
+                                          "  ROOTTYPE: '" + primitiveinfo<typename rootType<RETTYPE>::type>::name + "',"
+                                          "  GPU_DOT_OUTER: 1,"
+                                          "  GPU_DOT_INNER: 256,"
+                                          "  FINAL_OP: " + toString(op) + ","
+                                          "  FINAL_EXPONENT: " + toString((int) useExponent) + ","
+                                          "}");
       }
-      if (mapBuffer.size() == bytes) {
-        return mapBuffer;
+      return builder.build(dev);
+    }
+
+    template <class RETTYPE>
+    asyncReduction<RETTYPE> reduceAsync(occa::device dev,
+                                        occa::kernelBuilder &builder,
+                                        launchBenchmark &launch,
+                                        const dim_t entries,
+                                        const int op,
+                                        occa::memory result,
+                                        const bool useExponent,
+                                        const double exponent) {
+      asyncReduction<RETTYPE> ret;
+      ret.device = dev;
+
+      if (result.isInitialized()) {
+        OCCA_ERROR("Reduction result must be in the same device",
+                   result.getDevice() == dev);
+        OCCA_ERROR("Reduction result must fit one entry",
+                   result.size() >= sizeof(RETTYPE));
+        ret.result = result;
+      } else {
+        ret.result = dev.malloc(sizeof(RETTYPE));
       }
-      return mapBuffer.slice(0, bytes);
+
+      // Partial results are recomputed after tuning, no need for scratch copies
+      occa::memory partials = streamReductionBuffer(
+        dev, maxReductionBufferSize * sizeof(RETTYPE)
+      );
+      launch.args.push_back(partials);
+
+      occa::kernel kernel = builder.autotune(dev,
+                                             reductionSpace(dev),
+                                             launch,
+                                             entries);
+      const int bufferSize = reductionBufferSize(kernel);
+      launch.run(kernel);
+
+      getFinalReductionKernel<RETTYPE>(dev, op, useExponent)(
+        bufferSize,
+        partials,
+        (typename rootType<RETTYPE>::type) exponent,
+        ret.result
+      );
+      ret.tag = dev.tagStream();
+      return ret;
     }
 
     template <class VTYPE, class RETTYPE>
-    RETTYPE* reduce(occa::memory vec,
-                    occa::kernelBuilder &builder,
-                    const int bufferSize) {
-
-      device dev = vec.getDevice();
-      RETTYPE *hostBuffer = hostReductionBuffer<RETTYPE>(bufferSize);
-      memory deviceBuffer = deviceReductionBuffer<RETTYPE>(dev, bufferSize);
-      const int entries = vec.size() / sizeof(VTYPE);
-      builder.build(dev)(entries,
-                         vec,
-                         deviceBuffer);
-      deviceBuffer.copyTo(hostBuffer);
-      return hostBuffer;
+    asyncReduction<RETTYPE> reduceAsync(occa::memory vec,
+                                        occa::kernelBuilder &builder,
+                                        const int op,
+                                        occa::memory result,
+                                        const bool useExponent = false,
+                                        const double exponent = 1.0) {
+      const dim_t entries = vec.size() / sizeof(VTYPE);
+
+      launchBenchmark launch;
+      launch.args.push_back(entries);
+      launch.args.push_back(vec);
+
+      return reduceAsync<RETTYPE>(vec.getDevice(),
+                                  builder,
+                                  launch,
+                                  entries,
+                                  op,
+                                  result,
+                                  useExponent,
+                                  exponent);
+    }
+
+    template <class VTYPE1, class VTYPE2, class RETTYPE>
+    asyncReduction<RETTYPE> reduceAsync(occa::memory vec1,
+                                        occa::memory vec2,
+                                        occa::kernelBuilder &builder,
+                                        const int op,
+                                        occa::memory result,
+                                        const bool useExponent = false,
+                                        const double exponent = 1.0) {
+      OCCA_ERROR("Vectors must be in the same device",
+                 vec1.getDevice() == vec2.getDevice());
+
+      const dim_t entries = vec1.size() / sizeof(VTYPE1);
+
+      launchBenchmark launch;
+      launch.args.push_back(entries);
+      launch.args.push_back(vec1);
+      launch.args.push_back(vec2);
+
+      return reduceAsync<RETTYPE>(vec1.getDevice(),
+                                  builder,
+                                  launch,
+                                  entries,
+                                  op,
+                                  result,
+                                  useExponent,
+                                  exponent);
     }
 
     template <class VTYPE, class RETTYPE>
-    RETTYPE l1Norm(occa::memory vec) {
+    asyncReduction<RETTYPE> l1NormAsync(occa::memory vec,
+                                        occa::memory result) {
       static kernelBuilder builder =
         makeLinalgBuilder<VTYPE, RETTYPE>("l1Norm");
 
-      RETTYPE *partialReduction = reduce<VTYPE,RETTYPE>(vec, builder, 1024);
-      RETTYPE ret = 0;
-      for (int i = 0; i < 1024; ++i) {
-        ret += partialReduction[i];
-      }
-      delete [] partialReduction;
-      return ret;
+      return reduceAsync<VTYPE, RETTYPE>(vec, builder, finalOp::sum, result);
     }
 
     template <class VTYPE, class RETTYPE>
-    RETTYPE l2Norm(occa::memory vec) {
+    asyncReduction<RETTYPE> l2NormAsync(occa::memory vec,
+                                        occa::memory result) {
       static kernelBuilder builder =
         makeLinalgBuilder<VTYPE, RETTYPE>("l2Norm");
 
-      RETTYPE *partialReduction = reduce<VTYPE,RETTYPE>(vec, builder, 1024);
-      RETTYPE ret = 0;
-      for (int i = 0; i < 1024; ++i) {
-        ret += partialReduction[i];
-      }
-      delete [] partialReduction;
-      return sqrt(ret);
+      return reduceAsync<VTYPE, RETTYPE>(vec, builder, finalOp::sum, result, true, 0.5);
     }
 
     template <class VTYPE, class RETTYPE>
-    RETTYPE lpNorm(const float p,
-                   occa::memory vec) {
+    asyncReduction<RETTYPE> lpReduceAsync(const float p,
+                                          occa::memory vec,
+                                          occa::memory result,
+                                          const bool takeRoot) {
       static kernelBuilder builder =
         makeLinalgBuilder<VTYPE, RETTYPE>("lpNorm");
 
+      const dim_t entries = vec.size() / sizeof(VTYPE);
+
+      launchBenchmark launch;
+      launch.args.push_back(entries);
+      launch.args.push_back(p);
+      launch.args.push_back(vec);
+
+      return reduceAsync<RETTYPE>(vec.getDevice(),
+                                  builder,
+                                  launch,
+                                  entries,
+                                  finalOp::sum,
+                                  result,
+                                  takeRoot,
+                                  1.0 / (double) p);
+    }
 
-      device dev = vec.getDevice();
-      const int bufferSize = 1024;
-      RETTYPE *hostBuffer = hostReductionBuffer<RETTYPE>(bufferSize);
-      memory deviceBuffer = deviceReductionBuffer<RETTYPE>(dev, bufferSize);
-      const int entries = vec.size() / sizeof(VTYPE);
-      builder.build(dev)(entries,
-                         p,
-                         vec,
-                         deviceBuffer);
-      dev.finish();
-      deviceBuffer.copyTo(hostBuffer);
-      RETTYPE ret = 0;
-      for (int i = 0; i < 1024; ++i) {
-        ret += hostBuffer[i];
-      }
-      delete [] hostBuffer;
-      return pow(ret, 1.0/p);
+    template <class VTYPE, class RETTYPE>
+    asyncReduction<RETTYPE> lpNormAsync(const float p,
+                                        occa::memory vec,
+                                        occa::memory result) {
+      return lpReduceAsync<VTYPE, RETTYPE>(p, vec, result, true);
     }
 
     template <class VTYPE, class RETTYPE>
-    RETTYPE lInfNorm(occa::memory vec) {
+    asyncReduction<RETTYPE> lpNormPowerAsync(const float p,
+                                             occa::memory vec,
+                                             occa::memory result) {
+      return lpReduceAsync<VTYPE, RETTYPE>(p, vec, result, false);
+    }
+
+    template <class VTYPE, class RETTYPE>
+    asyncReduction<RETTYPE> lInfNormAsync(occa::memory vec,
+                                          occa::memory result) {
       static kernelBuilder builder =
         makeLinalgBuilder<VTYPE, RETTYPE>("lInfNorm");
 
-      RETTYPE *partialReduction = reduce<VTYPE,RETTYPE>(vec, builder, 1024);
-      RETTYPE ret = partialReduction[0];
-      for (int i = 1; i < 1024; ++i) {
-        const RETTYPE abs_i = partialReduction[i];
-        if (ret < abs_i) {
-          ret = abs_i;
-        }
-      }
-      delete [] partialReduction;
-      return ret;
+      return reduceAsync<VTYPE, RETTYPE>(vec, builder, finalOp::max, result);
     }
 
     template <class VTYPE, class RETTYPE>
-    RETTYPE max(occa::memory vec) {
+    asyncReduction<RETTYPE> maxAsync(occa::memory vec,
+                                     occa::memory result) {
       static kernelBuilder builder =
         makeLinalgBuilder<VTYPE, RETTYPE>("vecMax");
 
-      RETTYPE *partialReduction = reduce<VTYPE,RETTYPE>(vec, builder, 1024);
-      RETTYPE ret = partialReduction[0];
-      for (int i = 1; i < 1024; ++i) {
-        if (ret < partialReduction[i]) {
-          ret = partialReduction[i];
-        }
-      }
-      delete [] partialReduction;
-      return ret;
+      return reduceAsync<VTYPE, RETTYPE>(vec, builder, finalOp::max, result);
     }
 
     template <class VTYPE, class RETTYPE>
-    RETTYPE min(occa::memory vec) {
+    asyncReduction<RETTYPE> minAsync(occa::memory vec,
+                                     occa::memory result) {
       static kernelBuilder builder =
         makeLinalgBuilder<VTYPE, RETTYPE>("vecMin");
 
-      RETTYPE *partialReduction = reduce<VTYPE,RETTYPE>(vec, builder, 1024);
-      RETTYPE ret = partialReduction[0];
-      for (int i = 1; i < 1024; ++i) {
-        if (ret > partialReduction[i]) {
-          ret = partialReduction[i];
-        }
-      }
-      delete [] partialReduction;
-      return ret;
+      return reduceAsync<VTYPE, RETTYPE>(vec, builder, finalOp::min, result);
     }
 
     template <class VTYPE1, class VTYPE2, class RETTYPE>
-    RETTYPE dot(occa::memory vec1, occa::memory vec2) {
+    asyncReduction<RETTYPE> dotAsync(occa::memory vec1,
+                                     occa::memory vec2,
+                                     occa::memory result) {
       static kernelBuilder builder =
         makeLinalgBuilder<VTYPE1, VTYPE2, RETTYPE>("dot");
 
-      OCCA_ERROR("Vectors must be in the same device",
-                 vec1.getDevice() == vec2.getDevice());
-
-      device dev = vec1.getDevice();
-      const int bufferSize = 1024;
-      RETTYPE *hostBuffer = hostReductionBuffer<RETTYPE>(bufferSize);
-      memory deviceBuffer = deviceReductionBuffer<RETTYPE>(dev, bufferSize);
-      const int entries = vec1.size() / sizeof(VTYPE1);
-      builder.build(dev)(entries,
-                         vec1,
-                         vec2,
-                         deviceBuffer);
-      dev.finish();
-      deviceBuffer.copyTo(hostBuffer);
-      RETTYPE ret = 0;
-      for (int i = 0; i < 1024; ++i) {
-        ret += hostBuffer[i];
-      }
-      delete [] hostBuffer;
-      return ret;
+      return reduceAsync<VTYPE1, VTYPE2, RETTYPE>(vec1, vec2, builder, finalOp::sum, result);
     }
 
     template <class VTYPE1, class VTYPE2, class RETTYPE>
-    RETTYPE distance(occa::memory vec1, occa::memory vec2) {
+    asyncReduction<RETTYPE> distanceAsync(occa::memory vec1,
+                                          occa::memory vec2,
+                                          occa::memory result) {
       static kernelBuilder builder =
         makeLinalgBuilder<VTYPE1, VTYPE2, RETTYPE>("distance");
 
-      OCCA_ERROR("Vectors must be in the same device",
-                 vec1.getDevice() == vec2.getDevice());
-
-      device dev = vec1.getDevice();
-      const int bufferSize = 1024;
-      RETTYPE *hostBuffer = hostReductionBuffer<RETTYPE>(bufferSize);
-      memory deviceBuffer = deviceReductionBuffer<RETTYPE>(dev, bufferSize);
-      const int entries = vec1.size() / sizeof(VTYPE1);
-      builder.build(dev)(entries,
-                         vec1,
-                         vec2,
-                         deviceBuffer);
-      dev.finish();
-      deviceBuffer.copyTo(hostBuffer);
-      RETTYPE ret = 0;
-      for (int i = 0; i < 1024; ++i) {
-        ret += hostBuffer[i];
-      }
-      delete [] hostBuffer;
-      return sqrt(ret);
+      return reduceAsync<VTYPE1, VTYPE2, RETTYPE>(vec1, vec2, builder, finalOp::sum, result, true, 0.5);
     }
 
     template <class VTYPE, class RETTYPE>
-    RETTYPE sum(occa::memory vec) {
+    asyncReduction<RETTYPE> sumAsync(occa::memory vec,
+                                     occa::memory result) {
       static kernelBuilder builder =
         makeLinalgBuilder<VTYPE, RETTYPE>("sum");
 
-      RETTYPE *partialReduction = reduce<VTYPE,RETTYPE>(vec, builder, 1024);
-      RETTYPE ret = 0;
-      for (int i = 0; i < 1024; ++i) {
-        ret += partialReduction[i];
+      return reduceAsync<VTYPE, RETTYPE>(vec, builder, finalOp::sum, result);
+    }
+
+    // Blocking reductions reuse the stream's result buffer
+    template <class RETTYPE>
+    occa::memory blockingResult(occa::memory vec) {
+      return streamResultBuffer(vec.getDevice(), sizeof(RETTYPE));
+    }
+
+    template <class VTYPE, class RETTYPE>
+    RETTYPE l1Norm(occa::memory vec) {
+      return l1NormAsync<VTYPE, RETTYPE>(vec, blockingResult<RETTYPE>(vec)).value();
+    }
+
+    template <class VTYPE, class RETTYPE>
+    RETTYPE l2Norm(occa::memory vec) {
+      return l2NormAsync<VTYPE, RETTYPE>(vec, blockingResult<RETTYPE>(vec)).value();
+    }
+
+    template <class VTYPE, class RETTYPE>
+    RETTYPE lpNorm(const float p,
+                   occa::memory vec) {
+      return lpNormAsync<VTYPE, RETTYPE>(p, vec, blockingResult<RETTYPE>(vec)).value();
+    }
+
+    template <class VTYPE, class RETTYPE>
+    RETTYPE lpNormPower(const float p,
+                        occa::memory vec) {
+      return lpNormPowerAsync<VTYPE, RETTYPE>(p, vec, blockingResult<RETTYPE>(vec)).value();
+    }
+
+    template <class VTYPE, class RETTYPE>
+    RETTYPE lInfNorm(occa::memory vec) {
+      return lInfNormAsync<VTYPE, RETTYPE>(vec, blockingResult<RETTYPE>(vec)).value();
+    }
+
+    template <class VTYPE, class RETTYPE>
+    RETTYPE max(occa::memory vec) {
+      return maxAsync<VTYPE, RETTYPE>(vec, blockingResult<RETTYPE>(vec)).value();
+    }
+
+    template <class VTYPE, class RETTYPE>
+    RETTYPE min(occa::memory vec) {
+      return minAsync<VTYPE, RETTYPE>(vec, blockingResult<RETTYPE>(vec)).value();
+    }
+
+    template <class VTYPE1, class VTYPE2, class RETTYPE>
+    RETTYPE dot(occa::memory vec1, occa::memory vec2) {
+      return dotAsync<VTYPE1, VTYPE2, RETTYPE>(vec1, vec2, blockingResult<RETTYPE>(vec1)).value();
+    }
+
+    template <class VTYPE, class RETTYPE>
+    std::vector<RETTYPE> reduce(occa::memory vec,
+                                const reductionTuple &terms) {
+      static std::map<std::string, kernelBuilder> builders;
+
+      const int count = terms.size();
+      std::vector<RETTYPE> ret(count, 0);
+      const dim_t entries = vec.size() / sizeof(VTYPE);
+      if (!count || !entries) {
+        return ret;
+      }
+
+      // Each tuple of terms is its own kernel
+      kernelBuilder &builder = builders[terms.toString()];
+      if (!builder.isInitialized()) {
+        builder = makeReductionTupleBuilder(
+          terms,
+          makeLinalgBuilder<VTYPE, RETTYPE>("stats").defaultProperties()
+        );
+      }
+
+      launchBenchmark launch;
+      launch.args.push_back(entries);
+      launch.args.push_back(vec);
+
+      int bufferSize;
+      const RETTYPE *partial = reduce<RETTYPE>(vec.getDevice(),
+                                               builder,
+                                               launch,
+                                               entries,
+                                               bufferSize,
+                                               count);
+
+      for (int i = 0; i < count; ++i) {
+        ret[i] = partial[i];
+      }
+      for (int b = 1; b < bufferSize; ++b) {
+        partial += count;
+        for (int i = 0; i < count; ++i) {
+          switch (terms.ops[i]) {
+          case reductionTuple::sum_:
+            ret[i] += partial[i];
+            break;
+          case reductionTuple::min_:
+            if (partial[i] < ret[i]) {
+              ret[i] = partial[i];
+            }
+            break;
+          case reductionTuple::max_:
+            if (ret[i] < partial[i]) {
+              ret[i] = partial[i];
+            }
+            break;
+          }
+        }
       }
-      delete [] partialReduction;
       return ret;
     }
 
+    template <class VTYPE, class RETTYPE>
+    vectorStats<RETTYPE> stats(occa::memory vec,
+                               const int flags) {
+      vectorStats<RETTYPE> ret(flags & stat::all);
+
+      reductionTuple terms;
+      int indices[6];
+      const std::string absValue = "ABS_FUNC(v)";
+      indices[0] = ret.has(stat::min)      ? terms.min("v")                           : -1;
+      indices[1] = ret.has(stat::max)      ? terms.max("v")                           : -1;
+      indices[2] = ret.has(stat::sum)      ? terms.sum("v")                           : -1;
+      indices[3] = ret.has(stat::l1Norm)   ? terms.sum(absValue)                      : -1;
+      indices[4] = ret.has(stat::l2Norm)   ? terms.sum("((RETTYPE) v) * ((RETTYPE) v)") : -1;
+      indices[5] = ret.has(stat::lInfNorm) ? terms.max(absValue)                      : -1;
+      if (!terms.size()) {
+        return ret;
+      }
+
+      const std::vector<RETTYPE> values = reduce<VTYPE, RETTYPE>(vec, terms);
+      if (indices[0] >= 0) { ret.min      = values[indices[0]]; }
+      if (indices[1] >= 0) { ret.max      = values[indices[1]]; }
+      if (indices[2] >= 0) { ret.sum      = values[indices[2]]; }
+      if (indices[3] >= 0) { ret.l1Norm   = values[indices[3]]; }
+      if (indices[4] >= 0) { ret.l2Norm   = sqrt(values[indices[4]]); }
+      if (indices[5] >= 0) { ret.lInfNorm = values[indices[5]]; }
+      return ret;
+    }
+
+    template <class VTYPE1, class VTYPE2, class RETTYPE>
+    RETTYPE distance(occa::memory vec1, occa::memory vec2) {
+      return distanceAsync<VTYPE1, VTYPE2, RETTYPE>(vec1, vec2, blockingResult<RETTYPE>(vec1)).value();
+    }
+
+    template <class VTYPE, class RETTYPE>
+    RETTYPE sum(occa::memory vec) {
+      return sumAsync<VTYPE, RETTYPE>(vec, blockingResult<RETTYPE>(vec)).value();
+    }
+
     template <class TYPE_A, class VTYPE_X, class VTYPE_Y>
     void axpy(const TYPE_A &alpha,
               occa::memory x,
               occa::memory y,
               const int tileSize) {
 
-      static kernelBuilderVector builders;
-      if (!builders.size()) {
-        for (int i = 0; i < usedTileSizeCount; ++i) {
-          kernelBuilder kerb =
-            customLinearMethod("axpy",
-                               "v0[i] += c0 * v1[i];",
-                               "defines: {"
-                               "  CTYPE0: '" + primitiveinfo<TYPE_A>::name + "',"
-                               "  VTYPE0: '" + primitiveinfo<VTYPE_Y>::name + "',"
-                               "  VTYPE1: '" + primitiveinfo<VTYPE_X>::name + "',"
-                               "  TILESIZE: '" + toString(usedTileSizes[i]) + "',"
-                               "}");
-          builders.push_back(kerb);
-        }
+      static kernelBuilder builder =
+        customLinearMethod("axpy",
+                           "v0[i] += c0 * v1[i];",
+                           "defines: {"
+                           "  CTYPE0: '" + primitiveinfo<TYPE_A>::name + "',"
+                           "  VTYPE0: '" + primitiveinfo<VTYPE_Y>::name + "',"
+                           "  VTYPE1: '" + primitiveinfo<VTYPE_X>::name + "',"
+                           "  TILESIZE: 128,"
+                           "}");
+
+      const dim_t entries = y.size() / sizeof(VTYPE_Y);
+
+      launchBenchmark launch;
+      launch.args.push_back(entries);
+      launch.args.push_back(alpha);
+      launch.setOutput(y, entries, sizeof(VTYPE_Y));
+      launch.args.push_back(x);
+
+      occa::kernel kernel = getTiledKernel(builder,
+                                           y.getDevice(),
+                                           tileSize,
+                                           launch,
+                                           entries);
+
+      dim_t chunkEntries = maxLaunchEntries(kernel);
+      if (!chunkEntries || (chunkEntries > entries)) {
+        chunkEntries = entries;
+      }
+      for (dim_t offset = 0; offset < entries; offset += chunkEntries) {
+        const dim_t count = std::min(chunkEntries, entries - offset);
+        kernel(count,
+               alpha,
+               sliceEntries(y, sizeof(VTYPE_Y), offset, count),
+               sliceEntries(x, sizeof(VTYPE_X), offset, count));
+      }
+    }
+
+    inline void assertBatchBuffer(occa::device dev,
+                                  const int batches,
+                                  occa::memory buffer,
+                                  const int entryBytes,
+                                  const std::string &name) {
+      OCCA_ERROR("Batched " << name << " must be in the same device",
+                 buffer.getDevice() == dev);
+      OCCA_ERROR("Batched " << name << " must have at least " << batches << " entries",
+                 buffer.size() >= (udim_t) (batches * entryBytes));
+    }
+
+    template <class RETTYPE>
+    occa::memory batchedResult(occa::device dev,
+                               const int batches,
+                               occa::memory result) {
+      if (!result.isInitialized()) {
+        return dev.malloc(batches * sizeof(RETTYPE));
       }
+      assertBatchBuffer(dev, batches, result, sizeof(RETTYPE), "result");
+      return result;
+    }
+
+    template <class VTYPE1, class VTYPE2, class RETTYPE>
+    occa::memory batchedDot(const int batches,
+                            occa::memory lengths,
+                            occa::memory vec1,
+                            occa::memory offsets1,
+                            occa::memory vec2,
+                            occa::memory offsets2,
+                            occa::memory result) {
+      static kernelBuilder builder =
+        makeLinalgBuilder<VTYPE1, VTYPE2, RETTYPE>("batchedDot");
+
+      occa::device dev = vec1.getDevice();
+      result = batchedResult<RETTYPE>(dev, batches, result);
+      if (batches <= 0) {
+        return result;
+      }
+      assertBatchBuffer(dev, batches, lengths, sizeof(dim_t), "lengths");
+      assertBatchBuffer(dev, batches, offsets1, sizeof(dim_t), "offsets");
+      assertBatchBuffer(dev, batches, offsets2, sizeof(dim_t), "offsets");
+      OCCA_ERROR("Vectors must be in the same device",
+                 vec2.getDevice() == dev);
+
+      builder.build(dev)(batches,
+                         lengths,
+                         vec1, offsets1,
+                         vec2, offsets2,
+                         result);
+      return result;
+    }
+
+    template <class VTYPE, class RETTYPE>
+    occa::memory batchedNorm(const int batches,
+                             occa::memory lengths,
+                             occa::memory vec,
+                             occa::memory offsets,
+                             occa::memory result) {
+      static kernelBuilder builder =
+        makeLinalgBuilder<VTYPE, RETTYPE>("batchedNorm");
+
+      occa::device dev = vec.getDevice();
+      result = batchedResult<RETTYPE>(dev, batches, result);
+      if (batches <= 0) {
+        return result;
+      }
+      assertBatchBuffer(dev, batches, lengths, sizeof(dim_t), "lengths");
+      assertBatchBuffer(dev, batches, offsets, sizeof(dim_t), "offsets");
+
+      builder.build(dev)(batches,
+                         lengths,
+                         vec, offsets,
+                         result);
+      return result;
+    }
+
+    template <class TYPE_A, class VTYPE_X, class VTYPE_Y>
+    void batchedAxpy(const int batches,
+                     occa::memory lengths,
+                     occa::memory alpha,
+                     occa::memory x,
+                     occa::memory xOffsets,
+                     occa::memory y,
+                     occa::memory yOffsets) {
+      static kernelBuilder builder =
+        kernelBuilder::fromFile(env::OCCA_DIR + "include/occa/array/kernels/linalg.okl",
+                                "batchedAxpy",
+                                "defines: {"
+                                "  TYPE_A: '"  + primitiveinfo<TYPE_A>::name  + "',"
+                                "  VTYPE_X: '" + primitiveinfo<VTYPE_X>::name + "',"
+                                "  VTYPE_Y: '" + primitiveinfo<VTYPE_Y>::name + "',"
+                                "  GPU_DOT_INNER: 128,"
+                                "}");
+      if (batches <= 0) {
+        return;
+      }
+
+      occa::device dev = y.getDevice();
+      assertBatchBuffer(dev, batches, lengths, sizeof(dim_t), "lengths");
+      assertBatchBuffer(dev, batches, alpha, sizeof(TYPE_A), "alpha");
+      assertBatchBuffer(dev, batches, xOffsets, sizeof(dim_t), "offsets");
+      assertBatchBuffer(dev, batches, yOffsets, sizeof(dim_t), "offsets");
+      OCCA_ERROR("Vectors must be in the same device",
+                 x.getDevice() == dev);
 
-      const int entries = y.size() / sizeof(VTYPE_Y);
-      getTiledKernel(builders,
-                     y.getDevice(),
-                     tileSize)(entries, alpha, y, x);
+      builder.build(dev)(batches,
+                         lengths,
+                         alpha,
+                         x, xOffsets,
+                         y, yOffsets);
     }
     //==================================
   }
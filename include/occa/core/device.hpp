@@ -6,6 +6,8 @@
 
 #include <occa/core/kernel.hpp>
 #include <occa/core/memory.hpp>
+#include <occa/core/memoryPool.hpp>
+#include <occa/core/scratch.hpp>
 #include <occa/core/stream.hpp>
 #include <occa/defines.hpp>
 #include <occa/dtype.hpp>
@@ -36,13 +38,15 @@ namespace occa {
     gc::ring_t<modeStream_t> streamRing;
     gc::ring_t<modeStreamTag_t> streamTagRing;
 
-    ptrRangeMap uvaMap;
+    uvaRegistry uvaMap;
     memoryVector uvaStaleMemory;
 
     stream currentStream;
     std::vector<modeStream_t*> streams;
 
     udim_t bytesAllocated;
+    memoryPool_t memoryPool;
+    scratchArena_t scratchArena;
 
     cachedKernelMap cachedKernels;
 
@@ -191,6 +195,10 @@ namespace occa {
 
     udim_t memorySize() const;
     udim_t memoryAllocated() const;
+    udim_t memoryCached() const;
+
+    const memoryPoolStats& poolStats() const;
+    void trimMemoryPool(const udim_t bytes = 0);
 
     void finish();
 
@@ -214,6 +222,15 @@ namespace occa {
                          occa::properties &kernelProps,
                          hash_t &kernelHash) const;
 
+    void setupKernelInfo(const occa::properties &props,
+                         const hash_t &sourceHash,
+                         occa::properties &kernelProps,
+                         hash_t &kernelHash,
+                         hash_t &definesFreeHash) const;
+
+    hash_t applyDefinesHash(const hash_t &definesFreeHash,
+                            const occa::properties &kernelProps) const;
+
     hash_t applyDependencyHash(const hash_t &kernelHash) const;
 
     occa::kernel buildKernel(const std::string &filename,
@@ -287,6 +304,12 @@ namespace occa {
     template <class TM = void>
     TM* umalloc(const dim_t entries,
                 const occa::properties &props);
+
+    // Must be called inside an occa::scratchScope
+    occa::memory scratch(const dim_t entries,
+                         const dtype_t &dtype = dtype::byte);
+
+    udim_t scratchCapacity() const;
     //  |===============================
   };
 
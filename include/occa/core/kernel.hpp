@@ -41,6 +41,14 @@ namespace occa {
     occa::properties properties;
     hash_t hash;
 
+    // Source passed to device::buildKernel, used to build variants
+    //   with specialized argument values
+    std::string originFilename;
+    std::map<std::string, modeKernel_t*> specializedKernels;
+    // Indices of the arguments listed in the specialize property,
+    //   launches skip specialization when it's empty
+    std::vector<int> specializedArgs;
+
     // Requirements to launch kernel
     dim outerDims, innerDims;
     std::vector<kernelArgData> arguments;
@@ -70,6 +78,11 @@ namespace occa {
 
     void setupRun();
 
+    // Resolves the specialize property once the kernel is built
+    void setupSpecialization();
+    modeKernel_t* getSpecializedKernel();
+    modeKernel_t* buildSpecializedKernel(const json &values);
+
     //---[ Virtual Methods ]------------
     virtual ~modeKernel_t() = 0;
 
@@ -152,6 +165,8 @@ namespace occa {
   //   include_paths : Array
   hash_t kernelHeaderHash(const occa::properties &props);
 
+  hash_t kernelHeaderHashWithoutDefines(const occa::properties &props);
+
   std::string assembleKernelHeader(const occa::properties &props);
   //====================================
 }
@@ -5,6 +5,19 @@
 #include <occa/core/scope.hpp>
 
 namespace occa {
+  //---[ kernelBenchmark ]--------------
+  // Launches a kernel variant with representative arguments
+  //   while kernelBuilder::autotune times it
+  class kernelBenchmark {
+  public:
+    virtual ~kernelBenchmark();
+
+    virtual void run(occa::kernel kernel) = 0;
+  };
+  //====================================
+
+
+  //---[ kernelBuilder ]----------------
   class kernelBuilder {
   protected:
     std::string source_;
@@ -12,9 +25,14 @@ namespace occa {
     occa::properties defaultProps;
 
     hashedKernelMap kernelMap;
+    // Keyed by device and problem size bucket
+    hashedKernelMap autotunedKernelMap;
 
     bool buildingFromFile;
 
+    // Source, function and default properties hash used by autotune
+    hash_t tuningSourceHash;
+
   public:
     kernelBuilder();
 
@@ -47,9 +65,23 @@ namespace occa {
 
     occa::kernel operator [] (occa::device device);
 
+    // Builds a variant for each combination of defines in paramSpace,
+    //   for example { TILESIZE: [64, 128, 256] }, and returns the fastest one.
+    // The winner is stored in the cache per device, kernel and problem size
+    //   bucket (powers of 16) so future processes skip the tuning runs
+    // Tuned kernels are kept per device and bucket, a builder is expected
+    //   to be tuned over a single paramSpace
+    occa::kernel autotune(occa::device device,
+                          const occa::json &paramSpace,
+                          kernelBenchmark &benchmark,
+                          const udim_t problemSize = 0);
+
     void run(occa::scope &scope);
 
     void free();
+
+  private:
+    const hash_t& getTuningSourceHash();
   };
   //====================================
 
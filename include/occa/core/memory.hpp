@@ -1,16 +1,20 @@
 #ifndef OCCA_CORE_MEMORY_HEADER
 #define OCCA_CORE_MEMORY_HEADER
 
+#include <deque>
 #include <iostream>
+#include <map>
 
 #include <occa/defines.hpp>
 #include <occa/dtype.hpp>
+#include <occa/core/stream.hpp>
 #include <occa/io/output.hpp>
 #include <occa/tools/gc.hpp>
 #include <occa/tools/properties.hpp>
+#include <occa/tools/uva.hpp>
 
 namespace occa {
-  class modeMemory_t; class memory;
+  class modeMemory_t; class memory; class memoryView;
   class modeDevice_t; class device;
   class kernelArg;
 
@@ -25,6 +29,26 @@ namespace occa {
     static const int isStale   = (1 << 2);
   }
 
+  //---[ copyOptions ]------------------
+  // Typed options for memory copies, avoids building occa::properties
+  //   in hot paths
+  //
+  // Properties form:
+  //   async : Boolean
+  class copyOptions {
+  public:
+    bool async;
+    // Uses the device's current stream if NULL
+    modeStream_t *stream;
+
+    copyOptions();
+    explicit copyOptions(const bool async_);
+    copyOptions(const bool async_,
+                const occa::stream &stream_);
+    explicit copyOptions(const occa::properties &props);
+  };
+  //====================================
+
   //---[ modeMemory_t ]---------------------
   class modeMemory_t : public gc::ringEntry_t {
   public:
@@ -42,6 +66,22 @@ namespace occa {
     udim_t size;
     bool isOrigin;
 
+    // Byte ranges written by kernels since the last sync to uvaPtr
+    byteRangeSet dirtyRanges;
+
+    // Offset memory reused by makeOffsetKernelArg() in modes that can't
+    //   offset backend handles directly
+    // It's owned by this memory and not tracked by the device
+    // At most maxOffsetMemory entries are kept, the oldest one is freed
+    //   when a new offset is needed
+    static const int maxOffsetMemory = 32;
+    std::map<udim_t, memory*> offsetMemory;
+    std::deque<udim_t> offsetMemoryOrder;
+
+    // Set when the backend allocation is owned by the device memory pool
+    udim_t poolSize;
+    hash_t poolBin;
+
     modeMemory_t(modeDevice_t *modeDevice_,
                  udim_t size_,
                  const occa::properties &properties_);
@@ -49,17 +89,27 @@ namespace occa {
     void dontUseRefs();
     void addMemoryRef(memory *mem);
     void removeMemoryRef(memory *mem);
+    void removeAllMemoryRefs();
+    void freeOffsetMemory();
     bool needsFree() const;
 
+    bool isPooled() const;
+
     bool isManaged() const;
     bool inDevice() const;
     bool isStale() const;
 
+    // Copies dirty ranges (or everything if untracked) back to uvaPtr
+    void syncDirtyToHost(const copyOptions &options = copyOptions());
+
     //---[ Virtual Methods ]------------
     virtual ~modeMemory_t() = 0;
 
     virtual kernelArg makeKernelArg() const = 0;
 
+    // Kernel argument starting [offset] bytes into the memory
+    virtual kernelArg makeOffsetKernelArg(const udim_t offset);
+
     virtual modeMemory_t* addOffset(const dim_t offset) = 0;
 
     virtual void* getPtr(const occa::properties &props);
@@ -67,18 +117,18 @@ namespace occa {
     virtual void copyTo(void *dest,
                         const udim_t bytes,
                         const udim_t offset = 0,
-                        const occa::properties &props = occa::properties()) const = 0;
+                        const copyOptions &options = copyOptions()) const = 0;
 
     virtual void copyFrom(const void *src,
                           const udim_t bytes,
                           const udim_t offset = 0,
-                          const occa::properties &props = occa::properties()) = 0;
+                          const copyOptions &options = copyOptions()) = 0;
 
     virtual void copyFrom(const modeMemory_t *src,
                           const udim_t bytes,
                           const udim_t destOffset = 0,
                           const udim_t srcOffset = 0,
-                          const occa::properties &props = occa::properties()) = 0;
+                          const copyOptions &options = copyOptions()) = 0;
 
     virtual void detach() = 0;
     //==================================
@@ -231,6 +281,41 @@ namespace occa {
     void copyTo(const memory dest,
                 const occa::properties &props) const;
 
+    // Fast path overloads without occa::properties
+    void copyFrom(const void *src,
+                  const dim_t bytes,
+                  const dim_t offset,
+                  const copyOptions &options);
+
+    void copyFrom(const memory src,
+                  const dim_t bytes,
+                  const dim_t destOffset,
+                  const dim_t srcOffset,
+                  const copyOptions &options);
+
+    void copyTo(void *dest,
+                const dim_t bytes,
+                const dim_t offset,
+                const copyOptions &options) const;
+
+    void copyTo(const memory dest,
+                const dim_t bytes,
+                const dim_t destOffset,
+                const dim_t srcOffset,
+                const copyOptions &options) const;
+
+    void copyFrom(const void *src,
+                  const copyOptions &options);
+
+    void copyFrom(const memory src,
+                  const copyOptions &options);
+
+    void copyTo(void *dest,
+                const copyOptions &options) const;
+
+    void copyTo(const memory dest,
+                const copyOptions &options) const;
+
     occa::memory as(const dtype_t &dtype_) const;
 
     occa::memory clone() const;
@@ -243,6 +328,91 @@ namespace occa {
   extern memory null;
   //====================================
 
+
+  //---[ memoryView ]-------------------
+  // Non-owning (memory, offset, length, dtype) view
+  //
+  // Views don't allocate or take references, so they can't tell when
+  //   the viewed memory is freed. The memory must outlive its views and
+  //   using a view afterwards is undefined.
+  //
+  // Views can be passed as kernel arguments and used in copies without
+  //   creating a new modeMemory_t like slice() does, getMemory() wraps
+  //   the whole viewed memory for other methods.
+  //
+  // Backends that can't offset their handles keep up to
+  //   modeMemory_t::maxOffsetMemory offset memories per viewed memory,
+  //   so a single launch shouldn't pass more distinct view offsets of
+  //   the same memory than that
+  class memoryView {
+  private:
+    modeMemory_t *modeMemory;
+    udim_t offset_;
+    udim_t size_;
+    const dtype_t *dtype_;
+
+  public:
+    memoryView();
+    memoryView(const occa::memory &mem);
+    memoryView(const occa::memory &mem,
+               const dim_t offset,
+               const dim_t count = -1);
+
+  private:
+    void assertInitialized() const;
+
+  public:
+    bool isInitialized() const;
+
+    modeMemory_t* getModeMemory() const;
+    occa::memory getMemory() const;
+
+    template <class TM = void>
+    TM* ptr() const {
+      return (modeMemory
+              ? (TM*) (modeMemory->ptr + offset_)
+              : NULL);
+    }
+
+    operator kernelArg() const;
+
+    const dtype_t& dtype() const;
+
+    udim_t offset() const;
+    udim_t size() const;
+    udim_t length() const;
+
+    bool operator == (const occa::memoryView &other) const;
+    bool operator != (const occa::memoryView &other) const;
+
+    occa::memoryView operator + (const dim_t offset) const;
+    occa::memoryView& operator += (const dim_t offset);
+
+    occa::memoryView slice(const dim_t offset,
+                           const dim_t count = -1) const;
+
+    occa::memoryView as(const dtype_t &dtype__) const;
+
+    void copyFrom(const void *src,
+                  const dim_t bytes = -1,
+                  const dim_t offset = 0,
+                  const copyOptions &options = copyOptions());
+
+    void copyFrom(const memoryView &src,
+                  const dim_t bytes = -1,
+                  const copyOptions &options = copyOptions());
+
+    void copyTo(void *dest,
+                const dim_t bytes = -1,
+                const dim_t offset = 0,
+                const copyOptions &options = copyOptions()) const;
+
+    void copyTo(const memoryView &dest,
+                const dim_t bytes = -1,
+                const copyOptions &options = copyOptions()) const;
+  };
+  //====================================
+
   std::ostream& operator << (std::ostream &out,
                            const occa::memory &memory);
 
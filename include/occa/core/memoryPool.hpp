@@ -0,0 +1,94 @@
+#ifndef OCCA_CORE_MEMORYPOOL_HEADER
+#define OCCA_CORE_MEMORYPOOL_HEADER
+
+#include <map>
+#include <vector>
+
+#include <occa/defines.hpp>
+#include <occa/tools/hash.hpp>
+#include <occa/tools/properties.hpp>
+
+namespace occa {
+  class modeMemory_t;
+  class modeDevice_t;
+  class modeStream_t;
+
+  //---[ memoryPoolStats ]--------------
+  class memoryPoolStats {
+  public:
+    // Backend bytes held by the pool, waiting to be reused
+    udim_t cachedBytes;
+    // Allocations served from / missing the pool
+    udim_t hits, misses;
+    // Backend bytes released by trimming
+    udim_t trimmedBytes;
+
+    memoryPoolStats();
+  };
+  //====================================
+
+  //---[ memoryPool_t ]-----------------
+  // Opt-in caching allocator used by device::malloc
+  //
+  // Device properties:
+  //   memory_pool                  : Boolean (default: false)
+  //   memory_pool_max_cached_bytes : Integer, cached bytes kept after finish()
+  //
+  // Freed allocations are binned by size class and memory properties.
+  // Blocks freed on a stream are only reused on that stream until the
+  //   device is finished, after which any stream can pick them up.
+  class memoryPool_t {
+  private:
+    typedef std::vector<modeMemory_t*>         blockVector;
+    typedef std::map<hash_t, blockVector>      blockBinMap;
+    typedef std::map<modeStream_t*, blockBinMap> streamBinMap;
+
+    modeDevice_t *modeDevice;
+    bool enabled;
+    udim_t maxCachedBytes;
+
+    streamBinMap streamBins;
+    blockBinMap readyBins;
+
+    memoryPoolStats stats_;
+
+  public:
+    memoryPool_t(modeDevice_t *modeDevice_,
+                 const occa::properties &props);
+
+    static udim_t sizeClass(const udim_t bytes);
+
+    bool isEnabled() const;
+    const memoryPoolStats& stats() const;
+
+    modeMemory_t* malloc(const udim_t bytes,
+                         const void *src,
+                         const occa::properties &props);
+
+    // Returns false if the block isn't pooled and should be deleted
+    bool release(modeMemory_t *mem);
+
+    // Blocks freed on any stream become reusable
+    void finish();
+
+    // Release cached blocks until at most [bytes] remain cached
+    void trim(const udim_t bytes = 0);
+
+    // Drop references without freeing, the device owns the blocks
+    void clear();
+
+  private:
+    modeMemory_t* backendMalloc(const udim_t bytes,
+                                const void *src,
+                                const occa::properties &props);
+
+    static modeMemory_t* popBlock(blockBinMap &bins,
+                                  const hash_t &binHash);
+
+    void trimBins(blockBinMap &bins,
+                  const udim_t bytes);
+  };
+  //====================================
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef OCCA_CORE_SCRATCH_HEADER
+#define OCCA_CORE_SCRATCH_HEADER
+
+#include <vector>
+
+#include <occa/defines.hpp>
+#include <occa/core/memory.hpp>
+#include <occa/core/stream.hpp>
+#include <occa/core/streamTag.hpp>
+
+namespace occa {
+  class modeDevice_t; class device;
+
+  //---[ scratchArena_t ]---------------
+  // Bump allocator behind device::scratch
+  //
+  // Device properties:
+  //   scratch_bytes : Integer, initial arena size (default: 1 MB)
+  //
+  // Allocations are slices of preallocated arenas and are released
+  //   all at once when their scratchScope ends.
+  // If an arena runs out of space, a larger one is added and all
+  //   arenas are merged once the outermost scope ends.
+  //
+  // Scratch memory is ordered with the device stream that is current
+  //   when its scope ends:
+  //   - Work queued on that stream may still use the released memory,
+  //     later allocations from the same stream are ordered after it
+  //   - Allocating from another stream waits for the work queued before
+  //     the release, as does freeing arenas when they are merged
+  //   - Work queued on other streams must be finished before the scope
+  //     ends
+  class scratchArena_t {
+  public:
+    static const udim_t alignment = 256;
+
+    std::vector<memory> arenas;
+    int arenaIndex;
+    udim_t offset;
+    udim_t nextArenaBytes;
+    int scopes;
+
+    // Stream and tag recorded when the last scope ended
+    modeStream_t *releaseStream;
+    streamTag releaseTag;
+
+    scratchArena_t(const occa::properties &props);
+
+    static udim_t alignedBytes(const udim_t bytes);
+
+    memory allocate(device &dev,
+                    const udim_t bytes);
+
+    void beginScope(int &arenaIndex_,
+                    udim_t &offset_);
+
+    void endScope(device &dev,
+                  const int arenaIndex_,
+                  const udim_t offset_);
+
+    udim_t capacity() const;
+    udim_t bytesUsed() const;
+
+    void free();
+  };
+  //====================================
+
+  //---[ scratchScope ]-----------------
+  // Releases scratch allocations made on the device during its lifetime
+  //
+  //   occa::scratchScope scope(device);
+  //   occa::memory tmp = device.scratch(entries, occa::dtype::float_);
+  class scratchScope {
+  private:
+    modeDevice_t *modeDevice;
+    int arenaIndex;
+    udim_t offset;
+
+  public:
+    scratchScope();
+    scratchScope(occa::device device);
+    ~scratchScope();
+
+  private:
+    scratchScope(const scratchScope &other);
+    scratchScope& operator = (const scratchScope &other);
+  };
+  //====================================
+}
+
+#endif
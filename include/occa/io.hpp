@@ -4,6 +4,7 @@
 #include <occa/io/cache.hpp>
 #include <occa/io/fileOpener.hpp>
 #include <occa/io/lock.hpp>
+#include <occa/io/pack.hpp>
 #include <occa/io/utils.hpp>
 
 #endif
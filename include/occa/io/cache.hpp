@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include <occa/tools/hash.hpp>
+#include <occa/types.hpp>
 
 namespace occa {
   class json;
@@ -32,6 +33,58 @@ namespace occa {
     bool cachedFileIsComplete(const std::string &hashDir,
                               const std::string &filename);
 
+    std::string localHashDir(const std::string &hashDir);
+
+    std::string findCachedFile(const std::string &hashDir,
+                               const std::string &filename,
+                               const strVector &metadataFiles = strVector());
+
+    std::string storeCachedFile(const std::string &hashDir,
+                                const std::string &filename,
+                                const strVector &metadataFiles = strVector());
+
+    std::string packKey(const std::string &hashDir,
+                        const std::string &filename);
+
+    bool extractPackedFile(const std::string &hashDir,
+                           const std::string &filename,
+                           const strVector &metadataFiles = strVector());
+
+    void packFile(const std::string &hashDir,
+                  const std::string &filename,
+                  const strVector &metadataFiles = strVector());
+
+    std::string binaryHashDir(const hash_t &binaryHash);
+
+    hash_t compiledBinaryHash(const std::string &sourceFilename,
+                              const std::string &command,
+                              const std::string &hashDir);
+
+    bool loadSharedBinary(const hash_t &binaryHash,
+                          const std::string &binaryFilename);
+
+    void storeSharedBinary(const hash_t &binaryHash,
+                           const std::string &binaryFilename);
+
+    std::string cachedBuildFile(const std::string &hashDir);
+
+    std::string definesIndexFile(const hash_t &definesFreeHash);
+
+    hash_t findKernelWithDefines(const hash_t &definesFreeHash,
+                                 const json &defines);
+
+    std::string autotuneFile(const hash_t &tuningHash);
+
+    json findAutotunedProperties(const hash_t &tuningHash);
+
+    void storeAutotunedProperties(const hash_t &tuningHash,
+                                  const json &props,
+                                  const double time);
+
+    void registerKernelDefines(const hash_t &definesFreeHash,
+                               const hash_t &kernelHash,
+                               const json &defines);
+
     void setBuildProps(occa::json &props);
 
     void writeBuildFile(const std::string &filename,
@@ -0,0 +1,80 @@
+#ifndef OCCA_IO_PACK_HEADER
+#define OCCA_IO_PACK_HEADER
+
+#include <iostream>
+#include <map>
+
+#include <occa/tools/sys.hpp>
+#include <occa/types.hpp>
+
+namespace occa {
+  namespace io {
+    // Append-only file storing cached files as (key, content) records
+    //
+    // File layout:
+    //   [magic: 4 bytes][generation: uint64][records...]
+    //
+    // Record layout:
+    //   [magic: 4 bytes][key bytes: uint32][content bytes: uint64][key][content]
+    //
+    // The index is built by walking record headers through a read-only
+    //   memory map and is refreshed when another process appends records.
+    // Duplicate keys are allowed, the first record wins.
+    //
+    // Packs are never modified in place. Eviction writes a new pack with
+    //   a new generation and renames it over the old one, so the index is
+    //   rebuilt whenever the generation changes.
+    class pack_t {
+    private:
+      struct entry_t {
+        udim_t offset;
+        udim_t bytes;
+      };
+      typedef std::map<std::string, entry_t> entryMap;
+
+      std::string filename;
+      entryMap entries;
+      char *mappedPtr;
+      udim_t mappedBytes;
+      uint64_t mappedInode;
+      uint64_t generation;
+      udim_t indexedBytes;
+      mutex mutex_;
+
+    public:
+      static const char magic[4];
+      static const char fileMagic[4];
+
+      pack_t(const std::string &filename_);
+      ~pack_t();
+
+      bool has(const std::string &key);
+      udim_t size();
+      udim_t bytes();
+
+      std::string read(const std::string &key);
+      bool extract(const std::string &key,
+                   const std::string &destination);
+
+      bool append(const std::string &key,
+                  const std::string &content,
+                  const udim_t maxBytes = 0);
+      bool appendFile(const std::string &key,
+                      const std::string &sourceFile,
+                      const udim_t maxBytes = 0);
+
+    private:
+      bool refreshIndex();
+      void resetIndex();
+      void unmap();
+      bool find(const std::string &key, entry_t &entry);
+      void evict(const udim_t targetBytes);
+    };
+
+    bool usingCachePack();
+    const std::string& cachePackFilename();
+    pack_t& cachePack();
+  }
+}
+
+#endif
@@ -13,13 +13,20 @@ namespace occa {
     extern const std::string sourceFile;
     extern const std::string binaryFile;
     extern const std::string buildFile;
+    extern const std::string buildMetadataFile;
     extern const std::string launcherSourceFile;
     extern const std::string launcherBinaryFile;
     extern const std::string launcherBuildFile;
+    extern const std::string launcherBuildMetadataFile;
+    extern const std::string pgoInstrumentedBinaryFile;
+    extern const std::string pgoBinaryFile;
+    extern const std::string pgoProfileDir;
+    extern const std::string pgoProfileMarker;
   }
 
   namespace io {
     const std::string& cachePath();
+    const std::string& localCachePath();
     const std::string& libraryPath();
 
     std::string currentWorkingDirectory();
@@ -76,6 +83,9 @@ namespace occa {
 
     void write(const std::string &filename,
                const std::string &content);
+
+    bool copy(const std::string &source,
+              const std::string &destination);
   }
 }
 
@@ -50,11 +50,21 @@ namespace occa {
      public:
       kernelMetadataMap kernelsMetadata;
       strHashMap dependencyHashes;
+      strVector macroReferences;
 
       sourceMetadata_t();
 
       json getKernelMetadataJson() const;
       json getDependencyJson() const;
+      json getMacroReferencesJson() const;
+
+      // Kernel metadata is also stored in a binary file next to the
+      //   build file so cache hits don't have to parse JSON
+      static std::string metadataFilename(const std::string &buildFilename);
+
+      void writeMetadataFile(const std::string &filename) const;
+      static bool loadMetadataFile(const std::string &filename,
+                                   sourceMetadata_t &metadata);
 
       static sourceMetadata_t fromBuildFile(const std::string &filename);
     };
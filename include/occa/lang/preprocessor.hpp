@@ -65,6 +65,9 @@ namespace occa {
       occa::properties settings;
 
       strToBoolMap dependencies;
+      // Names looked up as macros, used to find which defines
+      //   affect the preprocessed output
+      strToBoolMap macroReferences;
       int warnings, errors;
       //================================
 
@@ -125,6 +128,7 @@ namespace occa {
       void removeSourceDefine(const std::string &name);
 
       strVector getDependencyFilenames() const;
+      strVector getMacroReferences() const;
       //================================
 
       void loadTokenizer();
@@ -4,6 +4,7 @@
 #include <occa/lang/transforms/builtins/dim.hpp>
 #include <occa/lang/transforms/builtins/finders.hpp>
 #include <occa/lang/transforms/builtins/restrict.hpp>
+#include <occa/lang/transforms/builtins/specialize.hpp>
 #include <occa/lang/transforms/builtins/tile.hpp>
 
 #endif
@@ -0,0 +1,35 @@
+#ifndef OCCA_LANG_TRANSFORMS_BUILTINS_SPECIALIZE_HEADER
+#define OCCA_LANG_TRANSFORMS_BUILTINS_SPECIALIZE_HEADER
+
+#include <occa/lang/primitive.hpp>
+#include <occa/lang/transforms/builtins/finders.hpp>
+
+namespace occa {
+  class json;
+
+  namespace lang {
+    class blockStatement;
+
+    namespace transforms {
+      // Replaces uses of a kernel argument with a literal value
+      class argumentSpecializer_t : public statementExprTransform {
+      private:
+        const variable_t *arg;
+        primitive value;
+
+      public:
+        argumentSpecializer_t();
+
+        virtual exprNode* transformExprNode(exprNode &node);
+
+        void set(const variable_t &arg_,
+                 const primitive &value_);
+      };
+
+      bool applySpecializeTransforms(blockStatement &root,
+                                     const json &specializedArgs);
+    }
+  }
+}
+
+#endif
@@ -33,6 +33,7 @@ namespace occa {
       CUstream& getCuStream() const;
 
       kernelArg makeKernelArg() const;
+      kernelArg makeOffsetKernelArg(const udim_t offset);
 
       modeMemory_t* addOffset(const dim_t offset);
 
@@ -41,18 +42,18 @@ namespace occa {
       void copyTo(void *dest,
                   const udim_t bytes,
                   const udim_t destOffset = 0,
-                  const occa::properties &props = occa::properties()) const;
+                  const copyOptions &options = copyOptions()) const;
 
       void copyFrom(const void *src,
                     const udim_t bytes,
                     const udim_t offset = 0,
-                    const occa::properties &props = occa::properties());
+                    const copyOptions &options = copyOptions());
 
       void copyFrom(const modeMemory_t *src,
                     const udim_t bytes,
                     const udim_t destOffset = 0,
                     const udim_t srcOffset = 0,
-                    const occa::properties &props = occa::properties());
+                    const copyOptions &options = copyOptions());
       void detach();
     };
   }
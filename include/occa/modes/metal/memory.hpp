@@ -34,18 +34,18 @@ namespace occa {
       void copyTo(void *dest,
                   const udim_t bytes,
                   const udim_t destOffset = 0,
-                  const occa::properties &props = occa::properties()) const;
+                  const copyOptions &options = copyOptions()) const;
 
       void copyFrom(const void *src,
                     const udim_t bytes,
                     const udim_t offset = 0,
-                    const occa::properties &props = occa::properties());
+                    const copyOptions &options = copyOptions());
 
       void copyFrom(const modeMemory_t *src,
                     const udim_t bytes,
                     const udim_t destOffset = 0,
                     const udim_t srcOffset = 0,
-                    const occa::properties &props = occa::properties());
+                    const copyOptions &options = copyOptions());
       void detach();
     };
   }
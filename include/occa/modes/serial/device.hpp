@@ -6,8 +6,12 @@
 
 namespace occa {
   namespace serial {
+    class kernel;
+
     class device : public occa::modeDevice_t {
       mutable hash_t hash_;
+      // Report host memory as a separate space to exercise transfer paths
+      bool separateMemorySpace;
 
     public:
       device(const occa::properties &properties_);
@@ -51,6 +55,24 @@ namespace occa {
                                 const occa::properties &kernelProps,
                                 const bool isLauncerKernel);
 
+      void setupHostKernel(kernel &k,
+                           const std::string &hashDir,
+                           const occa::properties &kernelProps);
+
+      void setupIsaKernel(kernel &k,
+                          const std::string &hashDir,
+                          const occa::properties &kernelProps);
+
+      void setupPgoKernel(kernel &k,
+                          const std::string &hashDir,
+                          const occa::properties &kernelProps);
+
+      // Builds the profile-optimized binary once profiles were collected
+      //   and loads it into [k], returning false if it's not available
+      bool loadPgoBinary(kernel &k,
+                         const std::string &hashDir,
+                         const occa::properties &kernelProps);
+
       virtual modeKernel_t* buildKernelFromBinary(const std::string &filename,
                                                   const std::string &kernelName,
                                                   const occa::properties &kernelProps);
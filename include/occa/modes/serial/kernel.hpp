@@ -17,6 +17,16 @@ namespace occa {
       functionPtr_t function;
       mutable std::vector<void*> vArgs;
 
+      // Profile-guided optimization
+      // The instrumented binary is used until pgoLaunchesLeft reaches 0,
+      //   launches then use the baseline binary until every kernel sharing
+      //   the profile finished and the profile-optimized binary is loaded
+      mutable void *pgoDlHandle;
+      mutable functionPtr_t pgoFunction;
+      mutable int pgoLaunchesLeft;
+      mutable bool pgoWaiting;
+      std::string pgoHashDir;
+
     public:
       bool isLauncherKernel;
 
@@ -34,6 +44,26 @@ namespace occa {
 
       void run() const;
 
+      void loadBinary(const std::string &filename);
+
+      // Runs the instrumented binary for the next [launches] launches
+      void startProfiling(const std::string &hashDir,
+                          const std::string &instrumentedFilename,
+                          const int launches);
+
+      // Whether kernels in this process still use the instrumented
+      //   binary from [hashDir], which only writes its profile once unloaded
+      static bool isProfiling(const std::string &hashDir);
+
+      // Switches back to the baseline binary until the profile-optimized
+      //   binary can be built
+      void finishProfiling() const;
+
+      // Builds the profile-optimized binary if needed and loads it
+      void loadPgoBinary() const;
+
+      void stopWaitingForPgo() const;
+
       friend class device;
     };
   }
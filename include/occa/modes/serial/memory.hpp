@@ -14,24 +14,25 @@ namespace occa {
       ~memory();
 
       kernelArg makeKernelArg() const;
+      kernelArg makeOffsetKernelArg(const udim_t offset);
 
       modeMemory_t* addOffset(const dim_t offset);
 
       void copyTo(void *dest,
                   const udim_t bytes,
                   const udim_t destOffset,
-                  const occa::properties &props) const;
+                  const copyOptions &options) const;
 
       void copyFrom(const void *src,
                     const udim_t bytes,
                     const udim_t offset,
-                    const occa::properties &props);
+                    const copyOptions &options);
 
       void copyFrom(const modeMemory_t *src,
                     const udim_t bytes,
                     const udim_t destOffset,
                     const udim_t srcOffset,
-                    const occa::properties &props);
+                    const copyOptions &options);
       void detach();
     };
   }
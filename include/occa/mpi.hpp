@@ -7,6 +7,10 @@
 #include <mpi.h>
 #include <vector>
 
+#include <occa/array/linalg.hpp>
+#include <occa/core/kernel.hpp>
+#include <occa/core/memory.hpp>
+#include <occa/core/stream.hpp>
 #include <occa/tools/json.hpp>
 
 namespace occa {
@@ -16,6 +20,9 @@ namespace occa {
     class buffer_t {
     public:
       static int size;
+      // Staging buffers used to overlap copies with transfers
+      //   when devices have a separate memory space
+      static int pipelineDepth;
       char *ptr;
 
       buffer_t();
@@ -57,14 +64,89 @@ namespace occa {
     MPI_Datatype type<double>();
     //==================================
 
+    //---[ Pipeline ]-------------------
+    // Chunked transfer of device memory through host staging buffers,
+    //   shared by the tags tracking it
+    //
+    // At most buffer_t::pipelineDepth chunks are staged at a time.
+    // Chunks past the first staged ones are copied and posted as earlier
+    //   chunks finish, which happens whenever any mpi::tag is waited on or
+    //   tested. Neither send() nor get() block on the other rank.
+    //
+    // Transfers with the same rank, message ID and direction are posted
+    //   in the order they were started so MPI matches their chunks in order
+    class pipeline_t {
+    public:
+      bool sending;
+      // Device memory is staged through host buffers, host memory
+      //   is transferred in place
+      bool staged;
+      int rank;
+      int messageID;
+      MPI_Datatype mpiType;
+      occa::memory data;
+      dim_t entries;
+      dim_t chunkEntries;
+      int entryBytes;
+
+      std::vector<MPI_Request> mpiRequests;
+      std::vector<char*> buffers;
+      // Chunks with posted requests
+      int postedChunks;
+      // Received chunks copied into [data]
+      int copiedChunks;
+      int refs;
+      bool done;
+
+      pipeline_t(const bool sending_,
+                 const int rank_,
+                 const int messageID_,
+                 MPI_Datatype mpiType_,
+                 occa::memory data_,
+                 const dim_t entries_,
+                 const int entryBytes_);
+      ~pipeline_t();
+
+      int chunks() const;
+      bool isPosted() const;
+
+      void wait();
+      void updateStatus();
+
+      // Posts and copies chunks that no longer need to wait
+      void progress(const bool canPost);
+
+      // Progresses every unfinished pipeline in the order they started
+      static void progressAll();
+      static bool hasPending();
+      static bool hasUnposted(const bool sending_,
+                              const int rank_,
+                              const int messageID_);
+
+    private:
+      bool matches(const bool sending_,
+                   const int rank_,
+                   const int messageID_) const;
+      dim_t chunkCount(const int chunk) const;
+      void post(const int chunk);
+      void releaseBuffers();
+    };
+    //==================================
+
     //---[ Tag ]------------------------
     class tag {
     public:
       MPI_Request mpiRequest;
       bool initialized;
       bool done;
+      pipeline_t *pipeline;
 
       tag();
+      tag(pipeline_t *pipeline_);
+      tag(const tag &other);
+      ~tag();
+
+      tag& operator = (const tag &other);
 
       bool isInitialized();
       void wait();
@@ -90,54 +172,41 @@ namespace occa {
     //==================================
 
     //---[ Methods ]--------------------
+    // Transfers start right away and finish once their tag is done,
+    //   [data] must not be used by the caller until then
+    tag sendMemory(const int receiverID,
+                   const occa::memory &data,
+                   const dim_t entries,
+                   const int entryBytes,
+                   MPI_Datatype mpiType,
+                   const int messageID);
+
+    tag getMemory(const int senderID,
+                  occa::memory data,
+                  const dim_t entries,
+                  const int entryBytes,
+                  MPI_Datatype mpiType,
+                  const int messageID);
+
     template <class TM>
     tag send(const int receiverID,
              const occa::memory &data,
              const dim_t entries_ = -1,
              const int messageID  = defaultMessageID) {
-      tag tag_;
       const dim_t entries = ((entries_ == -1)
                              ? (data.size() / sizeof(TM))
                              : entries_);
       if ((receiverID < 0)            ||
           (mpi::size() <= receiverID) ||
           (entries < 0)) {
-        return tag_;
-      }
-      if (!data
-          .getDevice()
-          .hasSeparateMemorySpace()) {
-        MPI_Isend((void*) data.ptr(),
-                  entries,
-                  type<TM>(),
-                  receiverID,
-                  messageID,
-                  MPI_COMM_WORLD,
-                  &tag_.mpiRequest);
-        tag_.initialized = true;
-      } else {
-        int bufferEntries = buffer_t::size / sizeof(TM);
-        void *buffer = getBuffer();
-
-        for (int offset = 0; offset < entries; offset += bufferEntries) {
-          int count = offset + bufferEntries;
-          if (count >= entries) {
-            count = (entries - offset);
-          }
-
-          data.copyTo(buffer,
-                      count * sizeof(TM),
-                      offset);
-
-          MPI_Send(buffer,
-                   count,
-                   type<TM>(),
-                   receiverID,
-                   messageID,
-                   MPI_COMM_WORLD);
-        }
+        return tag();
       }
-      return tag_;
+      return sendMemory(receiverID,
+                        data,
+                        entries,
+                        sizeof(TM),
+                        type<TM>(),
+                        messageID);
     }
 
     template <class TM>
@@ -145,53 +214,244 @@ namespace occa {
             occa::memory data,
             const dim_t entries_ = -1,
             const int messageID  = defaultMessageID) {
-      tag tag_;
       const dim_t entries = ((entries_ == -1)
                              ? (data.size() / sizeof(TM))
                              : entries_);
       if ((senderID < 0)            ||
           (mpi::size() <= senderID) ||
           (entries < 0)) {
-        return tag_;
+        return tag();
       }
-      if (!data
-          .getDevice()
-          .hasSeparateMemorySpace()) {
-        MPI_Irecv(data.ptr(),
-                  entries,
-                  type<TM>(),
-                  senderID,
-                  messageID,
-                  MPI_COMM_WORLD,
-                  &tag_.mpiRequest);
-        tag_.initialized = true;
-      } else {
-        int bufferEntries = buffer_t::size / sizeof(TM);
-        void *buffer = getBuffer();
-
-        for (int offset = 0; offset < entries; offset += bufferEntries) {
-          int count = offset + bufferEntries;
-          if (count >= entries) {
-            count = (entries - offset);
-          }
-
-          MPI_Status mpiStatus;
-          MPI_Recv(buffer,
-                   count,
-                   type<TM>(),
-                   senderID,
-                   messageID,
-                   MPI_COMM_WORLD,
-                   &mpiStatus);
-
-          data.copyFrom(buffer,
-                        count * sizeof(TM),
-                        offset);
-        }
-      }
-      return tag_;
+      return getMemory(senderID,
+                       data,
+                       entries,
+                       sizeof(TM),
+                       type<TM>(),
+                       messageID);
     }
     //==================================
+
+    //---[ Halo Exchange ]--------------
+    // Entries exchanged with one neighbor rank
+    // Indices are in entries of the exchanged memory's dtype
+    // Tags are added to the exchange's messageID and must be distinct when
+    //   a rank appears more than once, for example with the direction the
+    //   halo travels:
+    //     haloNeighbor(rightRank, RIGHT, LEFT)
+    //     haloNeighbor(leftRank, LEFT, RIGHT)
+    class haloNeighbor {
+    public:
+      int rank;
+      int sendTag;
+      int receiveTag;
+      std::vector<int> sendIndices;
+      std::vector<int> receiveIndices;
+
+      haloNeighbor(const int rank_);
+
+      haloNeighbor(const int rank_,
+                   const int sendTag_,
+                   const int receiveTag_);
+
+      haloNeighbor& send(const std::vector<int> &indices);
+      haloNeighbor& send(const int offset,
+                         const int count,
+                         const int stride = 1);
+
+      haloNeighbor& receive(const std::vector<int> &indices);
+      haloNeighbor& receive(const int offset,
+                            const int count,
+                            const int stride = 1);
+    };
+
+    typedef std::vector<haloNeighbor> haloNeighborVector;
+
+    // Persistent exchange of halo entries with neighbor ranks
+    //
+    //   occa::mpi::haloExchange halo(field, neighbors);
+    //   for (...) {
+    //     halo.start();
+    //     interiorKernel(field);
+    //     halo.finish();
+    //     boundaryKernel(field);
+    //   }
+    //
+    // Packing, host staging and unpacking run on the exchange's stream
+    //   and MPI requests are created once with MPI_Send_init/MPI_Recv_init
+    //
+    // Ordering with the device's current stream:
+    //   - start() waits for work already queued on the current stream
+    //     before packing, so sent entries include the last field update
+    //   - finish() returns once ghost entries are unpacked, kernels queued
+    //     afterwards on any stream see them
+    //   - Kernels queued between start() and finish() must not write sent
+    //     entries or read ghost entries
+    class haloExchange {
+    private:
+      occa::device device;
+      occa::stream stream;
+      // Untyped view of the exchanged memory
+      occa::memory field;
+
+      occa::kernel packKernel, unpackKernel;
+      occa::memory sendIndices, receiveIndices;
+      occa::memory sendBuffer, receiveBuffer;
+      int sendEntries, receiveEntries;
+
+      // Host copies for devices with a separate memory space
+      std::vector<char> sendHostBuffer, receiveHostBuffer;
+
+      // Receive requests are stored before send requests
+      std::vector<MPI_Request> mpiRequests;
+      int receiveRequests;
+      tags pending;
+
+    public:
+      haloExchange(occa::memory field_,
+                   const haloNeighborVector &neighbors,
+                   const int messageID = defaultMessageID);
+      ~haloExchange();
+
+      occa::stream getStream();
+
+      // Packs and sends halo entries, returning the pending requests
+      tags start();
+
+      // Waits for the exchange and unpacks received entries
+      void finish();
+
+      void exchange();
+
+    private:
+      void buildKernels(const int entryBytes);
+
+      haloExchange(const haloExchange &other);
+      haloExchange& operator = (const haloExchange &other);
+    };
+    //==================================
+
+    //---[ Reductions ]-----------------
+    // Local linalg reductions combined across ranks with a single
+    //   MPI_Iallreduce
+    //
+    //   occa::mpi::reductions reductions;
+    //   const int rr = reductions.dot<double, double>(r, r);
+    //   const int pAp = reductions.dot<double, double>(p, Ap);
+    //   reductions.start();
+    //   updateKernel(...);
+    //   const double alpha = reductions[rr] / reductions[pAp];
+    //
+    // Values are accumulated as doubles
+    class reductions {
+    private:
+      enum op_t {
+        sum_,
+        max_,
+        min_
+      };
+
+      // Result = pow(result, exponent) after the reduction if useExponents
+      //   is set for the value
+      std::vector<double> localValues;
+      std::vector<op_t> ops;
+      std::vector<bool> useExponents;
+      std::vector<double> exponents;
+
+      // [sumCount, sums..., maxs..., -mins...]
+      std::vector<double> buffer;
+      std::vector<double> results;
+      // Created for reductions mixing sums with maxs and mins
+      MPI_Datatype mpiType;
+      MPI_Op mpiOp;
+      MPI_Request mpiRequest;
+      bool started, done;
+
+    public:
+      reductions();
+      ~reductions();
+
+      // Local values can also be added directly
+      int sum(const double localValue);
+      int max(const double localValue);
+      int min(const double localValue);
+
+      template <class VTYPE>
+      int sum(occa::memory vec) {
+        return sum(linalg::sum<VTYPE, double>(vec));
+      }
+
+      template <class VTYPE>
+      int l1Norm(occa::memory vec) {
+        return sum(linalg::l1Norm<VTYPE, double>(vec));
+      }
+
+      template <class VTYPE>
+      int l2Norm(occa::memory vec) {
+        return add(linalg::dot<VTYPE, VTYPE, double>(vec, vec),
+                   sum_, true, 0.5);
+      }
+
+      template <class VTYPE>
+      int lpNorm(const float p, occa::memory vec) {
+        return add(linalg::lpNormPower<VTYPE, double>(p, vec),
+                   sum_, true, 1.0 / p);
+      }
+
+      template <class VTYPE>
+      int lInfNorm(occa::memory vec) {
+        return max(linalg::lInfNorm<VTYPE, double>(vec));
+      }
+
+      template <class VTYPE>
+      int max(occa::memory vec) {
+        return max(linalg::max<VTYPE, double>(vec));
+      }
+
+      template <class VTYPE>
+      int min(occa::memory vec) {
+        return min(linalg::min<VTYPE, double>(vec));
+      }
+
+      template <class VTYPE1, class VTYPE2>
+      int dot(occa::memory vec1, occa::memory vec2) {
+        return sum(linalg::dot<VTYPE1, VTYPE2, double>(vec1, vec2));
+      }
+
+      template <class VTYPE1, class VTYPE2>
+      int distance(occa::memory vec1, occa::memory vec2) {
+        const double localDistance = (
+          linalg::distance<VTYPE1, VTYPE2, double>(vec1, vec2)
+        );
+        return add(localDistance * localDistance,
+                   sum_, true, 0.5);
+      }
+
+      int size() const;
+
+      // Starts the non-blocking MPI_Iallreduce
+      void start();
+
+      bool isDone();
+      void wait();
+
+      // Waits for the reduction if needed
+      double operator [] (const int index);
+
+      // Clears added values to reuse the reduction
+      void clear();
+
+    private:
+      int add(const double localValue,
+              const op_t op,
+              const bool useExponent = false,
+              const double exponent = 1.0);
+
+      void finalize();
+
+      reductions(const reductions &other);
+      reductions& operator = (const reductions &other);
+    };
+    //==================================
   }
 }
 
@@ -14,11 +14,14 @@ namespace occa {
     extern std::string PATH, LD_LIBRARY_PATH;
 
     extern std::string OCCA_DIR, OCCA_INSTALL_DIR, OCCA_CACHE_DIR;
+    extern std::string OCCA_LOCAL_CACHE_DIR;
     extern size_t      OCCA_MEM_BYTE_ALIGN;
     extern strVector   OCCA_INCLUDE_PATH;
     extern strVector   OCCA_LIBRARY_PATH;
     extern strVector   OCCA_KERNEL_PATH;
     extern bool        OCCA_VERBOSE;
+    extern bool        OCCA_CACHE_PACK;
+    extern size_t      OCCA_CACHE_PACK_MAX_BYTES;
     extern bool        OCCA_COLOR_ENABLED;
 
     properties& baseSettings();
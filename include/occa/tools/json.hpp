@@ -1,6 +1,7 @@
 #ifndef OCCA_TOOLS_JSON_HEADER
 #define OCCA_TOOLS_JSON_HEADER
 
+#include <atomic>
 #include <vector>
 #include <map>
 
@@ -15,13 +16,99 @@ namespace occa {
   typedef std::map<std::string, json> jsonObject;
   typedef std::vector<json>           jsonArray;
 
-  typedef struct {
-    bool boolean;
-    primitive number;
-    std::string string;
-    jsonArray array;
-    jsonObject object;
-  } jsonValue_t;
+  class jsonPayload_t;
+
+  //---[ jsonValue_t ]------------------
+  // Tagged union of a boolean, a number or a reference-counted payload
+  //   holding a string, array or object shared between copies
+  //   (copy-on-write)
+  //
+  // Payloads are copied before being modified if they're shared.
+  // Mutable references handed out by the leak methods (and json's
+  //   non-const accessors) are invalidated when the value is copied:
+  //   copies share the payload again and writes through older
+  //   references would show up in both.
+  class jsonValue_t {
+  public:
+    enum kind_t {
+      empty_,
+      boolean_,
+      number_,
+      payload_
+    };
+
+  private:
+    kind_t kind;
+    union {
+      bool booleanValue;
+      primitive numberValue;
+      jsonPayload_t *payload;
+    };
+
+  public:
+    inline jsonValue_t() :
+      kind(empty_),
+      payload(NULL) {}
+
+    jsonValue_t(const jsonValue_t &other);
+    ~jsonValue_t();
+
+    jsonValue_t& operator = (const jsonValue_t &other);
+
+    void clear();
+    void release();
+
+    inline bool sharesPayload(const jsonValue_t &other) const {
+      return ((kind == payload_)
+              && (other.kind == payload_)
+              && (payload == other.payload));
+    }
+
+    // Read-only access, values of another kind read as false, 0 or empty
+    bool boolean() const;
+    const primitive& number() const;
+    const std::string& string() const;
+    const jsonArray& array() const;
+    const jsonObject& object() const;
+
+    void setBoolean(const bool value);
+    void setNumber(const primitive &value);
+
+    // Unshared access for writes that end with the caller
+    std::string& writeString();
+    jsonArray& writeArray();
+    jsonObject& writeObject();
+
+    // Unshared access for references returned to users
+    // Values of another kind are replaced
+    bool& leakBoolean();
+    primitive& leakNumber();
+    std::string& leakString();
+    jsonArray& leakArray();
+    jsonObject& leakObject();
+
+    // Bumped by every json write
+    // Payloads that handed out mutable references can change through
+    //   them, so their memoized hash is only kept while no json was
+    //   written since it was stored
+    static std::atomic<uint64_t> writeGeneration;
+
+    inline static void markWritten() {
+      writeGeneration.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Hash of the json holding the payload as [type], memoized on the
+    //   payload and dropped when it's written
+    bool getCachedHash(const int type,
+                       hash_t &hash) const;
+    void setCachedHash(const int type,
+                       const hash_t &hash) const;
+
+  private:
+    template <class TM>
+    TM& write(const bool leak);
+  };
+  //====================================
 
   class json {
   public:
@@ -51,82 +138,82 @@ namespace occa {
 
     inline json(const bool value) :
       type(boolean_) {
-      value_.boolean = value;
+      value_.setBoolean(value);
     }
 
     inline json(const uint8_t value) :
       type(number_) {
-      value_.number = value;
+      value_.setNumber(value);
     }
 
     inline json(const int8_t value) :
       type(number_) {
-      value_.number = value;
+      value_.setNumber(value);
     }
 
     inline json(const uint16_t value) :
       type(number_) {
-      value_.number = value;
+      value_.setNumber(value);
     }
 
     inline json(const int16_t value) :
       type(number_) {
-      value_.number = value;
+      value_.setNumber(value);
     }
 
     inline json(const uint32_t value) :
       type(number_) {
-      value_.number = value;
+      value_.setNumber(value);
     }
 
     inline json(const int32_t value) :
       type(number_) {
-      value_.number = value;
+      value_.setNumber(value);
     }
 
     inline json(const uint64_t value) :
       type(number_) {
-      value_.number = value;
+      value_.setNumber(value);
     }
 
     inline json(const int64_t value) :
       type(number_) {
-      value_.number = value;
+      value_.setNumber(value);
     }
 
     inline json(const float value) :
       type(number_) {
-      value_.number = value;
+      value_.setNumber(value);
     }
 
     inline json(const double value) :
       type(number_) {
-      value_.number = value;
+      value_.setNumber(value);
     }
 
     inline json(const primitive &value) :
       type(number_) {
-      value_.number = value;
+      value_.setNumber(value);
     }
 
     inline json(const char *value) :
       type(string_) {
-      value_.string = value;
+      value_.writeString() = value;
     }
 
     inline json(const std::string &value) :
       type(string_) {
-      value_.string = value;
+      value_.writeString() = value;
     }
 
     inline json(const jsonObject &value) :
       type(object_) {
-      value_.object = value;
+      value_.writeObject() = value;
     }
 
     inline json(const jsonArray &value) :
       type(array_) {
-      value_.array = value;
+      value_.writeArray() = value;
     }
 
     virtual ~json();
@@ -137,97 +224,97 @@ namespace occa {
 
     inline json& operator = (const char *c) {
       type = string_;
-      value_.string = c;
+      value_.writeString() = c;
       return *this;
     }
 
     inline json& operator = (const std::string &value) {
       type = string_;
-      value_.string = value;
+      value_.writeString() = value;
       return *this;
     }
 
     inline json& operator = (const bool value) {
       type = boolean_;
-      value_.boolean = value;
+      value_.setBoolean(value);
       return *this;
     }
 
     inline json& operator = (const uint8_t value) {
       type = number_;
-      value_.number = value;
+      value_.setNumber(value);
       return *this;
     }
 
     inline json& operator = (const int8_t value) {
       type = number_;
-      value_.number = value;
+      value_.setNumber(value);
       return *this;
     }
 
     inline json& operator = (const uint16_t value) {
       type = number_;
-      value_.number = value;
+      value_.setNumber(value);
       return *this;
     }
 
     inline json& operator = (const int16_t value) {
       type = number_;
-      value_.number = value;
+      value_.setNumber(value);
       return *this;
     }
 
     inline json& operator = (const uint32_t value) {
       type = number_;
-      value_.number = value;
+      value_.setNumber(value);
       return *this;
     }
 
     inline json& operator = (const int32_t value) {
       type = number_;
-      value_.number = value;
+      value_.setNumber(value);
       return *this;
     }
 
     inline json& operator = (const uint64_t value) {
       type = number_;
-      value_.number = value;
+      value_.setNumber(value);
       return *this;
     }
 
     inline json& operator = (const int64_t value) {
       type = number_;
-      value_.number = value;
+      value_.setNumber(value);
       return *this;
     }
 
     inline json& operator = (const float value) {
       type = number_;
-      value_.number = value;
+      value_.setNumber(value);
       return *this;
     }
 
     inline json& operator = (const double value) {
       type = number_;
-      value_.number = value;
+      value_.setNumber(value);
       return *this;
     }
 
     inline json& operator = (const primitive &value) {
       type = number_;
-      value_.number = value;
+      value_.setNumber(value);
       return *this;
     }
 
     inline json& operator = (const jsonObject &value) {
       type = object_;
-      value_.object = value;
+      value_.writeObject() = value;
       return *this;
     }
 
     inline json& operator = (const jsonArray &value) {
       type = array_;
-      value_.array = value;
+      value_.writeArray() = value;
       return *this;
     }
 
@@ -338,43 +425,43 @@ namespace occa {
     }
 
     inline bool& boolean() {
-      return value_.boolean;
+      return value_.leakBoolean();
     }
 
     inline primitive& number() {
-      return value_.number;
+      return value_.leakNumber();
     }
 
     inline std::string& string() {
-      return value_.string;
+      return value_.leakString();
     }
 
     inline jsonArray& array() {
-      return value_.array;
+      return value_.leakArray();
     }
 
     inline jsonObject& object() {
-      return value_.object;
+      return value_.leakObject();
     }
 
     inline bool boolean() const {
-      return value_.boolean;
+      return value_.boolean();
     }
 
     inline const primitive& number() const {
-      return value_.number;
+      return value_.number();
     }
 
     inline const std::string& string() const {
-      return value_.string;
+      return value_.string();
     }
 
     inline const jsonArray& array() const {
-      return value_.array;
+      return value_.array();
     }
 
     inline const jsonObject& object() const {
-      return value_.object;
+      return value_.object();
     }
 
     json& operator [] (const char *c);
@@ -440,15 +527,18 @@ namespace occa {
       case null_:
         return true;
       case boolean_:
-        return value_.boolean == j.value_.boolean;
+        return value_.boolean() == j.value_.boolean();
       case number_:
-        return primitive::equal(value_.number, j.value_.number);
+        return primitive::equal(value_.number(), j.value_.number());
       case string_:
-        return value_.string == j.value_.string;
+        return (value_.sharesPayload(j.value_)
+                || (value_.string() == j.value_.string()));
       case object_:
-        return value_.object == j.value_.object;
+        return (value_.sharesPayload(j.value_)
+                || (value_.object() == j.value_.object()));
       case array_:
-        return value_.array == j.value_.array;
+        return (value_.sharesPayload(j.value_)
+                || (value_.array() == j.value_.array()));
       default:
         return false;
       }
@@ -457,11 +547,11 @@ namespace occa {
     inline operator bool () const {
       switch (type) {
       case boolean_:
-        return value_.boolean;
+        return value_.boolean();
       case number_:
-        return value_.number;
+        return value_.number();
       case string_:
-        return value_.string.size();
+        return value_.string().size();
       case object_:
         return true;
       case array_:
@@ -474,9 +564,9 @@ namespace occa {
     inline operator uint8_t () const {
       switch (type) {
       case boolean_:
-        return value_.boolean;
+        return value_.boolean();
       case number_:
-        return (uint8_t) value_.number;
+        return (uint8_t) value_.number();
       default:
         return 0;
       }
@@ -485,9 +575,9 @@ namespace occa {
     inline operator uint16_t () const {
       switch (type) {
       case boolean_:
-        return value_.boolean;
+        return value_.boolean();
       case number_:
-        return (uint16_t) value_.number;
+        return (uint16_t) value_.number();
       default:
         return 0;
       }
@@ -496,9 +586,9 @@ namespace occa {
     inline operator uint32_t () const {
       switch (type) {
       case boolean_:
-        return value_.boolean;
+        return value_.boolean();
       case number_:
-        return (uint32_t) value_.number;
+        return (uint32_t) value_.number();
       default:
         return 0;
       }
@@ -507,9 +597,9 @@ namespace occa {
     inline operator uint64_t () const {
       switch (type) {
       case boolean_:
-        return value_.boolean;
+        return value_.boolean();
       case number_:
-        return (uint64_t) value_.number;
+        return (uint64_t) value_.number();
       default:
         return 0;
       }
@@ -518,9 +608,9 @@ namespace occa {
     inline operator int8_t () const {
       switch (type) {
       case boolean_:
-        return value_.boolean;
+        return value_.boolean();
       case number_:
-        return (int8_t) value_.number;
+        return (int8_t) value_.number();
       default:
         return 0;
       }
@@ -529,9 +619,9 @@ namespace occa {
     inline operator int16_t () const {
       switch (type) {
       case boolean_:
-        return value_.boolean;
+        return value_.boolean();
       case number_:
-        return (int16_t) value_.number;
+        return (int16_t) value_.number();
       default:
         return 0;
       }
@@ -540,9 +630,9 @@ namespace occa {
     inline operator int32_t () const {
       switch (type) {
       case boolean_:
-        return value_.boolean;
+        return value_.boolean();
       case number_:
-        return (int32_t) value_.number;
+        return (int32_t) value_.number();
       default:
         return 0;
       }
@@ -551,9 +641,9 @@ namespace occa {
     inline operator int64_t () const {
       switch (type) {
       case boolean_:
-        return value_.boolean;
+        return value_.boolean();
       case number_:
-        return (int64_t) value_.number;
+        return (int64_t) value_.number();
       default:
         return 0;
       }
@@ -562,9 +652,9 @@ namespace occa {
     inline operator float () const {
       switch (type) {
       case boolean_:
-        return value_.boolean;
+        return value_.boolean();
       case number_:
-        return (float) value_.number;
+        return (float) value_.number();
       default:
         return 0;
       }
@@ -573,9 +663,9 @@ namespace occa {
     inline operator double () const {
       switch (type) {
       case boolean_:
-        return value_.boolean;
+        return value_.boolean();
       case number_:
-        return (double) value_.number;
+        return (double) value_.number();
       default:
         return 0;
       }
@@ -598,6 +688,190 @@ namespace occa {
 
   std::ostream& operator << (std::ostream &out,
                            const json &j);
+
+  //---[ jsonPayload_t ]----------------
+  class jsonPayload_t {
+  public:
+    enum kind_t {
+      string_,
+      array_,
+      object_
+    };
+
+    const kind_t kind;
+    std::atomic<int> refs;
+    // Set while mutable references into the payload may be held,
+    //   cleared once a copy shares it again
+    std::atomic<bool> leaked;
+
+    // Even while the hash is stable and odd while a thread stores it,
+    //   0 when there's no hash. Reset by writes.
+    // Readers check it didn't change while copying the hash since stale
+    //   hashes of leaked payloads are replaced by const hash() calls
+    std::atomic<unsigned int> hashVersion;
+    int hashType;
+    // jsonValue_t::writeGeneration when the hash was stored
+    uint64_t hashGeneration;
+    hash_t hash;
+
+    inline jsonPayload_t(const kind_t kind_) :
+      kind(kind_),
+      refs(1),
+      leaked(false),
+      hashVersion(0),
+      hashType(0),
+      hashGeneration(0) {}
+
+    virtual ~jsonPayload_t() {}
+
+    virtual jsonPayload_t* clone() const = 0;
+  };
+
+  template <class TM>
+  class jsonPayload : public jsonPayload_t {
+  public:
+    TM value;
+
+    inline jsonPayload() :
+      jsonPayload_t(kind()) {}
+
+    inline jsonPayload(const TM &value_) :
+      jsonPayload_t(kind()),
+      value(value_) {}
+
+    static kind_t kind();
+
+    virtual jsonPayload_t* clone() const {
+      return new jsonPayload<TM>(value);
+    }
+  };
+
+  template <>
+  inline jsonPayload_t::kind_t jsonPayload<std::string>::kind() {
+    return string_;
+  }
+
+  template <>
+  inline jsonPayload_t::kind_t jsonPayload<jsonArray>::kind() {
+    return array_;
+  }
+
+  template <>
+  inline jsonPayload_t::kind_t jsonPayload<jsonObject>::kind() {
+    return object_;
+  }
+  //====================================
+
+  //---[ jsonValue_t ]------------------
+  inline bool jsonValue_t::boolean() const {
+    return ((kind == boolean_)
+            ? booleanValue
+            : false);
+  }
+
+  inline const primitive& jsonValue_t::number() const {
+    static const primitive zero((int32_t) 0);
+    return ((kind == number_)
+            ? numberValue
+            : zero);
+  }
+
+  inline const std::string& jsonValue_t::string() const {
+    static const std::string empty;
+    return (((kind == payload_) && (payload->kind == jsonPayload_t::string_))
+            ? ((jsonPayload<std::string>*) payload)->value
+            : empty);
+  }
+
+  inline const jsonArray& jsonValue_t::array() const {
+    static const jsonArray empty;
+    return (((kind == payload_) && (payload->kind == jsonPayload_t::array_))
+            ? ((jsonPayload<jsonArray>*) payload)->value
+            : empty);
+  }
+
+  inline const jsonObject& jsonValue_t::object() const {
+    static const jsonObject empty;
+    return (((kind == payload_) && (payload->kind == jsonPayload_t::object_))
+            ? ((jsonPayload<jsonObject>*) payload)->value
+            : empty);
+  }
+
+  inline void jsonValue_t::setBoolean(const bool value) {
+    release();
+    kind = boolean_;
+    booleanValue = value;
+  }
+
+  inline void jsonValue_t::setNumber(const primitive &value) {
+    release();
+    kind = number_;
+    new (&numberValue) primitive(value);
+  }
+
+  template <class TM>
+  inline TM& jsonValue_t::write(const bool leak) {
+    if ((kind != payload_) || (payload->kind != jsonPayload<TM>::kind())) {
+      release();
+      kind = payload_;
+      payload = new jsonPayload<TM>();
+    } else if (payload->refs > 1) {
+      jsonPayload_t *copy = payload->clone();
+      release();
+      kind = payload_;
+      payload = copy;
+    }
+    // Unshared payloads are only written by their owner
+    payload->hashVersion = 0;
+    markWritten();
+    if (leak) {
+      payload->leaked = true;
+    }
+    return ((jsonPayload<TM>*) payload)->value;
+  }
+
+  inline std::string& jsonValue_t::writeString() {
+    return write<std::string>(false);
+  }
+
+  inline jsonArray& jsonValue_t::writeArray() {
+    return write<jsonArray>(false);
+  }
+
+  inline jsonObject& jsonValue_t::writeObject() {
+    return write<jsonObject>(false);
+  }
+
+  inline bool& jsonValue_t::leakBoolean() {
+    if (kind != boolean_) {
+      setBoolean(false);
+    } else {
+      markWritten();
+    }
+    return booleanValue;
+  }
+
+  inline primitive& jsonValue_t::leakNumber() {
+    if (kind != number_) {
+      setNumber((int32_t) 0);
+    } else {
+      markWritten();
+    }
+    return numberValue;
+  }
+
+  inline std::string& jsonValue_t::leakString() {
+    return write<std::string>(true);
+  }
+
+  inline jsonArray& jsonValue_t::leakArray() {
+    return write<jsonArray>(true);
+  }
+
+  inline jsonObject& jsonValue_t::leakObject() {
+    return write<jsonObject>(true);
+  }
+  //====================================
 }
 
 #include "json.tpp"
@@ -3,7 +3,7 @@ namespace occa {
   json& json::set(const char *key,
                   const TM &value) {
     type = object_;
-    value_.object[key] = value;
+    value_.writeObject()[key] = value;
     return *this;
   }
 
@@ -30,8 +30,9 @@ namespace occa {
         ++c;
       }
 
-      jsonObject::const_iterator it = j->value_.object.find(nextKey);
-      if (it == j->value_.object.end()) {
+      const jsonObject &object = j->value_.object();
+      jsonObject::const_iterator it = object.find(nextKey);
+      if (it == object.end()) {
         return default_;
       }
       j = &(it->second);
@@ -67,8 +68,9 @@ namespace occa {
         ++c;
       }
 
-      jsonObject::const_iterator it = j->value_.object.find(key);
-      if (it == j->value_.object.end()) {
+      const jsonObject &object = j->value_.object();
+      jsonObject::const_iterator it = object.find(key);
+      if (it == object.end()) {
         return default_;
       }
       j = &(it->second);
@@ -77,10 +79,11 @@ namespace occa {
       return default_;
     }
 
-    const int entries = (int) j->value_.array.size();
+    const jsonArray &array = j->value_.array();
+    const int entries = (int) array.size();
     std::vector<TM> ret;
     for (int i = 0; i < entries; ++i) {
-      ret.push_back((TM) j->value_.array[i]);
+      ret.push_back((TM) array[i]);
     }
     return ret;
   }
@@ -85,6 +85,9 @@ namespace occa {
     udim_t installedRAM();
     udim_t availableRAM();
 
+    strVector getCpuFeatures();
+    strVector getCpuIsas();
+
     int compilerVendor(const std::string &compiler);
 
     std::string compilerCpp11Flags(const std::string &compiler);
@@ -96,6 +99,9 @@ namespace occa {
     std::string compilerSharedBinaryFlags(const std::string &compiler);
     std::string compilerSharedBinaryFlags(const int vendor_);
 
+    std::string compilerIsaFlags(const int vendor_,
+                                 const std::string &isa);
+
     void addCompilerIncludeFlags(std::string &compilerFlags);
     void addCompilerLibraryFlags(std::string &compilerFlags);
 
@@ -1,11 +1,13 @@
 #ifndef OCCA_UVA_HEADER
 #define OCCA_UVA_HEADER
 
+#include <atomic>
 #include <iostream>
 #include <vector>
 
 #include <occa/defines.hpp>
 #include <occa/io/output.hpp>
+#include <occa/tools/sys.hpp>
 #include <occa/types.hpp>
 
 namespace occa {
@@ -13,11 +15,11 @@ namespace occa {
   class memory;
   class modeMemory_t;
   class ptrRange;
+  class uvaRegistry;
 
-  typedef std::map<ptrRange, occa::modeMemory_t*> ptrRangeMap;
-  typedef std::vector<occa::modeMemory_t*>        memoryVector;
+  typedef std::vector<occa::modeMemory_t*> memoryVector;
 
-  extern ptrRangeMap uvaMap;
+  extern uvaRegistry uvaMap;
   extern memoryVector uvaStaleMemory;
 
   //---[ ptrRange ]---------------------
@@ -42,6 +44,64 @@ namespace occa {
   //====================================
 
 
+  //---[ byteRangeSet ]----------------
+  // Disjoint [start, end) byte offsets, adjacent ranges are merged
+  class byteRangeSet {
+  public:
+    typedef std::pair<udim_t, udim_t> range_t;
+    typedef std::vector<range_t>      rangeVector;
+
+    rangeVector ranges;
+
+    void add(const udim_t start, const udim_t end);
+    void remove(const udim_t start, const udim_t end);
+    void clear();
+
+    bool isEmpty() const;
+    udim_t bytes() const;
+  };
+  //====================================
+
+
+  //---[ uvaRegistry ]------------------
+  // Maps pointers to the memory containing them
+  //
+  // Ranges are kept sorted by their start in a flat array.
+  // Writers are serialized by a mutex and bump the registry version.
+  // Readers first check a small per-thread cache of recent hits,
+  //   which stays valid until the registry changes, and only take
+  //   the lock to binary search on a miss.
+  class uvaRegistry {
+  private:
+    std::vector<ptrRange> ranges;
+    memoryVector memories;
+    mutable occa::mutex mutex_;
+    std::atomic<udim_t> version;
+
+  public:
+    uvaRegistry();
+    ~uvaRegistry();
+
+    // Replaces any registered ranges overlapping [range]
+    void insert(const ptrRange &range,
+                modeMemory_t *mem);
+
+    void erase(void *ptr);
+
+    modeMemory_t* find(const void *ptr) const;
+
+    size_t size() const;
+
+  private:
+    uvaRegistry(const uvaRegistry &other);
+    uvaRegistry& operator = (const uvaRegistry &other);
+
+    int findIndex(const char *ptr) const;
+    void updateVersion();
+  };
+  //====================================
+
+
   //---[ UVA ]--------------------------
   occa::modeMemory_t* uvaToMemory(void *ptr);
 
@@ -1,13 +1,299 @@
 #include <algorithm>
+#include <map>
 #include <sstream>
 
+#include <occa/io.hpp>
 #include <occa/types.hpp>
 #include <occa/array/linalg.hpp>
 #include <occa/tools/lex.hpp>
 
 namespace occa {
   namespace linalg {
+    //---[ Autotuning ]-----------------
+    launchBenchmark::launchBenchmark() :
+      outputIndex(-1),
+      outputEntryBytes(0),
+      tuningEntries(0) {}
+
+    void launchBenchmark::setOutput(occa::memory output_,
+                                    const dim_t entries,
+                                    const int outputEntryBytes_) {
+      outputIndex = (int) args.size();
+      outputEntryBytes = outputEntryBytes_;
+      tuningEntries = std::min(entries, (dim_t) maxTuningEntries);
+      output = output_;
+      args.push_back(output);
+    }
+
+    void launchBenchmark::run(occa::kernel kernel) {
+      if (output.isInitialized() && !scratchOutput.isInitialized()) {
+        scratchOutput = sliceEntries(output,
+                                     outputEntryBytes,
+                                     0,
+                                     tuningEntries).clone();
+        args[0] = tuningEntries;
+        args[outputIndex] = scratchOutput;
+      }
+
+      kernel.clearArgs();
+      const int argCount = (int) args.size();
+      for (int i = 0; i < argCount; ++i) {
+        kernel.pushArg(args[i]);
+      }
+      kernel.run();
+    }
+
+    const occa::json& tileSizeSpace() {
+      static occa::json space;
+      if (!space.isInitialized()) {
+        occa::json &tileSizes = space["TILESIZE"].asArray();
+        for (int i = 0; i < usedTileSizeCount; ++i) {
+          tileSizes += usedTileSizes[i];
+        }
+      }
+      return space;
+    }
+
+    static bool usingGpuReduction(occa::device dev) {
+      const std::string &mode = dev.mode();
+      return ((mode != "Serial") && (mode != "OpenMP"));
+    }
+
+    const occa::json& reductionSpace(occa::device dev) {
+      static const occa::json cpuSpace = occa::json::parse(
+        "{"
+        "  CPU_DOT_OUTER: [256, 1024, 4096],"
+        "}"
+      );
+      static const occa::json gpuSpace = occa::json::parse(
+        "{"
+        "  GPU_DOT_OUTER: [256, 1024, 4096],"
+        "  GPU_DOT_INNER: [64, 128, 256],"
+        "}"
+      );
+      return usingGpuReduction(dev) ? gpuSpace : cpuSpace;
+    }
+
+    int reductionBufferSize(occa::kernel kernel) {
+      const occa::properties &props = kernel.properties();
+      if (usingGpuReduction(kernel.getDevice())) {
+        return props.get("defines/GPU_DOT_OUTER", 1024);
+      }
+      return props.get("defines/CPU_DOT_OUTER", 1024);
+    }
+
+    //---[ Reduction Buffers ]----------
+    typedef std::map<modeStream_t*, occa::memory> streamBufferMap;
+
+    static mutex& reductionBufferMutex() {
+      static mutex mutex_;
+      return mutex_;
+    }
+
+    static occa::memory streamBuffer(streamBufferMap &buffers,
+                                     occa::device dev,
+                                     const udim_t bytes) {
+      mutex &mutex_ = reductionBufferMutex();
+      mutex_.lock();
+
+      // Freeing the device uninitializes the buffer
+      occa::memory &buffer = buffers[dev.getStream().getModeStream()];
+      if (!buffer.isInitialized() ||
+          (buffer.getModeDevice() != dev.getModeDevice()) ||
+          (buffer.size() < bytes)) {
+        buffer = dev.malloc(bytes);
+      }
+      occa::memory slice = buffer.slice(0, bytes);
+
+      mutex_.unlock();
+      return slice;
+    }
+
+    occa::memory streamReductionBuffer(occa::device dev,
+                                       const udim_t bytes) {
+      static streamBufferMap buffers;
+      return streamBuffer(buffers, dev, bytes);
+    }
+
+    occa::memory streamResultBuffer(occa::device dev,
+                                    const udim_t bytes) {
+      static streamBufferMap buffers;
+      return streamBuffer(buffers, dev, bytes);
+    }
+    //==================================
+
+    occa::kernel getTiledKernel(kernelBuilder &builder,
+                                occa::device dev,
+                                const int tileSize,
+                                launchBenchmark &benchmark,
+                                const dim_t entries) {
+      if (tileSize > 0) {
+        return getTiledKernel(builder, dev, tileSize);
+      }
+      return builder.autotune(dev,
+                              tileSizeSpace(),
+                              benchmark,
+                              std::min(entries, (dim_t) maxTuningEntries));
+    }
+
+    dim_t maxLaunchEntries(occa::kernel kernel) {
+      occa::device dev = kernel.getDevice();
+      const dim_t maxEntries = dev.properties().get<dim_t>("linalg/max_launch_entries", 0);
+      if (maxEntries > 0) {
+        return maxEntries;
+      }
+
+      // CUDA and HIP grids are limited to 2^31 - 1 blocks
+      const std::string &mode = dev.mode();
+      if ((mode == "CUDA") || (mode == "HIP")) {
+        const dim_t tileSize = kernel.properties().get("defines/TILESIZE", 128);
+        return tileSize * ((((dim_t) 1) << 31) - 1);
+      }
+      return 0;
+    }
+
+    occa::memory sliceEntries(occa::memory mem,
+                              const int entryBytes,
+                              const dim_t offset,
+                              const dim_t count) {
+      // Slices are in units of the memory's dtype
+      const dim_t dtypeBytes = mem.dtype().bytes();
+      return mem.slice((offset * entryBytes) / dtypeBytes,
+                       (count * entryBytes) / dtypeBytes);
+    }
+
+    void runTiledKernel(kernelBuilder &builder,
+                        const int tileSize,
+                        const dim_t entries,
+                        const kernelArg &arg,
+                        const int argEntryBytes,
+                        occa::memory out,
+                        const int outEntryBytes) {
+      launchBenchmark launch;
+      launch.args.push_back(entries);
+      launch.args.push_back(arg);
+      launch.setOutput(out, entries, outEntryBytes);
+
+      occa::kernel kernel = getTiledKernel(builder,
+                                           out.getDevice(),
+                                           tileSize,
+                                           launch,
+                                           entries);
+
+      dim_t chunkEntries = maxLaunchEntries(kernel);
+      if (!chunkEntries || (chunkEntries > entries)) {
+        kernel(entries, arg, out);
+        return;
+      }
+
+      occa::memory argMemory;
+      if (argEntryBytes) {
+        argMemory = occa::memory(arg[0].getModeMemory());
+      }
+      for (dim_t offset = 0; offset < entries; offset += chunkEntries) {
+        const dim_t count = std::min(chunkEntries, entries - offset);
+        occa::memory outChunk = sliceEntries(out, outEntryBytes, offset, count);
+        if (argMemory.isInitialized()) {
+          kernel(count,
+                 sliceEntries(argMemory, argEntryBytes, offset, count),
+                 outChunk);
+        } else {
+          kernel(count, arg, outChunk);
+        }
+      }
+    }
+    //==================================
+
     // "v0[i] = c1 * (v0[i] + v1[i]);"
+    //---[ Reduction Tuples ]-----------
+    int reductionTuple::sum(const std::string &formula) {
+      return add(sum_, formula);
+    }
+
+    int reductionTuple::min(const std::string &formula) {
+      return add(min_, formula);
+    }
+
+    int reductionTuple::max(const std::string &formula) {
+      return add(max_, formula);
+    }
+
+    int reductionTuple::add(const op_t op,
+                            const std::string &formula) {
+      OCCA_ERROR("Reduction formulas can't be empty",
+                 formula.size());
+      ops.push_back(op);
+      formulas.push_back(formula);
+      return (int) ops.size() - 1;
+    }
+
+    int reductionTuple::size() const {
+      return (int) ops.size();
+    }
+
+    std::string reductionTuple::toString() const {
+      std::stringstream ss;
+      const int count = size();
+      for (int i = 0; i < count; ++i) {
+        ss << (int) ops[i] << ':' << formulas[i] << '\n';
+      }
+      return ss.str();
+    }
+
+    std::string reductionTuple::kernelDefines() const {
+      const int count = size();
+      std::stringstream init, operation, redOperation, store;
+
+      for (int i = 0; i < count; ++i) {
+        // Formulas are spliced into single-line macros
+        std::string formula = formulas[i];
+        std::replace(formula.begin(), formula.end(), '\n', ' ');
+        const std::string term = "(" + formula + ")";
+        const std::string red = "red[" + occa::toString(i) + "]";
+        const std::string part = "part[" + occa::toString(i) + "]";
+
+        if (ops[i] == sum_) {
+          init << ' ' << red << " = 0;";
+          operation << " stat_term = " << term << "; "
+                    << red << " += stat_term;";
+          redOperation << ' ' << red << " += " << part << ';';
+        } else {
+          const char *cmp = (ops[i] == min_) ? " < " : " > ";
+          init << ' ' << red << " = " << term << ';';
+          operation << " stat_term = " << term << "; "
+                    << red << " = (" << red << cmp << "stat_term) ? "
+                    << red << " : stat_term;";
+          redOperation << ' ' << red << " = (" << red << cmp << part << ") ? "
+                       << red << " : " << part << ';';
+        }
+        store << " out[" << i << "] = " << red << ';';
+      }
+
+      std::stringstream ss;
+      ss << "#define STAT_COUNT " << count << '\n'
+         << "#define STATS_INIT(red) { const VTYPE v = vec[0];"
+         << init.str() << " }\n"
+         << "#define STATS_OPERATION(red, idx) { const VTYPE v = vec[idx]; RETTYPE stat_term;"
+         << operation.str() << " }\n"
+         << "#define STATS_RED_OPERATION(red, part)"
+         << redOperation.str() << '\n'
+         << "#define STATS_STORE(out, red) {"
+         << store.str() << " }\n";
+      return ss.str();
+    }
+
+    kernelBuilder makeReductionTupleBuilder(const reductionTuple &terms,
+                                            const occa::properties &props) {
+      OCCA_ERROR("Reduction tuples need at least one term",
+                 terms.size() > 0);
+      const std::string source = (
+        terms.kernelDefines()
+        + io::read(env::OCCA_DIR + "include/occa/array/kernels/linalg.okl")
+      );
+      return kernelBuilder::fromString(source, "stats", props);
+    }
+    //==================================
+
     kernelBuilder customLinearMethod(const std::string &kernelName,
                                      const std::string &formula,
                                      const occa::properties &props) {
@@ -86,8 +372,15 @@ namespace occa {
 
       std::stringstream ss;
 
+      // Match dim_t entries, see DIM_TYPE in kernels/linalg.okl
+      ss << "#if defined(OCCA_USING_OPENCL) || defined(OCCA_USING_METAL)\n"
+        "#  define DIM_TYPE long\n"
+        "#else\n"
+        "#  define DIM_TYPE long long\n"
+        "#endif\n\n";
+
       // Setup arguments
-      ss << "@kernel void " << kernelName << "(const int entries,\n";
+      ss << "@kernel void " << kernelName << "(const DIM_TYPE entries,\n";
       for (int i = 0; i < constantCount; ++i) {
         ss << "                  const CTYPE" << i << " c" << i;
         if ((i < (constantCount - 1)) || inputCount) {
@@ -104,12 +397,122 @@ namespace occa {
       }
       // Setup body
       ss << ") {\n"
-        "  for (int i = 0; i < entries; ++i; @tile(TILESIZE, @outer, @inner)) {\n"
+        "  for (DIM_TYPE i = 0; i < entries; ++i; @tile(TILESIZE, @outer, @inner)) {\n"
         "    " << formula << "\n"
         "  }\n"
         "}\n";
 
       return kernelBuilder::fromString(ss.str(), kernelName, props);
     }
+
+    int linearMethodArgs::addVector(occa::memory vec,
+                                    const int entryBytes,
+                                    const std::string &type) {
+      vectors.push_back(vec);
+      vectorBytes.push_back(entryBytes);
+      vectorTypes.push_back(type);
+      return (int) vectors.size() - 1;
+    }
+
+    int linearMethodArgs::addConstant(const kernelArg &value,
+                                      const std::string &type) {
+      constants.push_back(value);
+      constantTypes.push_back(type);
+      return (int) constants.size() - 1;
+    }
+
+    static kernelBuilder& linearMethodBuilder(const std::string &formula,
+                                              const linearMethodArgs &args) {
+      static std::map<std::string, kernelBuilder> builderMap;
+
+      const int vectorCount = (int) args.vectors.size();
+      const int constantCount = (int) args.constants.size();
+
+      std::stringstream ss;
+      ss << formula;
+      for (int i = 0; i < vectorCount; ++i) {
+        ss << "|v" << i << ':' << args.vectorTypes[i];
+      }
+      for (int i = 0; i < constantCount; ++i) {
+        ss << "|c" << i << ':' << args.constantTypes[i];
+      }
+
+      kernelBuilder &builder = builderMap[ss.str()];
+      if (builder.isInitialized()) {
+        return builder;
+      }
+
+      occa::properties props;
+      for (int i = 0; i < vectorCount; ++i) {
+        props["defines/VTYPE" + toString(i)] = args.vectorTypes[i];
+      }
+      for (int i = 0; i < constantCount; ++i) {
+        props["defines/CTYPE" + toString(i)] = args.constantTypes[i];
+      }
+      props["defines/TILESIZE"] = 128;
+      builder = customLinearMethod("linearMethod", formula, props);
+      return builder;
+    }
+
+    void runLinearMethod(const std::string &formula,
+                         const linearMethodArgs &args,
+                         const dim_t entries,
+                         const int tileSize) {
+      const int vectorCount = (int) args.vectors.size();
+      const int constantCount = (int) args.constants.size();
+
+      OCCA_ERROR("Linear methods need an output vector",
+                 vectorCount > 0);
+
+      occa::memory out = args.vectors[0];
+      occa::device dev = out.getDevice();
+      for (int i = 0; i < vectorCount; ++i) {
+        const occa::memory &vec = args.vectors[i];
+        OCCA_ERROR("Vectors must be in the same device",
+                   vec.getDevice() == dev);
+        OCCA_ERROR("Vector v" << i << " has less than " << entries << " entries",
+                   vec.size() >= (udim_t) (entries * args.vectorBytes[i]));
+      }
+
+      kernelBuilder &builder = linearMethodBuilder(formula, args);
+
+      launchBenchmark launch;
+      launch.args.push_back(entries);
+      for (int i = 0; i < constantCount; ++i) {
+        launch.args.push_back(args.constants[i]);
+      }
+      launch.setOutput(out, entries, args.vectorBytes[0]);
+      for (int i = 1; i < vectorCount; ++i) {
+        launch.args.push_back(args.vectors[i]);
+      }
+
+      occa::kernel kernel = getTiledKernel(builder,
+                                           dev,
+                                           tileSize,
+                                           launch,
+                                           entries);
+
+      dim_t chunkEntries = maxLaunchEntries(kernel);
+      if (!chunkEntries || (chunkEntries > entries)) {
+        chunkEntries = entries;
+      }
+      // Pushed arguments don't own their memory, keep the slices alive
+      //   until the launch
+      std::vector<occa::memory> chunks(vectorCount);
+      for (dim_t offset = 0; offset < entries; offset += chunkEntries) {
+        const dim_t count = std::min(chunkEntries, entries - offset);
+
+        kernel.clearArgs();
+        kernel.pushArg(count);
+        for (int i = 0; i < constantCount; ++i) {
+          kernel.pushArg(args.constants[i]);
+        }
+        for (int i = 0; i < vectorCount; ++i) {
+          chunks[i] = sliceEntries(args.vectors[i], args.vectorBytes[i], offset, count);
+          kernel.pushArg(chunks[i]);
+        }
+        kernel.run();
+      }
+    }
   }
 }
@@ -127,11 +127,8 @@ namespace occa {
               const dim_t bytes,
               const occa::properties &props) {
 
-    ptrRangeMap::iterator srcIt  = uvaMap.find(const_cast<void*>(src));
-    ptrRangeMap::iterator destIt = uvaMap.find(dest);
-
-    occa::modeMemory_t *srcMem  = ((srcIt  != uvaMap.end()) ? (srcIt->second)  : NULL);
-    occa::modeMemory_t *destMem = ((destIt != uvaMap.end()) ? (destIt->second) : NULL);
+    occa::modeMemory_t *srcMem  = uvaMap.find(src);
+    occa::modeMemory_t *destMem = uvaMap.find(dest);
 
     const udim_t srcOff  = (srcMem
                             ? (((char*) src)  - srcMem->uvaPtr)
@@ -159,15 +156,16 @@ namespace occa {
       return;
     }
 
+    const copyOptions options(props);
     if (usingSrcPtr) {
-      destMem->copyFrom(src, bytes, destOff, props);
+      destMem->copyFrom(src, bytes, destOff, options);
     } else if (usingDestPtr) {
-      srcMem->copyTo(dest, bytes, srcOff, props);
+      srcMem->copyTo(dest, bytes, srcOff, options);
     } else {
       // Auto-detects peer-to-peer stuff
       occa::memory srcMemory(srcMem);
       occa::memory destMemory(destMem);
-      destMemory.copyFrom(srcMemory, bytes, destOff, srcOff, props);
+      destMemory.copyFrom(srcMemory, bytes, destOff, srcOff, options);
     }
   }
 
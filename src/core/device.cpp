@@ -11,7 +11,9 @@ namespace occa {
     mode((std::string) properties_["mode"]),
     properties(properties_),
     needsLauncherKernel(false),
-    bytesAllocated(0) {}
+    bytesAllocated(0),
+    memoryPool(this, properties_),
+    scratchArena(properties_) {}
 
   modeDevice_t::~modeDevice_t() {
     // Null all wrappers
@@ -24,6 +26,10 @@ namespace occa {
 
   // Must be called before ~modeDevice_t()!
   void modeDevice_t::freeResources() {
+    // Scratch arenas may be released into the pool
+    scratchArena.free();
+    // Pooled blocks are still in the memory ring
+    memoryPool.clear();
     freeRing<modeKernel_t>(kernelRing);
     freeRing<modeMemory_t>(memoryRing);
     freeRing<modeStream_t>(streamRing);
@@ -95,8 +101,14 @@ namespace occa {
     infoProps["kernel/hash"]  = kernelHash.getFullString();
     infoProps["kernel/metadata"] = sourceMetadata.getKernelMetadataJson();
     infoProps["kernel/dependencies"] = sourceMetadata.getDependencyJson();
+    infoProps["kernel/macro_references"] = sourceMetadata.getMacroReferencesJson();
 
     io::writeBuildFile(filename, kernelHash, infoProps);
+
+    const std::string metadataFile = lang::sourceMetadata_t::metadataFilename(filename);
+    if (!io::isFile(metadataFile)) {
+      sourceMetadata.writeMetadataFile(metadataFile);
+    }
   }
 
   std::string modeDevice_t::getKernelHash(const std::string &fullHash,
@@ -305,6 +317,24 @@ namespace occa {
     return 0;
   }
 
+  udim_t device::memoryCached() const {
+    if (modeDevice) {
+      return modeDevice->memoryPool.stats().cachedBytes;
+    }
+    return 0;
+  }
+
+  const memoryPoolStats& device::poolStats() const {
+    assertInitialized();
+    return modeDevice->memoryPool.stats();
+  }
+
+  void device::trimMemoryPool(const udim_t bytes) {
+    if (modeDevice) {
+      modeDevice->memoryPool.trim(bytes);
+    }
+  }
+
   void device::finish() {
     if (!modeDevice) {
       return;
@@ -314,7 +344,7 @@ namespace occa {
       for (size_t i = 0; i < staleEntries; ++i) {
         occa::modeMemory_t *mem = uvaStaleMemory[i];
 
-        mem->copyTo(mem->uvaPtr, mem->size, 0, "async: true");
+        mem->syncDirtyToHost(copyOptions(true));
 
         mem->memInfo &= ~uvaFlag::inDevice;
         mem->memInfo &= ~uvaFlag::isStale;
@@ -325,6 +355,7 @@ namespace occa {
     }
 
     modeDevice->finish();
+    modeDevice->memoryPool.finish();
   }
 
   bool device::hasSeparateMemorySpace() {
@@ -369,41 +400,77 @@ namespace occa {
                                const hash_t &sourceHash,
                                occa::properties &kernelProps,
                                hash_t &kernelHash) const {
+    hash_t definesFreeHash;
+    setupKernelInfo(props, sourceHash,
+                    kernelProps, kernelHash, definesFreeHash);
+  }
+
+  void device::setupKernelInfo(const occa::properties &props,
+                               const hash_t &sourceHash,
+                               occa::properties &kernelProps,
+                               hash_t &kernelHash,
+                               hash_t &definesFreeHash) const {
     assertInitialized();
 
     kernelProps = kernelProperties(props);
 
-    kernelHash = (
+    definesFreeHash = (
       hash()
       ^ modeDevice->kernelHash(kernelProps)
-      ^ kernelHeaderHash(kernelProps)
+      ^ kernelHeaderHashWithoutDefines(kernelProps)
       ^ sourceHash
     );
 
+    // Specialized variants compile argument values into the kernel
+    const occa::properties &constKernelProps = kernelProps;
+    if (constKernelProps.has("okl/specialized_arguments")) {
+      definesFreeHash ^= occa::hash(constKernelProps["okl/specialized_arguments"]);
+    }
+
+    kernelHash = applyDefinesHash(definesFreeHash, kernelProps);
     kernelHash = applyDependencyHash(kernelHash);
   }
 
+  hash_t device::applyDefinesHash(const hash_t &definesFreeHash,
+                                  const occa::properties &kernelProps) const {
+    const json &defines = kernelProps["defines"];
+    const hash_t kernelHash = definesFreeHash ^ defines;
+
+    // Builds with the exact same defines don't need the index
+    if (io::cachedBuildFile(io::hashDir(kernelHash)).size()) {
+      return kernelHash;
+    }
+
+    // Reuse a build whose referenced defines match ours
+    const hash_t cachedKernelHash = io::findKernelWithDefines(definesFreeHash,
+                                                              defines);
+    if (cachedKernelHash.initialized) {
+      return cachedKernelHash;
+    }
+    return kernelHash;
+  }
+
   hash_t device::applyDependencyHash(const hash_t &kernelHash) const {
     // Check if the build.json exists to compare dependencies
-    const std::string buildFile = io::hashDir(kernelHash) + kc::buildFile;
-    if (!io::exists(buildFile)) {
+    const std::string buildFile = io::cachedBuildFile(io::hashDir(kernelHash));
+    if (!buildFile.size()) {
       return kernelHash;
     }
 
-    json buildJson = json::read(buildFile);
-    json dependenciesJson = buildJson["kernel/dependencies"];
-    if (!dependenciesJson.isInitialized()) {
+    const lang::strHashMap dependencyHashes = (
+      lang::sourceMetadata_t::fromBuildFile(buildFile).dependencyHashes
+    );
+    if (!dependencyHashes.size()) {
       return kernelHash;
     }
 
     hash_t newKernelHash = kernelHash;
     bool foundDependencyChanges = false;
 
-    jsonObject dependencyHashes = dependenciesJson.object();
-    jsonObject::iterator it = dependencyHashes.begin();
+    lang::strHashMap::const_iterator it = dependencyHashes.begin();
     while (it != dependencyHashes.end()) {
       const std::string &dependency = it->first;
-      const hash_t dependencyHash = hash_t::fromString(it->second);
+      const hash_t &dependencyHash = it->second;
 
       if (io::exists(dependency)) {
         // Check whether the dependency changed
@@ -432,10 +499,10 @@ namespace occa {
                              const std::string &kernelName,
                              const occa::properties &props) const {
     occa::properties allProps;
-    hash_t kernelHash;
+    hash_t kernelHash, definesFreeHash;
     const std::string realFilename = io::findInPaths(filename, env::OCCA_KERNEL_PATH);
     setupKernelInfo(props, hashFile(realFilename),
-                    allProps, kernelHash);
+                    allProps, kernelHash, definesFreeHash);
 
     // TODO: [#185] Fix kernel cache frees
     // // Check cache first
@@ -448,6 +515,8 @@ namespace occa {
     const std::string hashDir = io::hashDir(realFilename, kernelHash);
     allProps["hash"] = kernelHash.getFullString();
 
+    const bool isNewBuild = !io::cachedBuildFile(io::hashDir(kernelHash)).size();
+
     kernel cachedKernel = modeDevice->buildKernel(realFilename,
                                                   kernelName,
                                                   kernelHash,
@@ -455,6 +524,15 @@ namespace occa {
 
     if (cachedKernel.isInitialized()) {
       cachedKernel.modeKernel->hash = kernelHash;
+      cachedKernel.modeKernel->originFilename = realFilename;
+      cachedKernel.modeKernel->setupSpecialization();
+
+      // Record which defines the new build depends on
+      if (isNewBuild) {
+        io::registerKernelDefines(definesFreeHash,
+                                  kernelHash,
+                                  allProps["defines"]);
+      }
     } else {
       sys::rmrf(hashDir);
     }
@@ -570,9 +648,12 @@ namespace occa {
                << "negative bytes (" << bytes << ")",
                bytes >= 0);
 
-    occa::properties memProps = memoryProperties(props);
-
-    memory mem(modeDevice->malloc(bytes, src, memProps));
+    // Skip merging properties on the common no-props path
+    memory mem(
+      props.size()
+      ? modeDevice->memoryPool.malloc(bytes, src, memoryProperties(props))
+      : modeDevice->memoryPool.malloc(bytes, src, memoryProperties())
+    );
     mem.setDtype(dtype);
 
     modeDevice->bytesAllocated += bytes;
@@ -663,6 +744,27 @@ namespace occa {
                         const occa::properties &props) {
     return umalloc(entries, dtype, NULL, props);
   }
+
+  occa::memory device::scratch(const dim_t entries,
+                               const dtype_t &dtype) {
+    assertInitialized();
+
+    const dim_t bytes = entries * dtype.bytes();
+    OCCA_ERROR("Trying to allocate "
+               << "negative bytes (" << bytes << ")",
+               bytes >= 0);
+
+    memory mem = modeDevice->scratchArena.allocate(*this, bytes);
+    mem.setDtype(dtype);
+    return mem;
+  }
+
+  udim_t device::scratchCapacity() const {
+    if (modeDevice) {
+      return modeDevice->scratchArena.capacity();
+    }
+    return 0;
+  }
   //  |=================================
 
   template <>
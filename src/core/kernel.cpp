@@ -1,10 +1,14 @@
+#include <algorithm>
+
 #include <occa/core/device.hpp>
 #include <occa/core/kernel.hpp>
 #include <occa/core/memory.hpp>
 #include <occa/io.hpp>
 #include <occa/lang/builtins/types.hpp>
 #include <occa/lang/parser.hpp>
+#include <occa/lang/primitive.hpp>
 #include <occa/lang/transforms/builtins/finders.hpp>
+#include <occa/tools/exception.hpp>
 #include <occa/tools/sys.hpp>
 #include <occa/tools/uva.hpp>
 
@@ -22,6 +26,14 @@ namespace occa {
   }
 
   modeKernel_t::~modeKernel_t() {
+    // Specialized variants are owned by the generic kernel
+    std::map<std::string, modeKernel_t*>::iterator it = specializedKernels.begin();
+    while (it != specializedKernels.end()) {
+      delete it->second;
+      ++it;
+    }
+    specializedKernels.clear();
+
     // NULL all wrappers
     while (kernelRing.head) {
       kernel *k = (kernel*) kernelRing.head;
@@ -143,6 +155,165 @@ namespace occa {
       }
     }
   }
+
+  // Read the value of a const scalar argument as a literal
+  static bool getSpecializedValue(const lang::argMetadata_t &argInfo,
+                                  const kernelArgData &arg,
+                                  primitive &value) {
+    if (!argInfo.isConst || argInfo.isPtr
+        || arg.getModeMemory()
+        || ((int) arg.size != argInfo.dtype.bytes())) {
+      return false;
+    }
+
+    const dtype_t &type = argInfo.dtype;
+    const kernelArgData_t &data = arg.data;
+    if ((type == dtype::char_) || (type == dtype::int8)) {
+      value = data.int8_;
+    } else if (type == dtype::uint8) {
+      value = data.uint8_;
+    } else if ((type == dtype::short_) || (type == dtype::int16)) {
+      value = data.int16_;
+    } else if (type == dtype::uint16) {
+      value = data.uint16_;
+    } else if ((type == dtype::int_) || (type == dtype::int32)) {
+      value = data.int32_;
+    } else if (type == dtype::uint32) {
+      value = data.uint32_;
+    } else if ((type == dtype::long_) || (type == dtype::int64)) {
+      value = data.int64_;
+    } else if (type == dtype::uint64) {
+      value = data.uint64_;
+    } else if (type == dtype::float_) {
+      value = data.float_;
+    } else if (type == dtype::double_) {
+      value = data.double_;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  void modeKernel_t::setupSpecialization() {
+    specializedArgs.clear();
+
+    const json &specializedNames = properties["specialize"];
+    if (!specializedNames.isArray()) {
+      return;
+    }
+
+    // Only OKL kernels know their argument names
+    const lang::kernelMetadata_t &kernelMetadata = getMetadata();
+    if (!kernelMetadata.isInitialized()) {
+      return;
+    }
+    const std::vector<lang::argMetadata_t> &argInfos = kernelMetadata.arguments;
+    const int argc = (int) argInfos.size();
+
+    const jsonArray &names = specializedNames.array();
+    const int nameCount = (int) names.size();
+    for (int i = 0; i < nameCount; ++i) {
+      if (!names[i].isString()) {
+        continue;
+      }
+      const std::string &argName = names[i].string();
+      for (int ai = 0; ai < argc; ++ai) {
+        if (argInfos[ai].name == argName) {
+          specializedArgs.push_back(ai);
+          break;
+        }
+      }
+    }
+  }
+
+  modeKernel_t* modeKernel_t::getSpecializedKernel() {
+    if (specializedArgs.empty()) {
+      return this;
+    }
+
+    const std::vector<lang::argMetadata_t> &argInfos = getMetadata().arguments;
+    const int argc = (int) arguments.size();
+
+    json values(json::object_);
+    std::string valuesKey;
+
+    const int specializedCount = (int) specializedArgs.size();
+    for (int i = 0; i < specializedCount; ++i) {
+      const int ai = specializedArgs[i];
+      primitive value;
+      if ((ai < argc)
+          && getSpecializedValue(argInfos[ai], arguments[ai], value)) {
+        const std::string &argName = argInfos[ai].name;
+        values[argName] = value;
+        valuesKey += argName;
+        valuesKey += '=';
+        valuesKey += value.toString();
+        valuesKey += ';';
+      }
+    }
+    if (!valuesKey.size()) {
+      return this;
+    }
+
+    modeKernel_t *variant = NULL;
+    std::map<std::string, modeKernel_t*>::iterator it = specializedKernels.find(valuesKey);
+    if (it != specializedKernels.end()) {
+      variant = it->second;
+    } else if ((int) specializedKernels.size() < properties.get("max_specializations", 8)) {
+      // Failed builds are kept as NULL to avoid rebuilding them
+      variant = buildSpecializedKernel(values);
+      specializedKernels[valuesKey] = variant;
+    }
+
+    // Fall back to the generic kernel
+    if (!variant) {
+      return this;
+    }
+
+    variant->arguments = arguments;
+    variant->outerDims = outerDims;
+    variant->innerDims = innerDims;
+    return variant;
+  }
+
+  modeKernel_t* modeKernel_t::buildSpecializedKernel(const json &values) {
+    if (!originFilename.size()) {
+      return NULL;
+    }
+
+    occa::properties variantProps = properties;
+    variantProps.remove("specialize");
+    variantProps["okl/specialized_arguments"] = values;
+
+    if (properties.get("verbose", false)) {
+      io::stdout << "Specializing [" << name << "] for " << values << '\n';
+    }
+
+    occa::device device(modeDevice);
+    occa::kernel variant;
+    try {
+      if (io::isCached(originFilename)) {
+        // Sources from strings already live in the generic kernel's cache directory
+        variant = device.buildKernelFromString(io::read(originFilename),
+                                               name,
+                                               variantProps);
+      } else {
+        variant = device.buildKernel(originFilename,
+                                     name,
+                                     variantProps);
+      }
+    } catch (occa::exception &exc) {
+      return NULL;
+    }
+
+    modeKernel_t *variantKernel = variant.getModeKernel();
+    if (variantKernel) {
+      // The variant lives as long as this kernel
+      variant.dontUseRefs();
+      modeDevice->removeKernelRef(variantKernel);
+    }
+    return variantKernel;
+  }
   //====================================
 
   //---[ kernel ]-----------------------
@@ -306,8 +477,9 @@ namespace occa {
   void kernel::run() const {
     assertInitialized();
 
-    modeKernel->setupRun();
-    modeKernel->run();
+    modeKernel_t *runKernel = modeKernel->getSpecializedKernel();
+    runKernel->setupRun();
+    runKernel->run();
   }
 
 #include "kernelOperators.cpp"
@@ -330,7 +502,13 @@ namespace occa {
   hash_t kernelHeaderHash(const occa::properties &props) {
     return (
       occa::hash(props["defines"])
-      ^ props["includes"]
+      ^ kernelHeaderHashWithoutDefines(props)
+    );
+  }
+
+  hash_t kernelHeaderHashWithoutDefines(const occa::properties &props) {
+    return (
+      occa::hash(props["includes"])
       ^ props["headers"]
     );
   }
@@ -59,18 +59,35 @@ namespace occa {
   }
 
   void kernelArgData::setupForKernelCall(const bool isConst) const {
-    if (!modeMemory              ||
-        !modeMemory->isManaged() ||
-        !modeMemory->modeDevice->hasSeparateMemorySpace()) {
+    if (!modeMemory) {
       return;
     }
-    if (!modeMemory->inDevice()) {
-      modeMemory->copyFrom(modeMemory->uvaPtr, modeMemory->size);
-      modeMemory->memInfo |= uvaFlag::inDevice;
+    // Slices of managed memory mark their range in the origin
+    modeMemory_t *uvaMemory = modeMemory;
+    udim_t offset = 0;
+    if (!modeMemory->isOrigin && modeMemory->uvaPtr) {
+      modeMemory_t *origin = uvaMap.find(modeMemory->uvaPtr);
+      if (origin && origin->uvaPtr) {
+        uvaMemory = origin;
+        offset = modeMemory->uvaPtr - origin->uvaPtr;
+      }
+    }
+
+    if (!uvaMemory->isManaged() ||
+        !uvaMemory->modeDevice->hasSeparateMemorySpace()) {
+      return;
     }
-    if (!isConst && !modeMemory->isStale()) {
-      uvaStaleMemory.push_back(modeMemory);
-      modeMemory->memInfo |= uvaFlag::isStale;
+    if (!uvaMemory->inDevice()) {
+      uvaMemory->copyFrom(uvaMemory->uvaPtr, uvaMemory->size);
+      uvaMemory->memInfo |= uvaFlag::inDevice;
+    }
+    if (isConst) {
+      return;
+    }
+    uvaMemory->dirtyRanges.add(offset, offset + modeMemory->size);
+    if (!uvaMemory->isStale()) {
+      uvaStaleMemory.push_back(uvaMemory);
+      uvaMemory->memInfo |= uvaFlag::isStale;
     }
   }
 
@@ -224,10 +241,7 @@ namespace occa {
     if (argIsUva) {
       modeMemory = (modeMemory_t*) arg;
     } else if (lookAtUva) {
-      ptrRangeMap::iterator it = uvaMap.find(arg);
-      if (it != uvaMap.end()) {
-        modeMemory = it->second;
-      }
+      modeMemory = uvaMap.find(arg);
     }
 
     if (modeMemory) {
@@ -1,11 +1,20 @@
 #include <occa/core/device.hpp>
 #include <occa/core/kernelBuilder.hpp>
 #include <occa/core/scope.hpp>
+#include <occa/core/streamTag.hpp>
+#include <occa/io/cache.hpp>
+#include <occa/io/utils.hpp>
+#include <occa/tools/exception.hpp>
 #include <occa/tools/json.hpp>
 #include <occa/tools/lex.hpp>
 #include <occa/tools/string.hpp>
 
 namespace occa {
+  //---[ kernelBenchmark ]--------------
+  kernelBenchmark::~kernelBenchmark() {}
+  //====================================
+
+
   //---[ kernelBuilder ]----------------
   kernelBuilder::kernelBuilder() {}
 
@@ -14,14 +23,18 @@ namespace occa {
     function_(k.function_),
     defaultProps(k.defaultProps),
     kernelMap(k.kernelMap),
-    buildingFromFile(k.buildingFromFile) {}
+    autotunedKernelMap(k.autotunedKernelMap),
+    buildingFromFile(k.buildingFromFile),
+    tuningSourceHash(k.tuningSourceHash) {}
 
   kernelBuilder& kernelBuilder::operator = (const kernelBuilder &k) {
     source_      = k.source_;
     function_    = k.function_;
     defaultProps = k.defaultProps;
     kernelMap    = k.kernelMap;
+    autotunedKernelMap = k.autotunedKernelMap;
     buildingFromFile = k.buildingFromFile;
+    tuningSourceHash = k.tuningSourceHash;
     return *this;
   }
 
@@ -91,6 +104,141 @@ namespace occa {
     return build(device, hash(device));
   }
 
+  // Buckets grow by powers of 16 to keep the number of tuning runs low
+  static int problemSizeBucket(udim_t problemSize) {
+    int bucket = 0;
+    while (problemSize >= 16) {
+      problemSize >>= 4;
+      ++bucket;
+    }
+    return bucket;
+  }
+
+  occa::kernel kernelBuilder::autotune(occa::device device,
+                                       const occa::json &paramSpace,
+                                       kernelBenchmark &benchmark,
+                                       const udim_t problemSize) {
+    occa::kernel &tunedKernel = autotunedKernelMap[
+      hash(device) ^ occa::hash(problemSizeBucket(problemSize))
+    ];
+    if (tunedKernel.isInitialized()) {
+      return tunedKernel;
+    }
+
+    const hash_t tuningHash = (
+      hash(device)
+      ^ getTuningSourceHash()
+      ^ occa::hash(paramSpace)
+      ^ occa::hash(problemSizeBucket(problemSize))
+    );
+
+    // Use the winner picked by a previous run
+    const occa::json tunedProps = io::findAutotunedProperties(tuningHash);
+    if (tunedProps.isObject()) {
+      tunedKernel = build(device, occa::properties(tunedProps));
+      if (tunedKernel.isInitialized()) {
+        return tunedKernel;
+      }
+    }
+
+    strVector names;
+    std::vector<const jsonArray*> spaces;
+    if (paramSpace.isObject()) {
+      const jsonObject &params = paramSpace.object();
+      jsonObject::const_iterator it = params.begin();
+      while (it != params.end()) {
+        if (it->second.isArray() && it->second.array().size()) {
+          names.push_back(it->first);
+          spaces.push_back(&(it->second.array()));
+        }
+        ++it;
+      }
+    }
+    const int paramCount = (int) names.size();
+    if (!paramCount) {
+      tunedKernel = build(device);
+      return tunedKernel;
+    }
+
+    const bool verbose = defaultProps.get("verbose", false);
+    const int iterations = defaultProps.get("autotune/iterations", 3);
+
+    occa::properties bestProps;
+    double bestTime = -1;
+
+    std::vector<int> indices(paramCount, 0);
+    while (true) {
+      occa::properties candidateProps;
+      json &defines = candidateProps["defines"].asObject();
+      for (int i = 0; i < paramCount; ++i) {
+        defines[names[i]] = (*(spaces[i]))[indices[i]];
+      }
+
+      // Skip variants that fail to build
+      occa::kernel kernel;
+      try {
+        kernel = build(device, candidateProps);
+      } catch (occa::exception &exc) {}
+
+      if (kernel.isInitialized()) {
+        // Warm up before timing
+        benchmark.run(kernel);
+        device.finish();
+
+        occa::streamTag start = device.tagStream();
+        for (int i = 0; i < iterations; ++i) {
+          benchmark.run(kernel);
+        }
+        occa::streamTag end = device.tagStream();
+        device.finish();
+
+        const double time = device.timeBetween(start, end);
+        if (verbose) {
+          io::stdout << "Autotuning [" << function_ << "] with "
+                     << defines << ": " << time << "s\n";
+        }
+        if ((bestTime < 0) || (time < bestTime)) {
+          bestTime = time;
+          bestProps = candidateProps;
+          tunedKernel = kernel;
+        }
+      }
+
+      // Move to the next combination
+      int i = 0;
+      for (; i < paramCount; ++i) {
+        if (++indices[i] < (int) spaces[i]->size()) {
+          break;
+        }
+        indices[i] = 0;
+      }
+      if (i == paramCount) {
+        break;
+      }
+    }
+
+    OCCA_ERROR("Unable to build any variant of [" << function_ << "] to autotune",
+               tunedKernel.isInitialized());
+
+    io::storeAutotunedProperties(tuningHash, bestProps, bestTime);
+
+    return tunedKernel;
+  }
+
+  const hash_t& kernelBuilder::getTuningSourceHash() {
+    // Avoid reading the source file on every autotune call
+    if (!tuningSourceHash.isInitialized()) {
+      tuningSourceHash = (
+        (buildingFromFile
+         ? occa::hashFile(source_)
+         : occa::hash(source_))
+        ^ occa::hash(function_)
+        ^ occa::hash(defaultProps)
+      );
+    }
+    return tuningSourceHash;
+  }
+
   void kernelBuilder::run(occa::scope &scope) {
     occa::kernel kernel = build(scope.getDevice(),
                                 scope.props);
@@ -117,6 +265,7 @@ namespace occa {
       ++it;
     }
     kernelMap.clear();
+    autotunedKernelMap.clear();
   }
   //====================================
 
@@ -94,16 +94,31 @@ namespace occa {
     const std::string hashDir = io::hashDir(filename, kernelHash);
     const std::string binaryFilename = hashDir + kc::binaryFile;
 
+    strVector metadataFiles;
+    metadataFiles.push_back(kc::buildFile);
+    metadataFiles.push_back(kc::launcherBuildFile);
+    metadataFiles.push_back(kc::buildMetadataFile);
+    metadataFiles.push_back(kc::launcherBuildMetadataFile);
+
     // Check if binary exists and is finished
-    bool foundBinary = (
-      io::cachedFileIsComplete(hashDir, kc::binaryFile)
-      && io::isFile(binaryFilename)
-    );
+    std::string cachedDir = io::findCachedFile(hashDir,
+                                               kc::binaryFile,
+                                               metadataFiles);
+    bool foundBinary = cachedDir.size();
 
     io::lock_t lock;
     if (!foundBinary) {
       lock = io::lock_t(kernelHash, "build-kernel");
       foundBinary = !lock.isMine();
+      if (foundBinary) {
+        // Another process built the binary
+        cachedDir = io::findCachedFile(hashDir,
+                                       kc::binaryFile,
+                                       metadataFiles);
+      }
+      if (!cachedDir.size()) {
+        cachedDir = hashDir;
+      }
     }
 
     const bool verbose = kernelProps.get("verbose", false);
@@ -113,24 +128,24 @@ namespace occa {
                    << kernelName
                    << "] from ["
                    << io::shortname(filename)
-                   << "] in [" << io::shortname(binaryFilename) << "]\n";
+                   << "] in [" << io::shortname(cachedDir + kc::binaryFile) << "]\n";
       }
       if (usingOkl) {
         lang::sourceMetadata_t launcherMetadata = (
-          lang::sourceMetadata_t::fromBuildFile(hashDir + kc::launcherBuildFile)
+          lang::sourceMetadata_t::fromBuildFile(cachedDir + kc::launcherBuildFile)
         );
         lang::sourceMetadata_t deviceMetadata = (
-          lang::sourceMetadata_t::fromBuildFile(hashDir + kc::buildFile)
+          lang::sourceMetadata_t::fromBuildFile(cachedDir + kc::buildFile)
         );
         return buildOKLKernelFromBinary(kernelHash,
-                                        hashDir,
+                                        cachedDir,
                                         kernelName,
                                         launcherMetadata,
                                         deviceMetadata,
                                         kernelProps,
                                         lock);
       } else {
-        return buildKernelFromBinary(binaryFilename,
+        return buildKernelFromBinary(cachedDir + kc::binaryFile,
                                      kernelName,
                                      kernelProps);
       }
@@ -201,6 +216,7 @@ namespace occa {
 
     if (k) {
       io::markCachedFileComplete(hashDir, kc::binaryFile);
+      io::storeCachedFile(hashDir, kc::binaryFile, metadataFiles);
     }
     return k;
   }
@@ -8,6 +8,52 @@
 #include <occa/tools/sys.hpp>
 
 namespace occa {
+  //---[ copyOptions ]------------------
+  copyOptions::copyOptions() :
+    async(false),
+    stream(NULL) {}
+
+  copyOptions::copyOptions(const bool async_) :
+    async(async_),
+    stream(NULL) {}
+
+  copyOptions::copyOptions(const bool async_,
+                           const occa::stream &stream_) :
+    async(async_),
+    stream(stream_.getModeStream()) {}
+
+  copyOptions::copyOptions(const occa::properties &props) :
+    async(props.get("async", false)),
+    stream(NULL) {}
+
+  // Backends copy on the device's current stream
+  class copyStreamScope {
+  private:
+    modeDevice_t *modeDevice;
+    stream previousStream;
+    bool swapped;
+
+  public:
+    copyStreamScope(modeDevice_t *modeDevice_,
+                    const copyOptions &options) :
+      modeDevice(modeDevice_),
+      swapped(false) {
+      if (options.stream
+          && (options.stream != modeDevice->currentStream.getModeStream())) {
+        previousStream = modeDevice->currentStream;
+        modeDevice->currentStream = stream(options.stream);
+        swapped = true;
+      }
+    }
+
+    ~copyStreamScope() {
+      if (swapped) {
+        modeDevice->currentStream = previousStream;
+      }
+    }
+  };
+  //====================================
+
   //---[ modeMemory_t ]-----------------
   modeMemory_t::modeMemory_t(modeDevice_t *modeDevice_,
                              udim_t size_,
@@ -19,17 +65,14 @@ namespace occa {
     modeDevice(modeDevice_),
     dtype_(&dtype::byte),
     size(size_),
-    isOrigin(true) {
+    isOrigin(true),
+    poolSize(0) {
     modeDevice->addMemoryRef(this);
   }
 
   modeMemory_t::~modeMemory_t() {
-    // NULL all wrappers
-    while (memoryRing.head) {
-      memory *mem = (memory*) memoryRing.head;
-      memoryRing.removeRef(mem);
-      mem->modeMemory = NULL;
-    }
+    removeAllMemoryRefs();
+    freeOffsetMemory();
     // Remove ref from device
     if (modeDevice) {
       modeDevice->removeMemoryRef(this);
@@ -40,6 +83,33 @@ namespace occa {
     return ptr;
   }
 
+  const int modeMemory_t::maxOffsetMemory;
+
+  kernelArg modeMemory_t::makeOffsetKernelArg(const udim_t offset) {
+    if (!offset) {
+      return makeKernelArg();
+    }
+    memory *&mem = offsetMemory[offset];
+    if (!mem) {
+      if ((int) offsetMemoryOrder.size() >= maxOffsetMemory) {
+        // Launches retain the backend memory they were queued with,
+        //   the oldest offset is only needed again by new arguments
+        std::map<udim_t, memory*>::iterator it = offsetMemory.find(offsetMemoryOrder.front());
+        delete it->second;
+        offsetMemory.erase(it);
+        offsetMemoryOrder.pop_front();
+      }
+      offsetMemoryOrder.push_back(offset);
+
+      mem = new memory(addOffset(offset));
+      mem->modeMemory->isOrigin = false;
+      // The base memory owns its offset memory, keep it out of the device
+      //   ring so freeResources() doesn't delete it a second time
+      modeDevice->removeMemoryRef(mem->modeMemory);
+    }
+    return mem->modeMemory->makeKernelArg();
+  }
+
   void modeMemory_t::dontUseRefs() {
     memoryRing.dontUseRefs();
   }
@@ -52,10 +122,35 @@ namespace occa {
     memoryRing.removeRef(mem);
   }
 
+  void modeMemory_t::removeAllMemoryRefs() {
+    // NULL all wrappers
+    while (memoryRing.head) {
+      memory *mem = (memory*) memoryRing.head;
+      memoryRing.removeRef(mem);
+      mem->modeMemory = NULL;
+    }
+    memoryRing.clear();
+  }
+
+  void modeMemory_t::freeOffsetMemory() {
+    std::map<udim_t, memory*>::iterator it = offsetMemory.begin();
+    while (it != offsetMemory.end()) {
+      // Offset memory isn't in the device ring, it's only freed here
+      delete it->second;
+      ++it;
+    }
+    offsetMemory.clear();
+    offsetMemoryOrder.clear();
+  }
+
   bool modeMemory_t::needsFree() const {
     return memoryRing.needsFree();
   }
 
+  bool modeMemory_t::isPooled() const {
+    return poolSize;
+  }
+
   bool modeMemory_t::isManaged() const {
     return (memInfo & uvaFlag::isManaged);
   }
@@ -67,6 +162,22 @@ namespace occa {
   bool modeMemory_t::isStale() const {
     return (memInfo & uvaFlag::isStale);
   }
+
+  void modeMemory_t::syncDirtyToHost(const copyOptions &options) {
+    if (dirtyRanges.isEmpty()) {
+      copyTo(uvaPtr, size, 0, options);
+      return;
+    }
+    const int rangeCount = (int) dirtyRanges.ranges.size();
+    for (int i = 0; i < rangeCount; ++i) {
+      const byteRangeSet::range_t &range = dirtyRanges.ranges[i];
+      copyTo(uvaPtr + range.first,
+             range.second - range.first,
+             range.first,
+             options);
+    }
+    dirtyRanges.clear();
+  }
   //====================================
 
 
@@ -76,9 +187,9 @@ namespace occa {
 
   memory::memory(void *uvaPtr) :
       modeMemory(NULL) {
-    ptrRangeMap::iterator it = uvaMap.find(uvaPtr);
-    if (it != uvaMap.end()) {
-      setModeMemory(it->second);
+    modeMemory_t *modeMemory_ = uvaMap.find(uvaPtr);
+    if (modeMemory_) {
+      setModeMemory(modeMemory_);
     } else {
       setModeMemory((modeMemory_t*) uvaPtr);
     }
@@ -262,12 +373,12 @@ namespace occa {
     range.start = modeMemory->uvaPtr;
     range.end   = (range.start + modeMemory->size);
 
-    uvaMap[range] = modeMemory;
-    modeMemory->modeDevice->uvaMap[range] = modeMemory;
+    uvaMap.insert(range, modeMemory);
+    modeMemory->modeDevice->uvaMap.insert(range, modeMemory);
 
     // Needed for kernelArg.void_ -> modeMemory checks
     if (modeMemory->uvaPtr != modeMemory->ptr) {
-      uvaMap[modeMemory->ptr] = modeMemory;
+      uvaMap.insert(modeMemory->ptr, modeMemory);
     }
   }
 
@@ -306,12 +417,16 @@ namespace occa {
       return;
     }
 
-    copyFrom(modeMemory->uvaPtr, bytes_, offset);
+    copyFrom(modeMemory->uvaPtr + offset, bytes_, offset);
 
-    modeMemory->memInfo |=  uvaFlag::inDevice;
-    modeMemory->memInfo &= ~uvaFlag::isStale;
+    modeMemory->memInfo |= uvaFlag::inDevice;
 
-    removeFromStaleMap(modeMemory);
+    // Device writes outside of the synced range are still pending
+    modeMemory->dirtyRanges.remove(offset, offset + bytes_);
+    if (modeMemory->dirtyRanges.isEmpty()) {
+      modeMemory->memInfo &= ~uvaFlag::isStale;
+      removeFromStaleMap(modeMemory);
+    }
   }
 
   void memory::syncToHost(const dim_t bytes,
@@ -337,12 +452,20 @@ namespace occa {
       return;
     }
 
-    copyTo(modeMemory->uvaPtr, bytes_, offset);
-
-    modeMemory->memInfo &= ~uvaFlag::inDevice;
-    modeMemory->memInfo &= ~uvaFlag::isStale;
+    // Only copy what kernels wrote when syncing the whole buffer
+    if ((bytes == -1) && modeMemory->isStale()) {
+      modeMemory->syncDirtyToHost();
+    } else {
+      copyTo(modeMemory->uvaPtr + offset, bytes_, offset);
+      modeMemory->dirtyRanges.remove(offset, offset + bytes_);
+    }
 
-    removeFromStaleMap(modeMemory);
+    // Keep the device copy while it still has unsynced writes
+    if (modeMemory->dirtyRanges.isEmpty()) {
+      modeMemory->memInfo &= ~uvaFlag::inDevice;
+      modeMemory->memInfo &= ~uvaFlag::isStale;
+      removeFromStaleMap(modeMemory);
+    }
   }
 
   bool memory::uvaIsStale() const {
@@ -358,6 +481,7 @@ namespace occa {
   void memory::uvaMarkFresh() {
     if (modeMemory != NULL) {
       modeMemory->memInfo &= ~uvaFlag::isStale;
+      modeMemory->dirtyRanges.clear();
     }
   }
 
@@ -416,6 +540,36 @@ namespace occa {
                         const dim_t bytes,
                         const dim_t offset,
                         const occa::properties &props) {
+    copyFrom(src, bytes, offset, copyOptions(props));
+  }
+
+  void memory::copyFrom(const memory src,
+                        const dim_t bytes,
+                        const dim_t destOffset,
+                        const dim_t srcOffset,
+                        const occa::properties &props) {
+    copyFrom(src, bytes, destOffset, srcOffset, copyOptions(props));
+  }
+
+  void memory::copyTo(void *dest,
+                      const dim_t bytes,
+                      const dim_t offset,
+                      const occa::properties &props) const {
+    copyTo(dest, bytes, offset, copyOptions(props));
+  }
+
+  void memory::copyTo(const memory dest,
+                      const dim_t bytes,
+                      const dim_t destOffset,
+                      const dim_t srcOffset,
+                      const occa::properties &props) const {
+    copyTo(dest, bytes, destOffset, srcOffset, copyOptions(props));
+  }
+
+  void memory::copyFrom(const void *src,
+                        const dim_t bytes,
+                        const dim_t offset,
+                        const copyOptions &options) {
     assertInitialized();
 
     udim_t bytes_ = ((bytes == -1) ? modeMemory->size : bytes);
@@ -430,14 +584,15 @@ namespace occa {
                << " trying to access [" << offset << ", " << (offset + bytes_) << "]",
                (bytes_ + offset) <= modeMemory->size);
 
-    modeMemory->copyFrom(src, bytes_, offset, props);
+    copyStreamScope streamScope(modeMemory->modeDevice, options);
+    modeMemory->copyFrom(src, bytes_, offset, options);
   }
 
   void memory::copyFrom(const memory src,
                         const dim_t bytes,
                         const dim_t destOffset,
                         const dim_t srcOffset,
-                        const occa::properties &props) {
+                        const copyOptions &options) {
     assertInitialized();
 
     udim_t bytes_ = ((bytes == -1) ? modeMemory->size : bytes);
@@ -459,13 +614,14 @@ namespace occa {
                << " trying to access [" << destOffset << ", " << (destOffset + bytes_) << "]",
                (bytes_ + destOffset) <= modeMemory->size);
 
-    modeMemory->copyFrom(src.modeMemory, bytes_, destOffset, srcOffset, props);
+    copyStreamScope streamScope(modeMemory->modeDevice, options);
+    modeMemory->copyFrom(src.modeMemory, bytes_, destOffset, srcOffset, options);
   }
 
   void memory::copyTo(void *dest,
                       const dim_t bytes,
                       const dim_t offset,
-                      const occa::properties &props) const {
+                      const copyOptions &options) const {
     assertInitialized();
 
     udim_t bytes_ = ((bytes == -1) ? modeMemory->size : bytes);
@@ -480,14 +636,15 @@ namespace occa {
                << " trying to access [" << offset << ", " << (offset + bytes_) << "]",
                (bytes_ + offset) <= modeMemory->size);
 
-    modeMemory->copyTo(dest, bytes_, offset, props);
+    copyStreamScope streamScope(modeMemory->modeDevice, options);
+    modeMemory->copyTo(dest, bytes_, offset, options);
   }
 
   void memory::copyTo(memory dest,
                       const dim_t bytes,
                       const dim_t destOffset,
                       const dim_t srcOffset,
-                      const occa::properties &props) const {
+                      const copyOptions &options) const {
     assertInitialized();
 
     udim_t bytes_ = ((bytes == -1) ? modeMemory->size : bytes);
@@ -509,7 +666,8 @@ namespace occa {
                << " trying to access [" << destOffset << ", " << (destOffset + bytes_) << "]",
                (bytes_ + destOffset) <= dest.modeMemory->size);
 
-    dest.modeMemory->copyFrom(modeMemory, bytes_, destOffset, srcOffset, props);
+    copyStreamScope streamScope(modeMemory->modeDevice, options);
+    dest.modeMemory->copyFrom(modeMemory, bytes_, destOffset, srcOffset, options);
   }
 
   void memory::copyFrom(const void *src,
@@ -532,6 +690,26 @@ namespace occa {
     copyTo(dest, -1, 0, 0, props);
   }
 
+  void memory::copyFrom(const void *src,
+                        const copyOptions &options) {
+    copyFrom(src, -1, 0, options);
+  }
+
+  void memory::copyFrom(const memory src,
+                        const copyOptions &options) {
+    copyFrom(src, -1, 0, 0, options);
+  }
+
+  void memory::copyTo(void *dest,
+                      const copyOptions &options) const {
+    copyTo(dest, -1, 0, options);
+  }
+
+  void memory::copyTo(const memory dest,
+                      const copyOptions &options) const {
+    copyTo(dest, -1, 0, 0, options);
+  }
+
   occa::memory memory::as(const dtype_t &dtype_) const {
     occa::memory mem = slice(0);
     mem.setDtype(dtype_);
@@ -584,6 +762,13 @@ namespace occa {
 
       if (!freeMemory) {
         modeMemory->detach();
+      } else if (modeMemory->isPooled()) {
+        removeFromStaleMap(modeMemory);
+        // The pool NULLs all wrappers and keeps the backend allocation
+        if (modeDevice->memoryPool.release(modeMemory)) {
+          modeMemory = NULL;
+          return;
+        }
       }
     }
 
@@ -595,6 +780,197 @@ namespace occa {
   memory null;
   //====================================
 
+
+  //---[ memoryView ]-------------------
+  memoryView::memoryView() :
+    modeMemory(NULL),
+    offset_(0),
+    size_(0),
+    dtype_(&dtype::none) {}
+
+  memoryView::memoryView(const occa::memory &mem) :
+    modeMemory(mem.getModeMemory()),
+    offset_(0),
+    size_(mem.size()),
+    dtype_(&mem.dtype()) {}
+
+  memoryView::memoryView(const occa::memory &mem,
+                         const dim_t offset,
+                         const dim_t count) :
+    modeMemory(mem.getModeMemory()),
+    offset_(0),
+    size_(mem.size()),
+    dtype_(&mem.dtype()) {
+    *this = slice(offset, count);
+  }
+
+  void memoryView::assertInitialized() const {
+    OCCA_ERROR("Memory view not initialized",
+               modeMemory != NULL);
+  }
+
+  bool memoryView::isInitialized() const {
+    return (modeMemory != NULL);
+  }
+
+  modeMemory_t* memoryView::getModeMemory() const {
+    return modeMemory;
+  }
+
+  occa::memory memoryView::getMemory() const {
+    return occa::memory(modeMemory);
+  }
+
+  memoryView::operator kernelArg() const {
+    if (modeMemory) {
+      return modeMemory->makeOffsetKernelArg(offset_);
+    }
+    return nullKernelArg;
+  }
+
+  const dtype_t& memoryView::dtype() const {
+    return *dtype_;
+  }
+
+  udim_t memoryView::offset() const {
+    return offset_;
+  }
+
+  udim_t memoryView::size() const {
+    return size_;
+  }
+
+  udim_t memoryView::length() const {
+    if (!modeMemory) {
+      return 0;
+    }
+    return size_ / dtype_->bytes();
+  }
+
+  bool memoryView::operator == (const occa::memoryView &other) const {
+    return ((modeMemory == other.modeMemory)
+            && (offset_ == other.offset_)
+            && (size_ == other.size_));
+  }
+
+  bool memoryView::operator != (const occa::memoryView &other) const {
+    return !(*this == other);
+  }
+
+  occa::memoryView memoryView::operator + (const dim_t offset) const {
+    return slice(offset);
+  }
+
+  occa::memoryView& memoryView::operator += (const dim_t offset) {
+    *this = slice(offset);
+    return *this;
+  }
+
+  occa::memoryView memoryView::slice(const dim_t offset,
+                                     const dim_t count) const {
+    assertInitialized();
+
+    const int dtypeSize = dtype_->bytes();
+    const dim_t offset_b = dtypeSize * offset;
+    const dim_t bytes = dtypeSize * ((count == -1)
+                                     ? (length() - offset)
+                                     : count);
+
+    OCCA_ERROR("Trying to allocate negative bytes (" << bytes << ")",
+               bytes >= 0);
+
+    OCCA_ERROR("Cannot have a negative offset (" << offset_b << ")",
+               offset_b >= 0);
+
+    OCCA_ERROR("Cannot have offset and bytes greater than the memory size ("
+               << offset_b << " + " << bytes << " > " << size_ << ")",
+               (offset_b + bytes) <= (dim_t) size_);
+
+    memoryView view(*this);
+    view.offset_ += offset_b;
+    view.size_ = bytes;
+    return view;
+  }
+
+  occa::memoryView memoryView::as(const dtype_t &dtype__) const {
+    OCCA_ERROR("Memory dtype [" << dtype__.name() << "] must be registered",
+               dtype__.isRegistered());
+    memoryView view(*this);
+    view.dtype_ = &(dtype__.self());
+    return view;
+  }
+
+  void memoryView::copyFrom(const void *src,
+                            const dim_t bytes,
+                            const dim_t offset,
+                            const copyOptions &options) {
+    assertInitialized();
+
+    const dim_t bytes_ = (bytes == -1) ? (dim_t) size_ : bytes;
+
+    OCCA_ERROR("Trying to copy negative bytes (" << bytes_ << ")",
+               bytes_ >= 0);
+    OCCA_ERROR("Cannot have a negative offset (" << offset << ")",
+               offset >= 0);
+    OCCA_ERROR("Destination memory view has size [" << size_ << "],"
+               << " trying to access [" << offset << ", " << (offset + bytes_) << "]",
+               (offset + bytes_) <= (dim_t) size_);
+
+    copyStreamScope streamScope(modeMemory->modeDevice, options);
+    modeMemory->copyFrom(src, bytes_, offset_ + offset, options);
+  }
+
+  void memoryView::copyFrom(const memoryView &src,
+                            const dim_t bytes,
+                            const copyOptions &options) {
+    assertInitialized();
+    src.assertInitialized();
+
+    const dim_t bytes_ = (bytes == -1) ? (dim_t) src.size_ : bytes;
+
+    OCCA_ERROR("Trying to copy negative bytes (" << bytes_ << ")",
+               bytes_ >= 0);
+    OCCA_ERROR("Source memory view has size [" << src.size_ << "],"
+               << " trying to access [0, " << bytes_ << "]",
+               bytes_ <= (dim_t) src.size_);
+    OCCA_ERROR("Destination memory view has size [" << size_ << "],"
+               << " trying to access [0, " << bytes_ << "]",
+               bytes_ <= (dim_t) size_);
+
+    copyStreamScope streamScope(modeMemory->modeDevice, options);
+    modeMemory->copyFrom(src.modeMemory, bytes_,
+                         offset_, src.offset_,
+                         options);
+  }
+
+  void memoryView::copyTo(void *dest,
+                          const dim_t bytes,
+                          const dim_t offset,
+                          const copyOptions &options) const {
+    assertInitialized();
+
+    const dim_t bytes_ = (bytes == -1) ? (dim_t) size_ : bytes;
+
+    OCCA_ERROR("Trying to copy negative bytes (" << bytes_ << ")",
+               bytes_ >= 0);
+    OCCA_ERROR("Cannot have a negative offset (" << offset << ")",
+               offset >= 0);
+    OCCA_ERROR("Source memory view has size [" << size_ << "],"
+               << " trying to access [" << offset << ", " << (offset + bytes_) << "]",
+               (offset + bytes_) <= (dim_t) size_);
+
+    copyStreamScope streamScope(modeMemory->modeDevice, options);
+    modeMemory->copyTo(dest, bytes_, offset_ + offset, options);
+  }
+
+  void memoryView::copyTo(const memoryView &dest,
+                          const dim_t bytes,
+                          const copyOptions &options) const {
+    memoryView dest_(dest);
+    dest_.copyFrom(*this, bytes, options);
+  }
+  //====================================
+
   std::ostream& operator << (std::ostream &out,
                              const occa::memory &memory) {
     out << memory.properties();
@@ -0,0 +1,192 @@
+#include <occa/core/device.hpp>
+#include <occa/core/memory.hpp>
+#include <occa/core/memoryPool.hpp>
+#include <occa/tools/exception.hpp>
+
+namespace occa {
+  //---[ memoryPoolStats ]--------------
+  memoryPoolStats::memoryPoolStats() :
+    cachedBytes(0),
+    hits(0),
+    misses(0),
+    trimmedBytes(0) {}
+  //====================================
+
+  //---[ memoryPool_t ]-----------------
+  memoryPool_t::memoryPool_t(modeDevice_t *modeDevice_,
+                             const occa::properties &props) :
+    modeDevice(modeDevice_),
+    enabled(props.get("memory_pool", false)),
+    maxCachedBytes(-1) {
+    const dim_t maxCachedBytes_ = props.get<dim_t>("memory_pool_max_cached_bytes", -1);
+    if (maxCachedBytes_ >= 0) {
+      maxCachedBytes = (udim_t) maxCachedBytes_;
+    }
+  }
+
+  udim_t memoryPool_t::sizeClass(const udim_t bytes) {
+    static const udim_t minBytes = 256;
+    if (bytes <= minBytes) {
+      return minBytes;
+    }
+    // Split each power of two into 4 classes to bound waste to 25%
+    udim_t power = minBytes;
+    while ((power << 1) <= bytes) {
+      power <<= 1;
+    }
+    const udim_t step = power >> 2;
+    return step * ((bytes + step - 1) / step);
+  }
+
+  bool memoryPool_t::isEnabled() const {
+    return enabled;
+  }
+
+  const memoryPoolStats& memoryPool_t::stats() const {
+    return stats_;
+  }
+
+  modeMemory_t* memoryPool_t::malloc(const udim_t bytes,
+                                     const void *src,
+                                     const occa::properties &props) {
+    // Wrapped host pointers aren't owned by the backend allocation
+    if (!enabled
+        || (src && props.get("use_host_pointer", false))) {
+      return backendMalloc(bytes, src, props);
+    }
+
+    const udim_t poolSize = sizeClass(bytes);
+    const hash_t poolBin = occa::hash(poolSize) ^ occa::hash(props);
+
+    modeMemory_t *mem = NULL;
+    streamBinMap::iterator it = streamBins.find(
+      modeDevice->currentStream.getModeStream()
+    );
+    if (it != streamBins.end()) {
+      mem = popBlock(it->second, poolBin);
+    }
+    if (!mem) {
+      mem = popBlock(readyBins, poolBin);
+    }
+
+    if (mem) {
+      ++stats_.hits;
+      stats_.cachedBytes -= mem->poolSize;
+
+      mem->memInfo = uvaFlag::none;
+      mem->uvaPtr = NULL;
+      mem->dtype_ = &dtype::byte;
+      mem->isOrigin = true;
+    } else {
+      ++stats_.misses;
+      mem = backendMalloc(poolSize, NULL, props);
+      mem->poolSize = poolSize;
+      mem->poolBin = poolBin;
+    }
+    mem->size = bytes;
+
+    if (src) {
+      mem->copyFrom(src, bytes);
+    }
+    return mem;
+  }
+
+  bool memoryPool_t::release(modeMemory_t *mem) {
+    if (!enabled || !mem->isPooled()) {
+      return false;
+    }
+    mem->removeAllMemoryRefs();
+    mem->uvaPtr = NULL;
+    mem->memInfo = uvaFlag::none;
+    mem->dirtyRanges.clear();
+    mem->freeOffsetMemory();
+
+    modeStream_t *modeStream = modeDevice->currentStream.getModeStream();
+    streamBins[modeStream][mem->poolBin].push_back(mem);
+    stats_.cachedBytes += mem->poolSize;
+
+    return true;
+  }
+
+  void memoryPool_t::finish() {
+    streamBinMap::iterator it = streamBins.begin();
+    while (it != streamBins.end()) {
+      blockBinMap &bins = it->second;
+      blockBinMap::iterator binIt = bins.begin();
+      while (binIt != bins.end()) {
+        blockVector &readyBlocks = readyBins[binIt->first];
+        readyBlocks.insert(readyBlocks.end(),
+                           binIt->second.begin(),
+                           binIt->second.end());
+        ++binIt;
+      }
+      ++it;
+    }
+    streamBins.clear();
+
+    if (stats_.cachedBytes > maxCachedBytes) {
+      trim(maxCachedBytes);
+    }
+  }
+
+  void memoryPool_t::trim(const udim_t bytes) {
+    // Prefer blocks that are no longer tied to a stream
+    trimBins(readyBins, bytes);
+
+    streamBinMap::iterator it = streamBins.begin();
+    while ((stats_.cachedBytes > bytes) && (it != streamBins.end())) {
+      trimBins(it->second, bytes);
+      ++it;
+    }
+  }
+
+  void memoryPool_t::clear() {
+    streamBins.clear();
+    readyBins.clear();
+    stats_.cachedBytes = 0;
+  }
+
+  modeMemory_t* memoryPool_t::backendMalloc(const udim_t bytes,
+                                            const void *src,
+                                            const occa::properties &props) {
+    if (!stats_.cachedBytes) {
+      return modeDevice->malloc(bytes, src, props);
+    }
+    // Release cached blocks and retry if the backend runs out of memory
+    try {
+      return modeDevice->malloc(bytes, src, props);
+    } catch (occa::exception &exc) {
+      trim();
+    }
+    return modeDevice->malloc(bytes, src, props);
+  }
+
+  modeMemory_t* memoryPool_t::popBlock(blockBinMap &bins,
+                                       const hash_t &poolBin) {
+    blockBinMap::iterator it = bins.find(poolBin);
+    if ((it == bins.end()) || it->second.empty()) {
+      return NULL;
+    }
+    modeMemory_t *mem = it->second.back();
+    it->second.pop_back();
+    return mem;
+  }
+
+  void memoryPool_t::trimBins(blockBinMap &bins,
+                              const udim_t bytes) {
+    blockBinMap::iterator it = bins.begin();
+    while ((stats_.cachedBytes > bytes) && (it != bins.end())) {
+      blockVector &blocks = it->second;
+      while ((stats_.cachedBytes > bytes) && blocks.size()) {
+        modeMemory_t *mem = blocks.back();
+        blocks.pop_back();
+
+        stats_.cachedBytes  -= mem->poolSize;
+        stats_.trimmedBytes += mem->poolSize;
+        delete mem;
+      }
+      ++it;
+    }
+  }
+  //====================================
+}
@@ -0,0 +1,132 @@
+#include <occa/core/base.hpp>
+#include <occa/core/scratch.hpp>
+#include <occa/tools/exception.hpp>
+
+namespace occa {
+  //---[ scratchArena_t ]---------------
+  scratchArena_t::scratchArena_t(const occa::properties &props) :
+    arenaIndex(0),
+    offset(0),
+    nextArenaBytes(props.get<dim_t>("scratch_bytes", 1 << 20)),
+    scopes(0),
+    releaseStream(NULL) {}
+
+  udim_t scratchArena_t::alignedBytes(const udim_t bytes) {
+    return alignment * ((bytes + alignment - 1) / alignment);
+  }
+
+  memory scratchArena_t::allocate(device &dev,
+                                  const udim_t bytes) {
+    OCCA_ERROR("Scratch memory must be allocated inside an occa::scratchScope",
+               scopes > 0);
+
+    // Released memory may still be in use by work queued on another stream
+    if (releaseStream
+        && (releaseStream != dev.getStream().getModeStream())) {
+      dev.waitFor(releaseTag);
+      releaseStream = NULL;
+      releaseTag = streamTag();
+    }
+
+    const udim_t aligned = alignedBytes(bytes);
+    const int arenaCount = (int) arenas.size();
+
+    // Find the next arena with enough space
+    while ((arenaIndex < arenaCount)
+           && ((offset + aligned) > arenas[arenaIndex].size())) {
+      ++arenaIndex;
+      offset = 0;
+    }
+
+    if (arenaIndex == arenaCount) {
+      udim_t arenaBytes = nextArenaBytes;
+      if (arenaCount) {
+        arenaBytes = 2 * arenas[arenaCount - 1].size();
+      }
+      if (arenaBytes < aligned) {
+        arenaBytes = aligned;
+      }
+      arenas.push_back(dev.malloc(arenaBytes));
+    }
+
+    memory mem = arenas[arenaIndex].slice(offset, bytes);
+    offset += aligned;
+    return mem;
+  }
+
+  void scratchArena_t::beginScope(int &arenaIndex_,
+                                  udim_t &offset_) {
+    arenaIndex_ = arenaIndex;
+    offset_ = offset;
+    ++scopes;
+  }
+
+  void scratchArena_t::endScope(device &dev,
+                                const int arenaIndex_,
+                                const udim_t offset_) {
+    arenaIndex = arenaIndex_;
+    offset = offset_;
+    --scopes;
+
+    if (arenas.size()) {
+      releaseStream = dev.getStream().getModeStream();
+      releaseTag = dev.tagStream();
+    }
+
+    // Merge arenas so the next peak fits in one allocation
+    if (!scopes && (arenas.size() > 1)) {
+      dev.waitFor(releaseTag);
+      nextArenaBytes = capacity();
+      free();
+    }
+  }
+
+  udim_t scratchArena_t::capacity() const {
+    udim_t bytes = 0;
+    const int arenaCount = (int) arenas.size();
+    for (int i = 0; i < arenaCount; ++i) {
+      bytes += arenas[i].size();
+    }
+    return bytes;
+  }
+
+  udim_t scratchArena_t::bytesUsed() const {
+    udim_t bytes = offset;
+    for (int i = 0; i < arenaIndex; ++i) {
+      bytes += arenas[i].size();
+    }
+    return bytes;
+  }
+
+  void scratchArena_t::free() {
+    const int arenaCount = (int) arenas.size();
+    for (int i = 0; i < arenaCount; ++i) {
+      arenas[i].free();
+    }
+    arenas.clear();
+    arenaIndex = 0;
+    offset = 0;
+    releaseStream = NULL;
+    releaseTag = streamTag();
+  }
+  //====================================
+
+  //---[ scratchScope ]-----------------
+  scratchScope::scratchScope() :
+    modeDevice(occa::getDevice().getModeDevice()) {
+    modeDevice->scratchArena.beginScope(arenaIndex, offset);
+  }
+
+  scratchScope::scratchScope(occa::device device) :
+    modeDevice(device.getModeDevice()) {
+    OCCA_ERROR("Device not initialized or has been freed",
+               modeDevice != NULL);
+    modeDevice->scratchArena.beginScope(arenaIndex, offset);
+  }
+
+  scratchScope::~scratchScope() {
+    occa::device device(modeDevice);
+    modeDevice->scratchArena.endScope(device, arenaIndex, offset);
+  }
+  //====================================
+}
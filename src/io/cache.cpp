@@ -1,6 +1,9 @@
+#include <cstdio>
+
 #include <occa/defines.hpp>
 #include <occa/io/cache.hpp>
 #include <occa/io/lock.hpp>
+#include <occa/io/pack.hpp>
 #include <occa/io/utils.hpp>
 #include <occa/tools/hash.hpp>
 #include <occa/tools/env.hpp>
@@ -104,6 +107,347 @@ namespace occa {
       return io::exists(successFile);
     }
 
+    std::string localHashDir(const std::string &hashDir) {
+      const std::string &localPath = localCachePath();
+      const std::string &cPath = cachePath();
+      if (!localPath.size() ||
+          !startsWith(hashDir, cPath)) {
+        return "";
+      }
+      return localPath + hashDir.substr(cPath.size());
+    }
+
+    std::string findCachedFile(const std::string &hashDir,
+                               const std::string &filename,
+                               const strVector &metadataFiles) {
+      // The node-local marker is only written once every file was copied
+      const std::string localDir = localHashDir(hashDir);
+      if (localDir.size() &&
+          cachedFileIsComplete(localDir, filename)) {
+        return localDir;
+      }
+
+      // Only the pack is shared, there are no shared kernel directories
+      if (usingCachePack()) {
+        if (extractPackedFile(hashDir, filename, metadataFiles)) {
+          return localDir;
+        }
+        return "";
+      }
+
+      if (cachedFileIsComplete(hashDir, filename) &&
+          io::isFile(hashDir + filename)) {
+        return storeCachedFile(hashDir, filename, metadataFiles);
+      }
+      return "";
+    }
+
+    std::string storeCachedFile(const std::string &hashDir,
+                                const std::string &filename,
+                                const strVector &metadataFiles) {
+      const std::string localDir = localHashDir(hashDir);
+      if (!localDir.size()) {
+        return hashDir;
+      }
+
+      // Kernels were built in the node-local staging directory
+      if (usingCachePack()) {
+        packFile(localDir, filename, metadataFiles);
+        return localDir;
+      }
+
+      const int metadataFileCount = (int) metadataFiles.size();
+      for (int i = 0; i < metadataFileCount; ++i) {
+        const std::string &metadataFile = metadataFiles[i];
+        if (io::isFile(hashDir + metadataFile)) {
+          io::copy(hashDir + metadataFile,
+                   localDir + metadataFile);
+        }
+      }
+
+      // Fall back to the shared cache if the local copy failed
+      //   (e.g. the local disk is full)
+      if (!io::copy(hashDir + filename,
+                    localDir + filename)) {
+        return hashDir;
+      }
+      markCachedFileComplete(localDir, filename);
+
+      return localDir;
+    }
+
+    std::string packKey(const std::string &hashDir,
+                        const std::string &filename) {
+      const std::string &cPath = cachePath();
+      if (!startsWith(hashDir, cPath)) {
+        return "";
+      }
+      return hashDir.substr(cPath.size()) + filename;
+    }
+
+    bool extractPackedFile(const std::string &hashDir,
+                           const std::string &filename,
+                           const strVector &metadataFiles) {
+      pack_t &pack = cachePack();
+
+      // Metadata is packed before the file, so the file being packed
+      //   means the metadata is as well
+      const std::string key = packKey(hashDir, filename);
+      const std::string localDir = localHashDir(hashDir);
+      if (!key.size() ||
+          !localDir.size() ||
+          !pack.has(key)) {
+        return false;
+      }
+
+      const int metadataFileCount = (int) metadataFiles.size();
+      for (int i = 0; i < metadataFileCount; ++i) {
+        const std::string &metadataFile = metadataFiles[i];
+        pack.extract(packKey(hashDir, metadataFile),
+                     localDir + metadataFile);
+      }
+
+      if (!pack.extract(key, localDir + filename)) {
+        return false;
+      }
+      markCachedFileComplete(localDir, filename);
+
+      return true;
+    }
+
+    void packFile(const std::string &hashDir,
+                  const std::string &filename,
+                  const strVector &metadataFiles) {
+      pack_t &pack = cachePack();
+
+      const std::string key = packKey(hashDir, filename);
+      if (!key.size() ||
+          pack.has(key)) {
+        return;
+      }
+
+      const int metadataFileCount = (int) metadataFiles.size();
+      for (int i = 0; i < metadataFileCount; ++i) {
+        const std::string &metadataFile = metadataFiles[i];
+        pack.appendFile(packKey(hashDir, metadataFile),
+                        hashDir + metadataFile,
+                        env::OCCA_CACHE_PACK_MAX_BYTES);
+      }
+      pack.appendFile(key,
+                      hashDir + filename,
+                      env::OCCA_CACHE_PACK_MAX_BYTES);
+    }
+
+    std::string binaryHashDir(const hash_t &binaryHash) {
+      return cachePath() + "binaries/" + binaryHash.getString() + "/";
+    }
+
+    hash_t compiledBinaryHash(const std::string &sourceFilename,
+                              const std::string &command,
+                              const std::string &hashDir) {
+      // Drop the kernel hash directory from the command so only
+      //   the compiler, flags and file names are hashed
+      std::string relativeCommand;
+      size_t start = 0;
+      size_t pos;
+      while ((pos = command.find(hashDir, start)) != std::string::npos) {
+        relativeCommand.append(command, start, pos - start);
+        start = pos + hashDir.size();
+      }
+      relativeCommand.append(command, start, std::string::npos);
+
+      return (
+        occa::hash("binary")
+        ^ occa::hash(OCCA_VERSION_STR)
+        ^ occa::hashFile(sourceFilename)
+        ^ occa::hash(relativeCommand)
+      );
+    }
+
+    bool loadSharedBinary(const hash_t &binaryHash,
+                          const std::string &binaryFilename) {
+      const std::string binaryDir = findCachedFile(binaryHashDir(binaryHash),
+                                                   kc::binaryFile);
+      return (
+        binaryDir.size()
+        && io::copy(binaryDir + kc::binaryFile, binaryFilename)
+      );
+    }
+
+    void storeSharedBinary(const hash_t &binaryHash,
+                           const std::string &binaryFilename) {
+      const std::string binaryDir = binaryHashDir(binaryHash);
+      if (cachedFileIsComplete(binaryDir, kc::binaryFile) ||
+          !io::copy(binaryFilename, binaryDir + kc::binaryFile)) {
+        return;
+      }
+      markCachedFileComplete(binaryDir, kc::binaryFile);
+      storeCachedFile(binaryDir, kc::binaryFile);
+    }
+
+    std::string cachedBuildFile(const std::string &hashDir) {
+      // Prefer the node-local cache copy
+      const std::string localDir = localHashDir(hashDir);
+      if (localDir.size() &&
+          io::isFile(localDir + kc::buildFile)) {
+        return localDir + kc::buildFile;
+      }
+
+      // Dependency and defines checks need the build info before the
+      //   binary is extracted from the pack
+      if (usingCachePack()) {
+        pack_t &pack = cachePack();
+        const std::string key = packKey(hashDir, kc::buildFile);
+        if (localDir.size() &&
+            key.size() &&
+            pack.has(key)) {
+          // Extract the metadata first so the build file implies it exists
+          pack.extract(packKey(hashDir, kc::buildMetadataFile),
+                       localDir + kc::buildMetadataFile);
+          if (pack.extract(key, localDir + kc::buildFile)) {
+            return localDir + kc::buildFile;
+          }
+        }
+        return "";
+      }
+
+      if (io::isFile(hashDir + kc::buildFile)) {
+        return hashDir + kc::buildFile;
+      }
+      return "";
+    }
+
+    // Index of kernels built from the same source and props, only
+    //   differing in their defines:
+    //   {
+    //     references: { <references hash>: [macro names] },
+    //     kernels: { <used defines hash>: <kernel hash> }
+    //   }
+    std::string definesIndexFile(const hash_t &definesFreeHash) {
+      return cachePath() + "defines/" + definesFreeHash.getString() + ".json";
+    }
+
+    static hash_t usedDefinesHash(const std::string &referencesHash,
+                                  const json &macroReferences,
+                                  const json &defines) {
+      // Defines the source never looked up can't change the output
+      json usedDefines(json::object_);
+      jsonObject &usedDefinesMap = usedDefines.object();
+
+      const jsonObject &definesMap = defines.object();
+      const jsonArray &names = macroReferences.array();
+      const int nameCount = (int) names.size();
+      for (int i = 0; i < nameCount; ++i) {
+        const std::string &name = names[i].string();
+        jsonObject::const_iterator it = definesMap.find(name);
+        if (it != definesMap.end()) {
+          usedDefinesMap[name] = it->second;
+        }
+      }
+
+      return occa::hash(referencesHash) ^ usedDefines;
+    }
+
+    hash_t findKernelWithDefines(const hash_t &definesFreeHash,
+                                 const json &defines) {
+      const std::string indexFile = definesIndexFile(definesFreeHash);
+      if (!io::isFile(indexFile)) {
+        return hash_t();
+      }
+
+      const json index = json::read(indexFile);
+      const jsonObject &references = index["references"].object();
+      const jsonObject &kernels = index["kernels"].object();
+
+      jsonObject::const_iterator it = references.begin();
+      while (it != references.end()) {
+        const std::string key = (
+          usedDefinesHash(it->first, it->second, defines).getFullString()
+        );
+        jsonObject::const_iterator kernelIt = kernels.find(key);
+        if (kernelIt != kernels.end()) {
+          // Make sure the build wasn't cleared
+          const hash_t kernelHash = hash_t::fromString(kernelIt->second);
+          if (cachedBuildFile(hashDir(kernelHash)).size()) {
+            return kernelHash;
+          }
+        }
+        ++it;
+      }
+
+      return hash_t();
+    }
+
+    void registerKernelDefines(const hash_t &definesFreeHash,
+                               const hash_t &kernelHash,
+                               const json &defines) {
+      // Only preprocessed (OKL) sources know which macros they reference
+      const std::string buildFile = cachedBuildFile(hashDir(kernelHash));
+      if (!buildFile.size()) {
+        return;
+      }
+      json macroReferences = json::read(buildFile)["kernel/macro_references"];
+      if (!macroReferences.isArray()) {
+        return;
+      }
+      const std::string referencesHash = occa::hash(macroReferences).getFullString();
+
+      io::lock_t lock(definesFreeHash, "kernel-defines");
+      if (!lock.isMine()) {
+        return;
+      }
+
+      const std::string indexFile = definesIndexFile(definesFreeHash);
+      json index(json::object_);
+      if (io::isFile(indexFile)) {
+        index = json::read(indexFile);
+      }
+      index["references"].asObject().object()[referencesHash] = macroReferences;
+      index["kernels"].asObject().object()[
+        usedDefinesHash(referencesHash, macroReferences, defines).getFullString()
+      ] = kernelHash.getFullString();
+
+      // Readers never lock, swap in the new index atomically
+      const std::string tmpIndexFile = indexFile + ".tmp." + toString(sys::getPID());
+      index.write(tmpIndexFile);
+      if (::rename(tmpIndexFile.c_str(), indexFile.c_str())) {
+        ::remove(tmpIndexFile.c_str());
+      }
+    }
+
+    std::string autotuneFile(const hash_t &tuningHash) {
+      return cachePath() + "autotune/" + tuningHash.getString() + ".json";
+    }
+
+    json findAutotunedProperties(const hash_t &tuningHash) {
+      const std::string tuneFile = autotuneFile(tuningHash);
+      if (!io::isFile(tuneFile)) {
+        return json();
+      }
+      return json::read(tuneFile)["properties"];
+    }
+
+    void storeAutotunedProperties(const hash_t &tuningHash,
+                                  const json &props,
+                                  const double time) {
+      io::lock_t lock(tuningHash, "autotune");
+      if (!lock.isMine()) {
+        return;
+      }
+
+      json info(json::object_);
+      info["properties"] = props;
+      info["time"] = time;
+
+      // Readers never lock, swap in the new file atomically
+      const std::string tuneFile = autotuneFile(tuningHash);
+      const std::string tmpTuneFile = tuneFile + ".tmp." + toString(sys::getPID());
+      info.write(tmpTuneFile);
+      if (::rename(tmpTuneFile.c_str(), tuneFile.c_str())) {
+        ::remove(tmpTuneFile.c_str());
+      }
+    }
+
     void setBuildProps(occa::json &props) {
       props["date"]       = sys::date();
       props["human_date"] = sys::humanDate();
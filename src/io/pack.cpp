@@ -0,0 +1,468 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <occa/defines.hpp>
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <sys/time.h>
+#  include <unistd.h>
+#endif
+
+#include <occa/io/lock.hpp>
+#include <occa/io/pack.hpp>
+#include <occa/io/utils.hpp>
+#include <occa/tools/env.hpp>
+#include <occa/tools/hash.hpp>
+#include <occa/tools/misc.hpp>
+
+namespace occa {
+  namespace io {
+    static const udim_t packFileHeaderBytes = 4 + sizeof(uint64_t);
+    static const udim_t packHeaderBytes = 4 + sizeof(uint32_t) + sizeof(uint64_t);
+
+    const char pack_t::magic[4] = {'O', 'C', 'P', 'K'};
+    const char pack_t::fileMagic[4] = {'O', 'C', 'P', 'F'};
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+    // Stamp packs so readers can tell a replaced pack from a grown one
+    static uint64_t newGeneration() {
+      timeval now;
+      ::gettimeofday(&now, NULL);
+
+      char hostname[256];
+      if (::gethostname(hostname, sizeof(hostname))) {
+        hostname[0] = '\0';
+      }
+      hostname[sizeof(hostname) - 1] = '\0';
+
+      const hash_t stamp = occa::hash(
+        std::string(hostname)
+        + ':' + toString(sys::getPID())
+        + ':' + toString(now.tv_sec)
+        + ':' + toString(now.tv_usec)
+      );
+      uint64_t generation;
+      ::memcpy(&generation, stamp.h, sizeof(generation));
+      return generation ? generation : 1;
+    }
+
+    static bool writeAll(const int fd,
+                         const char *c,
+                         udim_t bytes) {
+      while (bytes) {
+        const ssize_t bytesWritten = ::write(fd, c, bytes);
+        if (bytesWritten <= 0) {
+          return false;
+        }
+        c += bytesWritten;
+        bytes -= bytesWritten;
+      }
+      return true;
+    }
+
+    static std::string fileHeader(const uint64_t generation) {
+      std::string header;
+      header.append(pack_t::fileMagic, 4);
+      header.append((const char*) &generation, sizeof(generation));
+      return header;
+    }
+#endif
+
+    pack_t::pack_t(const std::string &filename_) :
+      filename(filename_),
+      mappedPtr(NULL),
+      mappedBytes(0),
+      mappedInode(0),
+      generation(0),
+      indexedBytes(0) {}
+
+    pack_t::~pack_t() {
+      unmap();
+      mutex_.free();
+    }
+
+    bool pack_t::has(const std::string &key) {
+      entry_t entry;
+      return find(key, entry);
+    }
+
+    udim_t pack_t::size() {
+      mutex_.lock();
+      refreshIndex();
+      const udim_t entryCount = entries.size();
+      mutex_.unlock();
+      return entryCount;
+    }
+
+    udim_t pack_t::bytes() {
+      mutex_.lock();
+      refreshIndex();
+      const udim_t packBytes = mappedBytes;
+      mutex_.unlock();
+      return packBytes;
+    }
+
+    std::string pack_t::read(const std::string &key) {
+      mutex_.lock();
+      std::string content;
+      entryMap::iterator it;
+      if (refreshIndex() &&
+          ((it = entries.find(key)) != entries.end())) {
+        content.assign(mappedPtr + it->second.offset,
+                       it->second.bytes);
+      }
+      mutex_.unlock();
+      return content;
+    }
+
+    bool pack_t::extract(const std::string &key,
+                         const std::string &destination) {
+      entry_t entry;
+      if (!find(key, entry)) {
+        return false;
+      }
+      const std::string content = read(key);
+
+      const std::string expDestination = io::filename(destination);
+      sys::mkpath(dirname(expDestination));
+
+      // Write to a process-unique file and rename it so concurrent
+      //   readers never see a partially extracted file
+      const std::string tmpDestination = (
+        expDestination + ".tmp." + toString(sys::getPID())
+      );
+      FILE *fp = fopen(tmpDestination.c_str(), "wb");
+      if (!fp) {
+        return false;
+      }
+      const bool wrote = (
+        fwrite(content.c_str(), sizeof(char), content.size(), fp) == content.size()
+      );
+      fclose(fp);
+
+      if (!wrote ||
+          ::rename(tmpDestination.c_str(), expDestination.c_str())) {
+        ::remove(tmpDestination.c_str());
+        return false;
+      }
+      return true;
+    }
+
+    bool pack_t::append(const std::string &key,
+                        const std::string &content,
+                        const udim_t maxBytes) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      const uint32_t keyBytes = (uint32_t) key.size();
+      const uint64_t contentBytes = (uint64_t) content.size();
+
+      std::string record;
+      record.reserve(packHeaderBytes + keyBytes + contentBytes);
+      record.append(magic, 4);
+      record.append((const char*) &keyBytes, sizeof(keyBytes));
+      record.append((const char*) &contentBytes, sizeof(contentBytes));
+      record.append(key);
+      record.append(content);
+
+      const hash_t packHash = occa::hash(filename);
+      bool appended = false;
+
+      mutex_.lock();
+
+      // Wait for other processes appending to the pack
+      io::lock_t lock(packHash, "cache-pack");
+      while (!lock.isMine()) {}
+
+      refreshIndex();
+      if (entries.find(key) != entries.end()) {
+        appended = true;
+      } else {
+        // Make room by evicting the oldest entries, leaving some slack
+        //   so the next appends don't evict again
+        if (maxBytes &&
+            ((indexedBytes + record.size()) > maxBytes)) {
+          evict(
+            (record.size() < maxBytes)
+            ? std::min(maxBytes / 2, maxBytes - record.size())
+            : 0
+          );
+        }
+
+        sys::mkpath(dirname(filename));
+        const int fd = ::open(filename.c_str(),
+                              O_WRONLY | O_CREAT | O_APPEND,
+                              0644);
+        if (fd >= 0) {
+          bool wrote = true;
+          if (!generation) {
+            // New (or unreadable) pack, start a new generation
+            const std::string header = fileHeader(newGeneration());
+            ignoreResult( ::ftruncate(fd, 0) );
+            wrote = writeAll(fd, header.c_str(), header.size());
+          } else if (mappedBytes > indexedBytes) {
+            // Drop a partially written record left by a crashed process
+            ignoreResult( ::ftruncate(fd, indexedBytes) );
+          }
+
+          wrote = (
+            wrote
+            && writeAll(fd, record.c_str(), record.size())
+          );
+          ::fsync(fd);
+          ::close(fd);
+
+          appended = wrote && refreshIndex();
+        }
+      }
+      lock.release();
+      mutex_.unlock();
+
+      return appended;
+#else
+      return false;
+#endif
+    }
+
+    bool pack_t::appendFile(const std::string &key,
+                            const std::string &sourceFile,
+                            const udim_t maxBytes) {
+      if (!io::isFile(sourceFile)) {
+        return false;
+      }
+      return append(key, io::read(sourceFile, true), maxBytes);
+    }
+
+    bool pack_t::refreshIndex() {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      struct stat statInfo;
+      if (::stat(filename.c_str(), &statInfo)) {
+        resetIndex();
+        return false;
+      }
+      const udim_t bytes = (udim_t) statInfo.st_size;
+      const uint64_t inode = (uint64_t) statInfo.st_ino;
+
+      // Packs only grow until they are replaced
+      if (mappedPtr &&
+          (inode == mappedInode) &&
+          (bytes == mappedBytes)) {
+        return true;
+      }
+
+      unmap();
+      if (bytes < packFileHeaderBytes) {
+        resetIndex();
+        return false;
+      }
+
+      const int fd = ::open(filename.c_str(), O_RDONLY);
+      if (fd < 0) {
+        resetIndex();
+        return false;
+      }
+      void *ptr = ::mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+      ::close(fd);
+      if (ptr == MAP_FAILED) {
+        resetIndex();
+        return false;
+      }
+      mappedPtr = (char*) ptr;
+      mappedBytes = bytes;
+      mappedInode = inode;
+
+      uint64_t mappedGeneration = 0;
+      if (!::memcmp(mappedPtr, fileMagic, 4)) {
+        ::memcpy(&mappedGeneration, mappedPtr + 4, sizeof(mappedGeneration));
+      }
+      if (!mappedGeneration) {
+        resetIndex();
+        return false;
+      }
+
+      // The pack was removed, recreated or replaced by eviction
+      if ((mappedGeneration != generation) ||
+          (mappedBytes < indexedBytes)) {
+        entries.clear();
+        generation = mappedGeneration;
+        indexedBytes = packFileHeaderBytes;
+      }
+
+      // Index records appended since the last refresh
+      while ((indexedBytes + packHeaderBytes) <= mappedBytes) {
+        const char *header = mappedPtr + indexedBytes;
+        if (::memcmp(header, magic, 4)) {
+          break;
+        }
+
+        uint32_t keyBytes;
+        uint64_t contentBytes;
+        ::memcpy(&keyBytes, header + 4, sizeof(keyBytes));
+        ::memcpy(&contentBytes, header + 4 + sizeof(keyBytes), sizeof(contentBytes));
+
+        const udim_t keyOffset = indexedBytes + packHeaderBytes;
+        const udim_t contentOffset = keyOffset + keyBytes;
+        if ((contentOffset + contentBytes) > mappedBytes) {
+          break;
+        }
+
+        const std::string key(mappedPtr + keyOffset, keyBytes);
+        if (entries.find(key) == entries.end()) {
+          entry_t &entry = entries[key];
+          entry.offset = contentOffset;
+          entry.bytes = contentBytes;
+        }
+        indexedBytes = contentOffset + contentBytes;
+      }
+      return true;
+#else
+      return false;
+#endif
+    }
+
+    void pack_t::resetIndex() {
+      unmap();
+      entries.clear();
+      generation = 0;
+      indexedBytes = 0;
+    }
+
+    void pack_t::unmap() {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      if (mappedPtr) {
+        ::munmap(mappedPtr, mappedBytes);
+      }
+#endif
+      mappedPtr = NULL;
+      mappedBytes = 0;
+      mappedInode = 0;
+    }
+
+    bool pack_t::find(const std::string &key, entry_t &entry) {
+      mutex_.lock();
+      bool found = false;
+      if (refreshIndex()) {
+        entryMap::iterator it = entries.find(key);
+        if (it != entries.end()) {
+          entry = it->second;
+          found = true;
+        }
+      }
+      mutex_.unlock();
+      return found;
+    }
+
+    void pack_t::evict(const udim_t targetBytes) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      // Called with the pack lock held
+      if (!mappedPtr) {
+        return;
+      }
+
+      // Files of a cache entry share its directory and are evicted
+      //   together so packed binaries always come with their metadata
+      typedef std::map<std::string, udim_t> dirBytesMap;
+      typedef std::map<udim_t, std::string> offsetDirMap;
+      dirBytesMap dirBytes;
+      dirBytesMap dirLastOffset;
+
+      entryMap::iterator it = entries.begin();
+      while (it != entries.end()) {
+        const std::string &key = it->first;
+        const entry_t &entry = it->second;
+        const std::string dir = key.substr(0, key.rfind('/') + 1);
+
+        dirBytes[dir] += packHeaderBytes + key.size() + entry.bytes;
+        udim_t &lastOffset = dirLastOffset[dir];
+        if (lastOffset < entry.offset) {
+          lastOffset = entry.offset;
+        }
+        ++it;
+      }
+
+      // Keep the most recently packed entries
+      offsetDirMap dirsByAge;
+      dirBytesMap::iterator dirIt = dirLastOffset.begin();
+      while (dirIt != dirLastOffset.end()) {
+        dirsByAge[dirIt->second] = dirIt->first;
+        ++dirIt;
+      }
+
+      std::map<std::string, bool> keptDirs;
+      udim_t keptBytes = packFileHeaderBytes;
+      offsetDirMap::reverse_iterator ageIt = dirsByAge.rbegin();
+      while (ageIt != dirsByAge.rend()) {
+        const udim_t bytes = dirBytes[ageIt->second];
+        if ((keptBytes + bytes) > targetBytes) {
+          break;
+        }
+        keptDirs[ageIt->second] = true;
+        keptBytes += bytes;
+        ++ageIt;
+      }
+
+      // Write kept records in their original order
+      std::map<udim_t, std::string> keptKeys;
+      it = entries.begin();
+      while (it != entries.end()) {
+        const std::string &key = it->first;
+        if (keptDirs.count(key.substr(0, key.rfind('/') + 1))) {
+          keptKeys[it->second.offset] = key;
+        }
+        ++it;
+      }
+
+      // Readers keep their mapping of the old pack until they notice
+      //   the new generation
+      const std::string tmpFilename = filename + ".tmp." + toString(sys::getPID());
+      const int fd = ::open(tmpFilename.c_str(),
+                            O_WRONLY | O_CREAT | O_TRUNC,
+                            0644);
+      if (fd < 0) {
+        return;
+      }
+      const std::string header = fileHeader(newGeneration());
+      bool wrote = writeAll(fd, header.c_str(), header.size());
+
+      std::map<udim_t, std::string>::iterator keyIt = keptKeys.begin();
+      while (wrote && (keyIt != keptKeys.end())) {
+        const std::string &key = keyIt->second;
+        const entry_t &entry = entries[key];
+        const char *recordStart = mappedPtr + entry.offset - key.size() - packHeaderBytes;
+        wrote = writeAll(fd,
+                         recordStart,
+                         packHeaderBytes + key.size() + entry.bytes);
+        ++keyIt;
+      }
+      ::fsync(fd);
+      ::close(fd);
+
+      if (!wrote ||
+          ::rename(tmpFilename.c_str(), filename.c_str())) {
+        ::remove(tmpFilename.c_str());
+        return;
+      }
+      refreshIndex();
+#endif
+    }
+
+    bool usingCachePack() {
+      return env::OCCA_CACHE_PACK;
+    }
+
+    const std::string& cachePackFilename() {
+      static std::string filename;
+      if (filename.size() == 0) {
+        filename = env::OCCA_CACHE_DIR + "cache.pack";
+      }
+      return filename;
+    }
+
+    pack_t& cachePack() {
+      static pack_t pack(cachePackFilename());
+      return pack;
+    }
+  }
+}
@@ -1,3 +1,4 @@
+#include <cstdio>
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -32,12 +33,20 @@ namespace occa {
     const std::string launcherSourceFile = "launcher_source.cpp";
     const std::string buildFile          = "build.json";
     const std::string launcherBuildFile  = "launcher_build.json";
+    const std::string buildMetadataFile  = "build_metadata.bin";
+    const std::string launcherBuildMetadataFile = "launcher_build_metadata.bin";
+    const std::string pgoProfileDir      = "pgo_profile/";
+    const std::string pgoProfileMarker   = "pgo_profile";
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
     const std::string binaryFile         = "binary";
     const std::string launcherBinaryFile = "launcher_binary";
+    const std::string pgoInstrumentedBinaryFile = "pgo_instrumented_binary";
+    const std::string pgoBinaryFile      = "pgo_binary";
 #else
     const std::string binaryFile         = "binary.dll";
     const std::string launcherBinaryFile = "launcher_binary.dll";
+    const std::string pgoInstrumentedBinaryFile = "pgo_instrumented_binary.dll";
+    const std::string pgoBinaryFile      = "pgo_binary.dll";
 #endif
   }
 
@@ -51,6 +60,11 @@ namespace occa {
 #endif
 
     const std::string& cachePath() {
+      // The cache pack replaces the shared kernel directories, kernels
+      //   are staged in the node-local cache and only the pack is shared
+      if (env::OCCA_CACHE_PACK) {
+        return localCachePath();
+      }
       static std::string path;
       if (path.size() == 0) {
         path = env::OCCA_CACHE_DIR + "cache/";
@@ -58,6 +72,15 @@ namespace occa {
       return path;
     }
 
+    const std::string& localCachePath() {
+      static std::string path;
+      if (path.size() == 0 &&
+          env::OCCA_LOCAL_CACHE_DIR.size()) {
+        path = env::OCCA_LOCAL_CACHE_DIR + "cache/";
+      }
+      return path;
+    }
+
     const std::string& libraryPath() {
       static std::string path;
       if (path.size() == 0) {
@@ -391,10 +414,55 @@ namespace occa {
       OCCA_ERROR("Failed to open [" << io::shortname(expFilename) << "]",
                  fp != 0);
 
-      fputs(content.c_str(), fp);
+      fwrite(content.c_str(), sizeof(char), content.size(), fp);
 
       fsync(fileno(fp));
       fclose(fp);
     }
+
+    bool copy(const std::string &source,
+              const std::string &destination) {
+      const std::string expSource = io::filename(source);
+      const std::string expDestination = io::filename(destination);
+      sys::mkpath(dirname(expDestination));
+
+      FILE *in = fopen(expSource.c_str(), "rb");
+      if (!in) {
+        return false;
+      }
+
+      // Write to a process-unique file and rename it so concurrent
+      //   readers never see a partially copied file
+      const std::string tmpDestination = (
+        expDestination + ".tmp." + toString(sys::getPID())
+      );
+      FILE *out = fopen(tmpDestination.c_str(), "wb");
+      if (!out) {
+        fclose(in);
+        return false;
+      }
+
+      char buffer[BUFSIZ];
+      bool copied = true;
+      size_t bytes;
+      while ((bytes = fread(buffer, sizeof(char), BUFSIZ, in)) > 0) {
+        if (fwrite(buffer, sizeof(char), bytes, out) != bytes) {
+          copied = false;
+          break;
+        }
+      }
+      copied = copied && !ferror(in);
+
+      fclose(in);
+      fclose(out);
+
+      if (copied) {
+        copied = !::rename(tmpDestination.c_str(), expDestination.c_str());
+      }
+      if (!copied) {
+        ::remove(tmpDestination.c_str());
+      }
+      return copied;
+    }
   }
 }
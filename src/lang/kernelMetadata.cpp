@@ -1,9 +1,60 @@
+#include <cstdio>
+#include <cstring>
+
 #include <occa/lang/kernelMetadata.hpp>
 #include <occa/io/utils.hpp>
 #include <occa/tools/properties.hpp>
+#include <occa/tools/string.hpp>
+#include <occa/tools/sys.hpp>
 
 namespace occa {
   namespace lang {
+    //---[ Metadata File ]--------------
+    // Layout:
+    //   magic, version, payload bytes
+    //   kernels      : name, arguments (const, ptr, dtype, name)
+    //   dependencies : filename, hash
+    //   macro references
+    // Builtin dtypes are stored by name, others as their JSON
+    static const char metadataMagic[] = "OCCAMETA";
+    static const uint32_t metadataVersion = 1;
+
+    static void writeUInt32(std::string &out,
+                            const uint32_t value) {
+      out.append((const char*) &value, sizeof(value));
+    }
+
+    static void writeString(std::string &out,
+                            const std::string &str) {
+      writeUInt32(out, (uint32_t) str.size());
+      out += str;
+    }
+
+    static bool readUInt32(const char *&c,
+                           const char *end,
+                           uint32_t &value) {
+      if ((size_t) (end - c) < sizeof(value)) {
+        return false;
+      }
+      ::memcpy(&value, c, sizeof(value));
+      c += sizeof(value);
+      return true;
+    }
+
+    static bool readString(const char *&c,
+                           const char *end,
+                           std::string &str) {
+      uint32_t chars;
+      if (!readUInt32(c, end, chars)
+          || ((size_t) (end - c) < chars)) {
+        return false;
+      }
+      str.assign(c, chars);
+      c += chars;
+      return true;
+    }
+    //==================================
+
     argMetadata_t::argMetadata_t() :
         isConst(false),
         isPtr(false),
@@ -101,9 +152,180 @@ namespace occa {
       return metadataJson;
     }
 
+    json sourceMetadata_t::getMacroReferencesJson() const {
+      json metadataJson(json::array_);
+
+      const int referenceCount = (int) macroReferences.size();
+      for (int i = 0; i < referenceCount; ++i) {
+        metadataJson += macroReferences[i];
+      }
+
+      return metadataJson;
+    }
+
+    std::string sourceMetadata_t::metadataFilename(const std::string &buildFilename) {
+      std::string filename = buildFilename;
+      if (endsWith(filename, ".json")) {
+        filename.resize(filename.size() - 5);
+      }
+      return filename + "_metadata.bin";
+    }
+
+    void sourceMetadata_t::writeMetadataFile(const std::string &filename) const {
+      std::string payload;
+
+      writeUInt32(payload, (uint32_t) kernelsMetadata.size());
+      kernelMetadataMap::const_iterator kernelIt = kernelsMetadata.begin();
+      while (kernelIt != kernelsMetadata.end()) {
+        const kernelMetadata_t &kernel = kernelIt->second;
+        writeString(payload, kernel.name);
+
+        const int argumentCount = (int) kernel.arguments.size();
+        writeUInt32(payload, (uint32_t) argumentCount);
+        for (int i = 0; i < argumentCount; ++i) {
+          const argMetadata_t &arg = kernel.arguments[i];
+          payload += (char) arg.isConst;
+          payload += (char) arg.isPtr;
+
+          const json dtypeJson = arg.dtype.toJson();
+          const bool isBuiltin = (dtypeJson["type"].toString() == "builtin");
+          payload += (char) isBuiltin;
+          writeString(payload,
+                      isBuiltin
+                      ? dtypeJson["name"].toString()
+                      : dtypeJson.dump(0));
+          writeString(payload, arg.name);
+        }
+        ++kernelIt;
+      }
+
+      writeUInt32(payload, (uint32_t) dependencyHashes.size());
+      strHashMap::const_iterator depIt = dependencyHashes.begin();
+      while (depIt != dependencyHashes.end()) {
+        writeString(payload, depIt->first);
+        writeString(payload, depIt->second.getFullString());
+        ++depIt;
+      }
+
+      const int referenceCount = (int) macroReferences.size();
+      writeUInt32(payload, (uint32_t) referenceCount);
+      for (int i = 0; i < referenceCount; ++i) {
+        writeString(payload, macroReferences[i]);
+      }
+
+      std::string contents(metadataMagic, sizeof(metadataMagic) - 1);
+      writeUInt32(contents, metadataVersion);
+      writeUInt32(contents, (uint32_t) payload.size());
+      contents += payload;
+
+      // Readers fall back to the build file, so only a complete file
+      //   is renamed into place
+      const std::string tmpFilename = (
+        io::filename(filename) + ".tmp." + toString(sys::getPID())
+      );
+      io::write(tmpFilename, contents);
+      if (::rename(tmpFilename.c_str(), io::filename(filename).c_str())) {
+        ::remove(tmpFilename.c_str());
+      }
+    }
+
+    bool sourceMetadata_t::loadMetadataFile(const std::string &filename,
+                                            sourceMetadata_t &metadata) {
+      if (!io::isFile(filename)) {
+        return false;
+      }
+      const std::string contents = io::read(filename, true);
+      const char *c = contents.c_str();
+      const char *end = c + contents.size();
+
+      const size_t magicChars = sizeof(metadataMagic) - 1;
+      uint32_t version, payloadBytes;
+      if ((contents.size() < magicChars)
+          || ::strncmp(c, metadataMagic, magicChars)) {
+        return false;
+      }
+      c += magicChars;
+      if (!readUInt32(c, end, version)
+          || (version != metadataVersion)
+          || !readUInt32(c, end, payloadBytes)
+          || ((size_t) (end - c) != payloadBytes)) {
+        return false;
+      }
+
+      sourceMetadata_t loaded;
+
+      uint32_t kernelCount;
+      if (!readUInt32(c, end, kernelCount)) {
+        return false;
+      }
+      for (uint32_t k = 0; k < kernelCount; ++k) {
+        kernelMetadata_t kernel;
+        kernel.initialized = true;
+
+        uint32_t argumentCount;
+        if (!readString(c, end, kernel.name)
+            || !readUInt32(c, end, argumentCount)) {
+          return false;
+        }
+        for (uint32_t i = 0; i < argumentCount; ++i) {
+          if ((end - c) < 3) {
+            return false;
+          }
+          argMetadata_t arg;
+          arg.isConst = c[0];
+          arg.isPtr = c[1];
+          const bool isBuiltin = c[2];
+          c += 3;
+
+          std::string dtypeStr;
+          if (!readString(c, end, dtypeStr)
+              || !readString(c, end, arg.name)) {
+            return false;
+          }
+          arg.dtype = (isBuiltin
+                       ? dtype_t::getBuiltin(dtypeStr)
+                       : dtype_t::fromJson(dtypeStr));
+          kernel.arguments.push_back(arg);
+        }
+        loaded.kernelsMetadata[kernel.name] = kernel;
+      }
+
+      uint32_t dependencyCount;
+      if (!readUInt32(c, end, dependencyCount)) {
+        return false;
+      }
+      for (uint32_t i = 0; i < dependencyCount; ++i) {
+        std::string dependency, dependencyHash;
+        if (!readString(c, end, dependency)
+            || !readString(c, end, dependencyHash)) {
+          return false;
+        }
+        loaded.dependencyHashes[dependency] = hash_t::fromString(dependencyHash);
+      }
+
+      uint32_t referenceCount;
+      if (!readUInt32(c, end, referenceCount)) {
+        return false;
+      }
+      for (uint32_t i = 0; i < referenceCount; ++i) {
+        std::string reference;
+        if (!readString(c, end, reference)) {
+          return false;
+        }
+        loaded.macroReferences.push_back(reference);
+      }
+
+      metadata = loaded;
+      return true;
+    }
+
     sourceMetadata_t sourceMetadata_t::fromBuildFile(const std::string &filename) {
       sourceMetadata_t metadata;
 
+      if (loadMetadataFile(metadataFilename(filename), metadata)) {
+        return metadata;
+      }
+
       if (!io::exists(filename)) {
         return metadata;
       }
@@ -111,6 +333,7 @@ namespace occa {
       properties props = properties::read(filename);
       jsonArray &kernelMetadata = props["kernel/metadata"].array();
       jsonObject &dependencyHashes_ = props["kernel/dependencies"].object();
+      jsonArray &macroReferences = props["kernel/macro_references"].array();
 
       kernelMetadataMap &metadataMap = metadata.kernelsMetadata;
       const int kernelCount = (int) kernelMetadata.size();
@@ -125,6 +348,11 @@ namespace occa {
         ++it;
       }
 
+      const int referenceCount = (int) macroReferences.size();
+      for (int i = 0; i < referenceCount; ++i) {
+        metadata.macroReferences.push_back(macroReferences[i]);
+      }
+
       return metadata;
     }
   }
@@ -23,6 +23,7 @@ namespace occa {
 
       void metalParser::beforePreprocessing() {
         preprocessor.addCompilerDefine("OCCA_USING_GPU", "1");
+        preprocessor.addCompilerDefine("OCCA_USING_METAL", "1");
       }
 
       void metalParser::beforeKernelSplit() {
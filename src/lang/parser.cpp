@@ -148,6 +148,8 @@ namespace occa {
         const std::string &dependency = dependencies[i];
         dependencyHashes[dependency] = hashFile(dependency);
       }
+
+      sourceMetadata.macroReferences = preprocessor.getMacroReferences();
     }
     //==================================
 
@@ -285,6 +287,14 @@ namespace occa {
       loadAllStatements();
       if (!success) return;
 
+      if (settings.has("okl/specialized_arguments")) {
+        success &= transforms::applySpecializeTransforms(
+          root,
+          settings["okl/specialized_arguments"]
+        );
+        if (!success) return;
+      }
+
       if (restrictQualifier) {
         success &= transforms::applyRestrictTransforms(root,
                                                        *restrictQualifier);
@@ -155,6 +155,7 @@ namespace occa {
       sourceMacros.clear();
 
       dependencies.clear();
+      macroReferences.clear();
     }
 
     preprocessor_t& preprocessor_t::operator = (const preprocessor_t &other) {
@@ -169,9 +170,10 @@ namespace occa {
       compilerMacros = other.compilerMacros;
       sourceMacros   = other.sourceMacros;
 
-      dependencies = other.dependencies;
-      warnings     = other.warnings;
-      errors       = other.errors;
+      dependencies    = other.dependencies;
+      macroReferences = other.macroReferences;
+      warnings        = other.warnings;
+      errors          = other.errors;
 
       includePaths = other.includePaths;
 
@@ -412,6 +414,8 @@ namespace occa {
     }
 
     macro_t* preprocessor_t::getMacro(const std::string &name) {
+      macroReferences[name] = true;
+
       macroMap::iterator it = sourceMacros.find(name);
       if (it != sourceMacros.end()) {
         return it->second;
@@ -480,6 +484,19 @@ namespace occa {
 
       return deps;
     }
+
+    strVector preprocessor_t::getMacroReferences() const {
+      strVector names;
+      names.reserve(macroReferences.size());
+
+      strToBoolMap::const_iterator it = macroReferences.begin();
+      while (it != macroReferences.end()) {
+        names.push_back(it->first);
+        ++it;
+      }
+
+      return names;
+    }
     //==================================
 
     void preprocessor_t::loadTokenizer() {
@@ -1216,7 +1233,7 @@ namespace occa {
       // TODO: Error if the definitions aren't the same
       macroMap::iterator it = sourceMacros.find(name);
       if (it != sourceMacros.end()) {
-        delete getMacro(name);
+        delete it->second;
         sourceMacros.erase(it);
       }
       sourceMacros[name] = &macro;
@@ -1241,13 +1258,12 @@ namespace occa {
         skipToNewline();
         return;
       }
-      // Remove macro
+      // Remove macro, including defines from properties and compiler
+      //   defines which are added back when the preprocessor is cleared
       const std::string &macroName = token->to<identifierToken>().value;
-      delete getMacro(macroName);
-      macroMap::iterator it = sourceMacros.find(macroName);
-      if (it != sourceMacros.end()) {
-        sourceMacros.erase(it);
-      }
+      macroReferences[macroName] = true;
+      removeSourceDefine(macroName);
+      removeCompilerDefine(macroName);
       delete token;
     }
 
@@ -0,0 +1,75 @@
+#include <occa/lang/expr.hpp>
+#include <occa/lang/statement.hpp>
+#include <occa/lang/variable.hpp>
+#include <occa/lang/transforms/builtins/specialize.hpp>
+#include <occa/tools/json.hpp>
+
+namespace occa {
+  namespace lang {
+    namespace transforms {
+      argumentSpecializer_t::argumentSpecializer_t() :
+        statementExprTransform(exprNodeType::variable),
+        arg(NULL) {}
+
+      void argumentSpecializer_t::set(const variable_t &arg_,
+                                      const primitive &value_) {
+        arg   = &arg_;
+        value = value_;
+      }
+
+      exprNode* argumentSpecializer_t::transformExprNode(exprNode &node) {
+        if (!arg) {
+          return &node;
+        }
+        variable_t &var = ((variableNode&) node).value;
+        if (&var != arg) {
+          return &node;
+        }
+        // Keep negative values from merging with neighboring operators
+        primitiveNode valueNode(node.token, value);
+        if (value.toString()[0] == '-') {
+          return new parenthesesNode(node.token, valueNode);
+        }
+        return valueNode.clone();
+      }
+
+      bool applySpecializeTransforms(blockStatement &root,
+                                     const json &specializedArgs) {
+        if (!specializedArgs.isObject()) {
+          return true;
+        }
+        const jsonObject &values = specializedArgs.object();
+
+        statementPtrVector kernelSmnts;
+        findStatementsByAttr(statementType::functionDecl,
+                             "kernel",
+                             root,
+                             kernelSmnts);
+
+        argumentSpecializer_t specializer;
+        const int kernelCount = (int) kernelSmnts.size();
+        for (int i = 0; i < kernelCount; ++i) {
+          functionDeclStatement &declSmnt = *((functionDeclStatement*) kernelSmnts[i]);
+          function_t &func = declSmnt.function;
+
+          const int argc = (int) func.args.size();
+          for (int ai = 0; ai < argc; ++ai) {
+            variable_t *arg = func.args[ai];
+            if (!arg || arg->vartype.isPointerType()) {
+              continue;
+            }
+            jsonObject::const_iterator it = values.find(arg->name());
+            if ((it == values.end()) || !it->second.isNumber()) {
+              continue;
+            }
+            specializer.set(*arg, it->second.number());
+            if (!specializer.statementTransform::apply(declSmnt)) {
+              return false;
+            }
+          }
+        }
+        return true;
+      }
+    }
+  }
+}
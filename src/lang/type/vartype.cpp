@@ -172,6 +172,15 @@ namespace occa {
       }
 
       dtype_t dtype = type->dtype();
+      // long and long long are int qualifiers
+      if (dtype == dtype::int_) {
+        if (has(longlong_)) {
+          dtype = dtype::int64;
+        } else if (has(long_)) {
+          dtype = dtype::long_;
+        }
+      }
+
       const int arrayCount = (int) arrays.size();
       for (int i = 0; i < arrayCount; ++i) {
         primitive primSize = arrays[i].size->evaluate();
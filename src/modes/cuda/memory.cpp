@@ -43,6 +43,18 @@ namespace occa {
       return kernelArg(arg);
     }
 
+    kernelArg memory::makeOffsetKernelArg(const udim_t offset) {
+      kernelArgData arg;
+
+      // Store the offset pointer by value, ptr() points to it
+      arg.modeMemory = this;
+      arg.data.uint64_ = (uint64_t) (cuPtr + offset);
+      arg.size       = sizeof(void*);
+      arg.info       = kArgInfo::none;
+
+      return kernelArg(arg);
+    }
+
     modeMemory_t* memory::addOffset(const dim_t offset) {
       memory *m = new memory(modeDevice,
                              size - offset,
@@ -65,8 +77,8 @@ namespace occa {
     void memory::copyFrom(const void *src,
                           const udim_t bytes,
                           const udim_t offset,
-                          const occa::properties &props) {
-      const bool async = props.get("async", false);
+                          const copyOptions &options) {
+      const bool async = options.async;
 
       if (!async) {
         OCCA_CUDA_ERROR("Memory: Copy From",
@@ -86,8 +98,8 @@ namespace occa {
                           const udim_t bytes,
                           const udim_t destOffset,
                           const udim_t srcOffset,
-                          const occa::properties &props) {
-      const bool async = props.get("async", false);
+                          const copyOptions &options) {
+      const bool async = options.async;
 
       if (!async) {
         OCCA_CUDA_ERROR("Memory: Copy From",
@@ -106,8 +118,8 @@ namespace occa {
     void memory::copyTo(void *dest,
                         const udim_t bytes,
                         const udim_t offset,
-                        const occa::properties &props) const {
-      const bool async = props.get("async", false);
+                        const copyOptions &options) const {
+      const bool async = options.async;
 
       if (!async) {
         OCCA_CUDA_ERROR("Memory: Copy From",
@@ -48,6 +48,17 @@ namespace occa {
       return kernelArg(arg);
     }
 
+    kernelArg memory::makeOffsetKernelArg(const udim_t offset) {
+      kernelArgData arg;
+
+      arg.modeMemory = this;
+      arg.data.void_ = (void*) addHipPtrOffset(hipPtr, offset);
+      arg.size       = sizeof(void*);
+      arg.info       = kArgInfo::usePointer;
+
+      return kernelArg(arg);
+    }
+
     modeMemory_t* memory::addOffset(const dim_t offset) {
       memory *m = new memory(modeDevice,
                              size - offset,
@@ -69,8 +80,8 @@ namespace occa {
     void memory::copyFrom(const void *src,
                           const udim_t bytes,
                           const udim_t offset,
-                          const occa::properties &props) {
-      const bool async = props.get("async", false);
+                          const copyOptions &options) {
+      const bool async = options.async;
 
       if (!async) {
         OCCA_HIP_ERROR("Memory: Copy From",
@@ -90,8 +101,8 @@ namespace occa {
                           const udim_t bytes,
                           const udim_t destOffset,
                           const udim_t srcOffset,
-                          const occa::properties &props) {
-      const bool async = props.get("async", false);
+                          const copyOptions &options) {
+      const bool async = options.async;
 
       if (!async) {
         OCCA_HIP_ERROR("Memory: Copy From",
@@ -110,8 +121,8 @@ namespace occa {
     void memory::copyTo(void *dest,
                         const udim_t bytes,
                         const udim_t offset,
-                        const occa::properties &props) const {
-      const bool async = props.get("async", false);
+                        const copyOptions &options) const {
+      const bool async = options.async;
 
       if (!async) {
         OCCA_HIP_ERROR("Memory: Copy From",
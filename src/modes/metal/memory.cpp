@@ -55,8 +55,8 @@ namespace occa {
     void memory::copyFrom(const void *src,
                           const udim_t bytes,
                           const udim_t offset,
-                          const occa::properties &props) {
-      const bool async = props.get("async", false);
+                          const copyOptions &options) {
+      const bool async = options.async;
 
       api::metal::commandQueue_t &metalCommandQueue = (
         ((metal::device*) modeDevice)->metalCommandQueue
@@ -72,8 +72,8 @@ namespace occa {
                           const udim_t bytes,
                           const udim_t destOffset,
                           const udim_t srcOffset,
-                          const occa::properties &props) {
-      const bool async = props.get("async", false);
+                          const copyOptions &options) {
+      const bool async = options.async;
 
       api::metal::commandQueue_t &metalCommandQueue = (
         ((metal::device*) modeDevice)->metalCommandQueue
@@ -89,9 +89,9 @@ namespace occa {
     void memory::copyTo(void *dest,
                         const udim_t bytes,
                         const udim_t offset,
-                        const occa::properties &props) const {
+                        const copyOptions &options) const {
 
-      const bool async = props.get("async", false);
+      const bool async = options.async;
 
       api::metal::commandQueue_t &metalCommandQueue = (
         ((metal::device*) modeDevice)->metalCommandQueue
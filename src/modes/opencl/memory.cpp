@@ -87,8 +87,8 @@ namespace occa {
     void memory::copyFrom(const void *src,
                           const udim_t bytes,
                           const udim_t offset,
-                          const occa::properties &props) {
-      const bool async = props.get("async", false);
+                          const copyOptions &options) {
+      const bool async = options.async;
 
       OCCA_OPENCL_ERROR("Memory: " << (async ? "Async " : "") << "Copy From",
                         clEnqueueWriteBuffer(getCommandQueue(),
@@ -102,8 +102,8 @@ namespace occa {
                           const udim_t bytes,
                           const udim_t destOffset,
                           const udim_t srcOffset,
-                          const occa::properties &props) {
-      const bool async = props.get("async", false);
+                          const copyOptions &options) {
+      const bool async = options.async;
 
       OCCA_OPENCL_ERROR("Memory: " << (async ? "Async " : "") << "Copy From",
                         clEnqueueCopyBuffer(getCommandQueue(),
@@ -117,9 +117,9 @@ namespace occa {
     void memory::copyTo(void *dest,
                         const udim_t bytes,
                         const udim_t offset,
-                        const occa::properties &props) const {
+                        const copyOptions &options) const {
 
-      const bool async = props.get("async", false);
+      const bool async = options.async;
 
       OCCA_OPENCL_ERROR("Memory: " << (async ? "Async " : "") << "Copy To",
                         clEnqueueReadBuffer(getCommandQueue(),
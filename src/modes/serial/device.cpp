@@ -1,7 +1,10 @@
+#include <cstdio>
+
 #include <occa/core/base.hpp>
 #include <occa/tools/env.hpp>
 #include <occa/io.hpp>
 #include <occa/tools/sys.hpp>
+#include <occa/tools/vector.hpp>
 #include <occa/modes/serial/device.hpp>
 #include <occa/modes/serial/kernel.hpp>
 #include <occa/modes/serial/memory.hpp>
@@ -12,7 +15,8 @@
 namespace occa {
   namespace serial {
     device::device(const occa::properties &properties_) :
-      occa::modeDevice_t(properties_) {
+      occa::modeDevice_t(properties_),
+      separateMemorySpace(properties_.get("separate_memory_space", false)) {
 
       occa::json &kernelProps = properties["kernel"];
       std::string compiler;
@@ -132,12 +136,17 @@ namespace occa {
     void device::finish() const {}
 
     bool device::hasSeparateMemorySpace() const {
-      return false;
+      return separateMemorySpace;
     }
 
     hash_t device::hash() const {
       if (!hash_.initialized) {
-        hash_ = occa::hash("host");
+        // Binaries built with flags like -march=native only run on
+        //   CPUs with the same features
+        hash_ = (
+          occa::hash("host")
+          ^ occa::hash(join(sys::getCpuFeatures(), ","))
+        );
       }
       return hash_;
     }
@@ -206,6 +215,82 @@ namespace occa {
       return true;
     }
 
+    static std::string getCompileCommand(const occa::properties &kernelProps,
+                                         const std::string &sourceFilename,
+                                         const std::string &binaryFilename,
+                                         const bool compilingOkl,
+                                         const std::string &extraFlags = "") {
+      std::stringstream command;
+      std::string compilerEnvScript = kernelProps["compiler_env_script"];
+      if (compilerEnvScript.size()) {
+        command << compilerEnvScript << " && ";
+      }
+
+      const std::string compiler = kernelProps["compiler"];
+      std::string compilerFlags = kernelProps["compiler_flags"];
+      std::string compilerLinkerFlags = kernelProps["compiler_linker_flags"];
+      std::string compilerSharedFlags = kernelProps["compiler_shared_flags"];
+
+      sys::addCompilerFlags(compilerFlags, compilerSharedFlags);
+      if (extraFlags.size()) {
+        sys::addCompilerFlags(compilerFlags, extraFlags);
+      }
+
+      if (!compilingOkl) {
+        sys::addCompilerIncludeFlags(compilerFlags);
+        sys::addCompilerLibraryFlags(compilerFlags);
+      }
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      command << compiler
+              << ' '    << compilerFlags
+              << ' '    << sourceFilename
+              << " -o " << binaryFilename
+              << " -I"  << env::OCCA_DIR << "include"
+              << " -I"  << env::OCCA_INSTALL_DIR << "include"
+              << " -L"  << env::OCCA_INSTALL_DIR << "lib -locca"
+              << ' '    << compilerLinkerFlags
+              << std::endl;
+#else
+      command << kernelProps["compiler"]
+              << " /D MC_CL_EXE"
+              << " /D OCCA_OS=OCCA_WINDOWS_OS"
+              << " /EHsc"
+              << " /wd4244 /wd4800 /wd4804 /wd4018"
+              << ' '       << compilerFlags
+              << " /I"     << env::OCCA_DIR << "include"
+              << " /I"     << env::OCCA_INSTALL_DIR << "include"
+              << ' '       << sourceFilename
+              << " /link " << env::OCCA_INSTALL_DIR << "lib/libocca.lib",
+              << ' '       << compilerLinkerFlags
+              << " /OUT:"  << binaryFilename
+              << std::endl;
+#endif
+
+      return strip(command.str());
+    }
+
+    static int runCompileCommand(const std::string &sCommand) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      return system(sCommand.c_str());
+#else
+      return system(("\"" +  sCommand + "\"").c_str());
+#endif
+    }
+
+    static std::string getCachedSourceFilename(const std::string &hashDir,
+                                               const occa::properties &kernelProps) {
+      const bool compilingOkl = kernelProps.get("okl/enabled", true);
+      const bool compilingCpp = (
+        ((int) kernelProps["compiler_language"]) == sys::language::CPP
+      );
+      return hashDir + (
+        compilingOkl
+        ? kc::sourceFile
+        : (compilingCpp ? kc::cppRawSourceFile : kc::cRawSourceFile)
+      );
+    }
+
     modeKernel_t* device::buildKernel(const std::string &filename,
                                       const std::string &kernelName,
                                       const hash_t kernelHash,
@@ -231,18 +316,33 @@ namespace occa {
         ? kc::launcherBinaryFile
         : kc::binaryFile
       );
+      strVector metadataFiles;
+      metadataFiles.push_back(kc::buildFile);
+      metadataFiles.push_back(kc::buildMetadataFile);
       std::string binaryFilename = hashDir + kcBinaryFile;
 
       // Check if binary exists and is finished
-      bool foundBinary = (
-        io::cachedFileIsComplete(hashDir, kcBinaryFile)
-        && io::isFile(binaryFilename)
-      );
+      const std::string cachedDir = io::findCachedFile(hashDir,
+                                                       kcBinaryFile,
+                                                       metadataFiles);
+      bool foundBinary = cachedDir.size();
+      if (foundBinary) {
+        binaryFilename = cachedDir + kcBinaryFile;
+      }
 
       io::lock_t lock;
       if (!foundBinary) {
         lock = io::lock_t(kernelHash, "serial-kernel");
-        foundBinary = !lock.isMine();
+        if (!lock.isMine()) {
+          // Another process built the binary
+          const std::string builtDir = io::findCachedFile(hashDir,
+                                                          kcBinaryFile,
+                                                          metadataFiles);
+          if (builtDir.size()) {
+            binaryFilename = builtDir + kcBinaryFile;
+          }
+          foundBinary = true;
+        }
       }
 
       const bool verbose = kernelProps.get("verbose", false);
@@ -259,6 +359,9 @@ namespace occa {
                                                 kernelProps);
         if (k) {
           k->sourceFilename = filename;
+          if (!isLauncherKernel) {
+            setupHostKernel((kernel&) *k, hashDir, kernelProps);
+          }
         }
         return k;
       }
@@ -305,79 +408,287 @@ namespace occa {
         }
       }
 
-      std::stringstream command;
-      std::string compilerEnvScript = kernelProps["compiler_env_script"];
-      if (compilerEnvScript.size()) {
-        command << compilerEnvScript << " && ";
-      }
-
-      const std::string compiler = kernelProps["compiler"];
-      std::string compilerFlags = kernelProps["compiler_flags"];
-      std::string compilerLinkerFlags = kernelProps["compiler_linker_flags"];
-      std::string compilerSharedFlags = kernelProps["compiler_shared_flags"];
-
-      sys::addCompilerFlags(compilerFlags, compilerSharedFlags);
-
-      if (!compilingOkl) {
-        sys::addCompilerIncludeFlags(compilerFlags);
-        sys::addCompilerLibraryFlags(compilerFlags);
+      const std::string sCommand = getCompileCommand(kernelProps,
+                                                     sourceFilename,
+                                                     binaryFilename,
+                                                     compilingOkl);
+
+      // Generated sources are self-contained, so kernels whose props only
+      //   differ in keys that don't change the output can share binaries
+      const bool canShareBinary = compilingOkl || isLauncherKernel;
+      hash_t binaryHash;
+      if (canShareBinary) {
+        binaryHash = (
+          io::compiledBinaryHash(sourceFilename, sCommand, hashDir)
+          ^ hash()
+        );
       }
 
-#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
-      command << compiler
-              << ' '    << compilerFlags
-              << ' '    << sourceFilename
-              << " -o " << binaryFilename
-              << " -I"  << env::OCCA_DIR << "include"
-              << " -I"  << env::OCCA_INSTALL_DIR << "include"
-              << " -L"  << env::OCCA_INSTALL_DIR << "lib -locca"
-              << ' '    << compilerLinkerFlags
-              << std::endl;
-#else
-      command << kernelProps["compiler"]
-              << " /D MC_CL_EXE"
-              << " /D OCCA_OS=OCCA_WINDOWS_OS"
-              << " /EHsc"
-              << " /wd4244 /wd4800 /wd4804 /wd4018"
-              << ' '       << compilerFlags
-              << " /I"     << env::OCCA_DIR << "include"
-              << " /I"     << env::OCCA_INSTALL_DIR << "include"
-              << ' '       << sourceFilename
-              << " /link " << env::OCCA_INSTALL_DIR << "lib/libocca.lib",
-              << ' '       << compilerLinkerFlags
-              << " /OUT:"  << binaryFilename
-              << std::endl;
-#endif
+      int compileError = 0;
+      if (canShareBinary &&
+          io::loadSharedBinary(binaryHash, binaryFilename)) {
+        if (verbose) {
+          io::stdout << "Reusing compiled binary for [" << kernelName << "] from ["
+                     << io::shortname(io::binaryHashDir(binaryHash)) << "]\n";
+        }
+      } else {
+        if (verbose) {
+          io::stdout << "Compiling [" << kernelName << "]\n" << sCommand << "\n";
+        }
 
-      const std::string &sCommand = strip(command.str());
+        compileError = runCompileCommand(sCommand);
 
-      if (verbose) {
-        io::stdout << "Compiling [" << kernelName << "]\n" << sCommand << "\n";
+        if (!compileError && canShareBinary) {
+          io::storeSharedBinary(binaryHash, binaryFilename);
+        }
       }
 
-#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
-      const int compileError = system(sCommand.c_str());
-#else
-      const int compileError = system(("\"" +  sCommand + "\"").c_str());
-#endif
-
-      lock.release();
       if (compileError) {
+        lock.release();
         OCCA_FORCE_ERROR("Error compiling [" << kernelName << "],"
                          " Command: [" << sCommand << ']');
       }
 
-      modeKernel_t *k = buildKernelFromBinary(binaryFilename,
+      // Store the binary in the node-local cache or cache pack before
+      //   releasing the lock so waiting processes can find it
+      const std::string loadDir = io::storeCachedFile(hashDir,
+                                                      kcBinaryFile,
+                                                      metadataFiles);
+      lock.release();
+
+      modeKernel_t *k = buildKernelFromBinary(loadDir + kcBinaryFile,
                                               kernelName,
                                               kernelProps,
                                               metadata.kernelsMetadata[kernelName]);
       if (k) {
         io::markCachedFileComplete(hashDir, kcBinaryFile);
         k->sourceFilename = filename;
+        if (!isLauncherKernel) {
+          setupHostKernel((kernel&) *k, hashDir, kernelProps);
+        }
       }
       return k;
     }
 
+    void device::setupHostKernel(kernel &k,
+                                 const std::string &hashDir,
+                                 const occa::properties &kernelProps) {
+      // Kernels with target ISAs don't collect profiles
+      if (kernelProps["target_isas"].isArray()) {
+        setupIsaKernel(k, hashDir, kernelProps);
+      } else if (kernelProps.get("pgo", false)) {
+        setupPgoKernel(k, hashDir, kernelProps);
+      }
+    }
+
+    void device::setupIsaKernel(kernel &k,
+                                const std::string &hashDir,
+                                const occa::properties &kernelProps) {
+      const bool verbose = kernelProps.get("verbose", false);
+      const int vendor = kernelProps.get("compiler_vendor", 0);
+
+      // Pick the most capable target the current CPU supports
+      const strVector cpuIsas = sys::getCpuIsas();
+      const jsonArray &targetIsas = kernelProps["target_isas"].array();
+      const int targetCount = (int) targetIsas.size();
+
+      std::string isa;
+      int isaRank = -1;
+      for (int i = 0; i < targetCount; ++i) {
+        if (!targetIsas[i].isString()) {
+          continue;
+        }
+        const std::string &targetIsa = targetIsas[i].string();
+        const int rank = (int) indexOf(cpuIsas, targetIsa);
+        if ((rank > isaRank)
+            && sys::compilerIsaFlags(vendor, targetIsa).size()) {
+          isa = targetIsa;
+          isaRank = rank;
+        }
+      }
+      if (!isa.size()) {
+        if (verbose) {
+          io::stdout << "No target ISA for [" << k.name << "] is supported,"
+                     << " using the baseline binary\n";
+        }
+        return;
+      }
+
+      const std::string isaBinaryFile = kc::binaryFile + "_" + isa;
+      const std::string isaBinaryFilename = hashDir + isaBinaryFile;
+
+      if (!io::cachedFileIsComplete(hashDir, isaBinaryFile)) {
+        const std::string sourceFilename = getCachedSourceFilename(hashDir, kernelProps);
+        if (!io::isFile(sourceFilename)) {
+          return;
+        }
+
+        io::lock_t lock(occa::hash(isaBinaryFilename), "serial-isa");
+        if (lock.isMine()) {
+          const std::string sCommand = getCompileCommand(
+            kernelProps,
+            sourceFilename,
+            isaBinaryFilename,
+            kernelProps.get("okl/enabled", true),
+            sys::compilerIsaFlags(vendor, isa)
+          );
+          if (verbose) {
+            io::stdout << "Compiling [" << k.name << "] for [" << isa << "]\n" << sCommand << "\n";
+          }
+          if (runCompileCommand(sCommand)) {
+            return;
+          }
+          io::markCachedFileComplete(hashDir, isaBinaryFile);
+        } else if (!io::cachedFileIsComplete(hashDir, isaBinaryFile)) {
+          return;
+        }
+      }
+
+      if (verbose) {
+        io::stdout << "Loading [" << k.name << "] for [" << isa << "] from ["
+                   << io::shortname(isaBinaryFilename) << "]\n";
+      }
+      k.loadBinary(isaBinaryFilename);
+    }
+
+    // Compiles the binary using profiles in [hashDir], expects the caller
+    //   to hold the serial-pgo lock
+    static bool compilePgoBinary(const std::string &kernelName,
+                                 const std::string &hashDir,
+                                 const occa::properties &kernelProps) {
+      const std::string pgoBinaryFilename = hashDir + kc::pgoBinaryFile;
+      const std::string profileDir = hashDir + kc::pgoProfileDir;
+      const std::string sourceFilename = getCachedSourceFilename(hashDir, kernelProps);
+      const bool verbose = kernelProps.get("verbose", false);
+
+      // Build next to the final binary and rename it so processes
+      //   with the binary loaded keep their mapping
+      const std::string tempFilename = pgoBinaryFilename + ".tmp";
+      const std::string sCommand = getCompileCommand(
+        kernelProps,
+        sourceFilename,
+        tempFilename,
+        kernelProps.get("okl/enabled", true),
+        "-fprofile-use=" + profileDir
+        + " -fprofile-correction -Wno-missing-profile -dumpbase pgo"
+      );
+      if (verbose) {
+        io::stdout << "Compiling profile-optimized [" << kernelName << "]\n" << sCommand << "\n";
+      }
+      if (runCompileCommand(sCommand)
+          || ::rename(tempFilename.c_str(), pgoBinaryFilename.c_str())) {
+        ::remove(tempFilename.c_str());
+        return false;
+      }
+      io::markCachedFileComplete(hashDir, kc::pgoBinaryFile);
+      return true;
+    }
+
+    void device::setupPgoKernel(kernel &k,
+                                const std::string &hashDir,
+                                const occa::properties &kernelProps) {
+      const std::string instrumentedFilename = hashDir + kc::pgoInstrumentedBinaryFile;
+      const std::string pgoBinaryFilename = hashDir + kc::pgoBinaryFile;
+      const std::string profileDir = hashDir + kc::pgoProfileDir;
+      const bool verbose = kernelProps.get("verbose", false);
+
+      // Profiles are only collected with GCC-compatible flags
+      const int vendor = kernelProps.get("compiler_vendor", 0);
+      if (!(vendor & sys::vendor::GNU)) {
+        if (verbose) {
+          io::stdout << "Skipping PGO for [" << k.name << "], only supported with GCC\n";
+        }
+        return;
+      }
+
+      if (!io::cachedFileIsComplete(hashDir, kc::pgoBinaryFile)) {
+        const bool compilingOkl = kernelProps.get("okl/enabled", true);
+        const std::string sourceFilename = getCachedSourceFilename(hashDir, kernelProps);
+
+        // The source is needed to rebuild with the profile
+        if (!io::isFile(sourceFilename)) {
+          return;
+        }
+
+        io::lock_t lock(occa::hash(hashDir), "serial-pgo");
+        if (!lock.isMine()) {
+          // Another process compiled one of the PGO binaries
+          if (!io::cachedFileIsComplete(hashDir, kc::pgoBinaryFile)) {
+            return;
+          }
+        } else if (!io::cachedFileIsComplete(hashDir, kc::pgoProfileMarker)
+                   || kernel::isProfiling(hashDir)) {
+          if (!io::cachedFileIsComplete(hashDir, kc::pgoInstrumentedBinaryFile)) {
+            // GCC names profiles after the output file unless -dumpbase
+            //   is given, both binaries use the same one to share them
+            const std::string sCommand = getCompileCommand(
+              kernelProps,
+              sourceFilename,
+              instrumentedFilename,
+              compilingOkl,
+              "-fprofile-generate=" + profileDir
+              + " -fprofile-update=prefer-atomic -dumpbase pgo"
+            );
+            if (verbose) {
+              io::stdout << "Compiling instrumented [" << k.name << "]\n" << sCommand << "\n";
+            }
+            if (runCompileCommand(sCommand)) {
+              ::remove(instrumentedFilename.c_str());
+              return;
+            }
+            io::markCachedFileComplete(hashDir, kc::pgoInstrumentedBinaryFile);
+          }
+
+          // Profiles from previous processes are merged with the new ones
+          if (verbose) {
+            io::stdout << "Loading instrumented [" << k.name << "] from ["
+                       << io::shortname(instrumentedFilename) << "]\n";
+          }
+          k.startProfiling(hashDir,
+                           instrumentedFilename,
+                           kernelProps.get("pgo_launches", 10));
+          return;
+        } else if (!compilePgoBinary(k.name, hashDir, kernelProps)) {
+          return;
+        }
+      }
+
+      if (verbose) {
+        io::stdout << "Loading profile-optimized [" << k.name << "] from ["
+                   << io::shortname(pgoBinaryFilename) << "]\n";
+      }
+      k.loadBinary(pgoBinaryFilename);
+    }
+
+    bool device::loadPgoBinary(kernel &k,
+                               const std::string &hashDir,
+                               const occa::properties &kernelProps) {
+      const std::string pgoBinaryFilename = hashDir + kc::pgoBinaryFile;
+
+      if (!io::cachedFileIsComplete(hashDir, kc::pgoBinaryFile)) {
+        if (!io::cachedFileIsComplete(hashDir, kc::pgoProfileMarker)
+            || !io::isFile(getCachedSourceFilename(hashDir, kernelProps))) {
+          return false;
+        }
+        io::lock_t lock(occa::hash(hashDir), "serial-pgo");
+        if (!lock.isMine()) {
+          if (!io::cachedFileIsComplete(hashDir, kc::pgoBinaryFile)) {
+            return false;
+          }
+        } else if (!io::cachedFileIsComplete(hashDir, kc::pgoBinaryFile)
+                   && !compilePgoBinary(k.name, hashDir, kernelProps)) {
+          return false;
+        }
+      }
+
+      if (kernelProps.get("verbose", false)) {
+        io::stdout << "Loading profile-optimized [" << k.name << "] from ["
+                   << io::shortname(pgoBinaryFilename) << "]\n";
+      }
+      k.loadBinary(pgoBinaryFilename);
+      return true;
+    }
+
     modeKernel_t* device::buildKernelFromBinary(const std::string &filename,
                                                 const std::string &kernelName,
                                                 const occa::properties &kernelProps) {
@@ -1,11 +1,37 @@
+#include <map>
+
 #include <occa/core/base.hpp>
 #include <occa/tools/env.hpp>
 #include <occa/io.hpp>
+#include <occa/modes/serial/device.hpp>
 #include <occa/modes/serial/kernel.hpp>
 #include <occa/lang/modes/serial.hpp>
 
 namespace occa {
   namespace serial {
+    // Kernels using each hash directory's instrumented binary and
+    //   kernels waiting to load the profile-optimized binary
+    struct profilingInfo_t {
+      int kernels;
+      int waitingKernels;
+      bool finishedLaunches;
+
+      profilingInfo_t() :
+        kernels(0),
+        waitingKernels(0),
+        finishedLaunches(false) {}
+    };
+
+    static std::map<std::string, profilingInfo_t>& profilingKernels() {
+      static std::map<std::string, profilingInfo_t> kernels;
+      return kernels;
+    }
+
+    static mutex& profilingMutex() {
+      static mutex mutex_;
+      return mutex_;
+    }
+
     kernel::kernel(modeDevice_t *modeDevice_,
                    const std::string &name_,
                    const std::string &sourceFilename_,
@@ -13,9 +39,19 @@ namespace occa {
       occa::modeKernel_t(modeDevice_, name_, sourceFilename_, properties_),
       dlHandle(NULL),
       function(NULL),
+      pgoDlHandle(NULL),
+      pgoFunction(NULL),
+      pgoLaunchesLeft(0),
+      pgoWaiting(false),
       isLauncherKernel(false) {}
 
     kernel::~kernel() {
+      if (pgoDlHandle) {
+        finishProfiling();
+      }
+      if (pgoWaiting) {
+        stopWaitingForPgo();
+      }
       if (dlHandle) {
         sys::dlclose(dlHandle);
         dlHandle = NULL;
@@ -51,7 +87,113 @@ namespace occa {
         vArgs[i] = arguments[i].ptr();
       }
 
-      sys::runFunction(function, args, &(vArgs[0]));
+      // Binaries are only swapped between launches
+      if (pgoWaiting) {
+        loadPgoBinary();
+      }
+
+      if (!pgoDlHandle) {
+        sys::runFunction(function, args, &(vArgs[0]));
+        return;
+      }
+
+      sys::runFunction(pgoFunction, args, &(vArgs[0]));
+      if (!(--pgoLaunchesLeft)) {
+        finishProfiling();
+      }
+    }
+
+    void kernel::loadBinary(const std::string &filename) {
+      void *newDlHandle = sys::dlopen(filename);
+      functionPtr_t newFunction = sys::dlsym(newDlHandle, name);
+
+      if (dlHandle) {
+        sys::dlclose(dlHandle);
+      }
+      dlHandle = newDlHandle;
+      function = newFunction;
+      binaryFilename = filename;
+    }
+
+    void kernel::startProfiling(const std::string &hashDir,
+                                const std::string &instrumentedFilename,
+                                const int launches) {
+      if (launches <= 0) {
+        return;
+      }
+      pgoDlHandle = sys::dlopen(instrumentedFilename);
+      pgoFunction = sys::dlsym(pgoDlHandle, name);
+      pgoLaunchesLeft = launches;
+      pgoHashDir = hashDir;
+
+      profilingMutex().lock();
+      ++(profilingKernels()[hashDir].kernels);
+      profilingMutex().unlock();
+    }
+
+    bool kernel::isProfiling(const std::string &hashDir) {
+      profilingMutex().lock();
+      std::map<std::string, profilingInfo_t> &kernels = profilingKernels();
+      std::map<std::string, profilingInfo_t>::iterator it = kernels.find(hashDir);
+      const bool profiling = ((it != kernels.end())
+                              && (it->second.kernels > 0));
+      profilingMutex().unlock();
+      return profiling;
+    }
+
+    void kernel::finishProfiling() const {
+      // The instrumented binary is shared by kernels from the same hash
+      //   directory and writes its profile when the last one unloads it
+      sys::dlclose(pgoDlHandle);
+      pgoDlHandle = NULL;
+      pgoFunction = NULL;
+
+      profilingMutex().lock();
+      std::map<std::string, profilingInfo_t> &kernels = profilingKernels();
+      profilingInfo_t &info = kernels[pgoHashDir];
+      // Kernels freed before finishing their launches don't count
+      info.finishedLaunches |= !pgoLaunchesLeft;
+      const bool profiled = (!(--info.kernels) && info.finishedLaunches);
+      if (!pgoLaunchesLeft) {
+        pgoWaiting = true;
+        ++info.waitingKernels;
+      }
+      // Marked before waiting kernels can see the profile is done
+      if (profiled) {
+        io::markCachedFileComplete(pgoHashDir, kc::pgoProfileMarker);
+      }
+      if (!info.kernels && !info.waitingKernels) {
+        kernels.erase(pgoHashDir);
+      }
+      profilingMutex().unlock();
+    }
+
+    void kernel::loadPgoBinary() const {
+      // The profile is written once every kernel sharing it finished
+      profilingMutex().lock();
+      const bool profiled = !profilingKernels()[pgoHashDir].kernels;
+      profilingMutex().unlock();
+      if (!profiled) {
+        return;
+      }
+
+      // Kernels from the same hash directory and other processes wait
+      //   on the build lock and load the same binary
+      serial::device &dev = *((serial::device*) modeDevice);
+      dev.loadPgoBinary(const_cast<kernel&>(*this), pgoHashDir, properties);
+      stopWaitingForPgo();
+    }
+
+    void kernel::stopWaitingForPgo() const {
+      pgoWaiting = false;
+
+      profilingMutex().lock();
+      std::map<std::string, profilingInfo_t> &kernels = profilingKernels();
+      profilingInfo_t &info = kernels[pgoHashDir];
+      if (!(--info.waitingKernels) && !info.kernels) {
+        kernels.erase(pgoHashDir);
+      }
+      profilingMutex().unlock();
     }
   }
 }
@@ -28,6 +28,17 @@ namespace occa {
       return kernelArg(arg);
     }
 
+    kernelArg memory::makeOffsetKernelArg(const udim_t offset) {
+      kernelArgData arg;
+
+      arg.modeMemory = this;
+      arg.data.void_ = ptr + offset;
+      arg.size       = sizeof(void*);
+      arg.info       = kArgInfo::usePointer;
+
+      return kernelArg(arg);
+    }
+
     modeMemory_t* memory::addOffset(const dim_t offset) {
       memory *m = new memory(modeDevice,
                              size - offset,
@@ -39,7 +50,7 @@ namespace occa {
     void memory::copyTo(void *dest,
                         const udim_t bytes,
                         const udim_t offset,
-                        const occa::properties &props) const {
+                        const copyOptions &options) const {
       const void *srcPtr = ptr + offset;
 
       ::memcpy(dest, srcPtr, bytes);
@@ -48,7 +59,7 @@ namespace occa {
     void memory::copyFrom(const void *src,
                           const udim_t bytes,
                           const udim_t offset,
-                          const occa::properties &props) {
+                          const copyOptions &options) {
 
       void *destPtr      = ptr + offset;
       const void *srcPtr = src;
@@ -60,7 +71,7 @@ namespace occa {
                           const udim_t bytes,
                           const udim_t destOffset,
                           const udim_t srcOffset,
-                          const occa::properties &props) {
+                          const copyOptions &options) {
 
       void *destPtr      = ptr + destOffset;
       const void *srcPtr = src->ptr + srcOffset;
@@ -2,14 +2,21 @@
 
 #if OCCA_MPI_ENABLED
 
+#include <algorithm>
+#include <cmath>
+#include <set>
+
 #include <occa/core/base.hpp>
 #include <occa/mpi.hpp>
+#include <occa/tools/exception.hpp>
+#include <occa/tools/sys.hpp>
 #include <occa/tools/tls.hpp>
 
 namespace occa {
   namespace mpi {
     // 4 MB Buffer
     int buffer_t::size = 4 << 20;
+    int buffer_t::pipelineDepth = 3;
 
     buffer_t::buffer_t() :
       ptr(new char[size]) {}
@@ -47,6 +54,57 @@ namespace occa {
       MPI_Barrier(MPI_COMM_WORLD);
     }
 
+    //---[ Staging Buffers ]------------
+    // Reused between transfers since in-flight buffers can't be freed
+    //   until their requests finish
+    static mutex& stagingMutex() {
+      static mutex mutex_;
+      return mutex_;
+    }
+
+    static std::vector<char*>& stagingBuffers() {
+      static std::vector<char*> buffers;
+      return buffers;
+    }
+
+    static int stagingBufferSize() {
+      static int bufferSize = buffer_t::size;
+      // Drop cached buffers if the chunk size changed
+      if (bufferSize != buffer_t::size) {
+        std::vector<char*> &buffers = stagingBuffers();
+        const int bufferCount = (int) buffers.size();
+        for (int i = 0; i < bufferCount; ++i) {
+          delete [] buffers[i];
+        }
+        buffers.clear();
+        bufferSize = buffer_t::size;
+      }
+      return bufferSize;
+    }
+
+    static char* acquireStagingBuffer() {
+      mutex &mutex_ = stagingMutex();
+      mutex_.lock();
+      const int bufferSize = stagingBufferSize();
+      std::vector<char*> &buffers = stagingBuffers();
+      char *buffer = NULL;
+      if (buffers.size()) {
+        buffer = buffers.back();
+        buffers.pop_back();
+      }
+      mutex_.unlock();
+      return buffer ? buffer : new char[bufferSize];
+    }
+
+    static void releaseStagingBuffer(char *buffer) {
+      mutex &mutex_ = stagingMutex();
+      mutex_.lock();
+      stagingBufferSize();
+      stagingBuffers().push_back(buffer);
+      mutex_.unlock();
+    }
+    //==================================
+
     //---[ Types ]----------------------
     template <>
     MPI_Datatype type<bool>() {
@@ -104,11 +162,336 @@ namespace occa {
     }
     //==================================
 
+    //---[ Pipeline ]-------------------
+    // Unfinished pipelines in the order they were started
+    static mutex& pipelineMutex() {
+      static mutex mutex_;
+      return mutex_;
+    }
+
+    static std::vector<pipeline_t*>& activePipelines() {
+      static std::vector<pipeline_t*> pipelines;
+      return pipelines;
+    }
+
+    pipeline_t::pipeline_t(const bool sending_,
+                           const int rank_,
+                           const int messageID_,
+                           MPI_Datatype mpiType_,
+                           occa::memory data_,
+                           const dim_t entries_,
+                           const int entryBytes_) :
+      sending(sending_),
+      staged(data_.getDevice().hasSeparateMemorySpace()),
+      rank(rank_),
+      messageID(messageID_),
+      mpiType(mpiType_),
+      data(data_),
+      entries(entries_),
+      chunkEntries(entries_),
+      entryBytes(entryBytes_),
+      postedChunks(0),
+      copiedChunks(0),
+      refs(0),
+      done(staged && !entries_) {
+      if (done) {
+        return;
+      }
+
+      if (staged) {
+        chunkEntries = std::max((dim_t) (buffer_t::size / entryBytes), (dim_t) 1);
+      }
+      const int chunks_ = chunks();
+      mpiRequests.resize(chunks_, MPI_REQUEST_NULL);
+
+      if (staged) {
+        const int depth = std::max(std::min(buffer_t::pipelineDepth, chunks_), 1);
+        for (int i = 0; i < depth; ++i) {
+          buffers.push_back(acquireStagingBuffer());
+        }
+      }
+
+      mutex &mutex_ = pipelineMutex();
+      mutex_.lock();
+      activePipelines().push_back(this);
+      mutex_.unlock();
+    }
+
+    pipeline_t::~pipeline_t() {
+      // Buffers can't be reused while requests still point to them
+      wait();
+    }
+
+    int pipeline_t::chunks() const {
+      // Empty messages are still sent when memory isn't staged
+      if (!staged || !entries) {
+        return (int) !staged;
+      }
+      return (int) ((entries + chunkEntries - 1) / chunkEntries);
+    }
+
+    bool pipeline_t::isPosted() const {
+      return done || (postedChunks == chunks());
+    }
+
+    void pipeline_t::wait() {
+      while (!done) {
+        progressAll();
+      }
+    }
+
+    void pipeline_t::updateStatus() {
+      if (!done) {
+        progressAll();
+      }
+    }
+
+    void pipeline_t::progress(const bool canPost) {
+      if (done) {
+        return;
+      }
+      const int chunks_ = chunks();
+      const int depth = staged ? (int) buffers.size() : chunks_;
+      int flag;
+
+      if (sending) {
+        // Chunk [k] reuses the staging buffer of chunk [k - depth]
+        while (canPost && (postedChunks < chunks_)) {
+          if (postedChunks >= depth) {
+            MPI_Test(&(mpiRequests[postedChunks - depth]),
+                     &flag,
+                     MPI_STATUS_IGNORE);
+            if (!flag) {
+              break;
+            }
+          }
+          post(postedChunks);
+        }
+        if (postedChunks == chunks_) {
+          MPI_Testall(chunks_,
+                      &(mpiRequests[0]),
+                      &flag,
+                      MPI_STATUSES_IGNORE);
+          if (flag) {
+            releaseBuffers();
+          }
+        }
+        return;
+      }
+
+      // Copy received chunks out to free their staging buffer
+      //   for the next receive
+      while (true) {
+        while (canPost
+               && (postedChunks < std::min(copiedChunks + depth, chunks_))) {
+          post(postedChunks);
+        }
+        if (copiedChunks == postedChunks) {
+          break;
+        }
+        MPI_Test(&(mpiRequests[copiedChunks]),
+                 &flag,
+                 MPI_STATUS_IGNORE);
+        if (!flag) {
+          break;
+        }
+        if (staged) {
+          const dim_t count = chunkCount(copiedChunks);
+          data.copyFrom(buffers[copiedChunks % depth],
+                        count * entryBytes,
+                        copiedChunks * chunkEntries * entryBytes);
+        }
+        ++copiedChunks;
+      }
+      if (copiedChunks == chunks_) {
+        releaseBuffers();
+      }
+    }
+
+    void pipeline_t::progressAll() {
+      mutex &mutex_ = pipelineMutex();
+      mutex_.lock();
+
+      std::vector<pipeline_t*> &pipelines = activePipelines();
+      const int pipelineCount = (int) pipelines.size();
+      for (int i = 0; i < pipelineCount; ++i) {
+        pipeline_t &pipeline = *(pipelines[i]);
+
+        // Wait for earlier transfers with the same rank and message ID
+        //   to post all their chunks
+        bool canPost = true;
+        for (int j = 0; canPost && (j < i); ++j) {
+          const pipeline_t &other = *(pipelines[j]);
+          canPost = (
+            other.isPosted()
+            || !other.matches(pipeline.sending, pipeline.rank, pipeline.messageID)
+          );
+        }
+        pipeline.progress(canPost);
+      }
+
+      int activeCount = 0;
+      for (int i = 0; i < pipelineCount; ++i) {
+        if (!pipelines[i]->done) {
+          pipelines[activeCount++] = pipelines[i];
+        }
+      }
+      pipelines.resize(activeCount);
+
+      mutex_.unlock();
+    }
+
+    bool pipeline_t::hasPending() {
+      mutex &mutex_ = pipelineMutex();
+      mutex_.lock();
+      const bool pending = activePipelines().size();
+      mutex_.unlock();
+      return pending;
+    }
+
+    bool pipeline_t::hasUnposted(const bool sending_,
+                                 const int rank_,
+                                 const int messageID_) {
+      mutex &mutex_ = pipelineMutex();
+      mutex_.lock();
+      bool unposted = false;
+      std::vector<pipeline_t*> &pipelines = activePipelines();
+      const int pipelineCount = (int) pipelines.size();
+      for (int i = 0; !unposted && (i < pipelineCount); ++i) {
+        const pipeline_t &pipeline = *(pipelines[i]);
+        unposted = (
+          !pipeline.isPosted()
+          && pipeline.matches(sending_, rank_, messageID_)
+        );
+      }
+      mutex_.unlock();
+      return unposted;
+    }
+
+    bool pipeline_t::matches(const bool sending_,
+                             const int rank_,
+                             const int messageID_) const {
+      return (
+        (sending == sending_)
+        && (rank == rank_)
+        && (messageID == messageID_)
+      );
+    }
+
+    dim_t pipeline_t::chunkCount(const int chunk) const {
+      return std::min(chunkEntries, entries - (chunk * chunkEntries));
+    }
+
+    void pipeline_t::post(const int chunk) {
+      const dim_t offset = chunk * chunkEntries;
+      const dim_t count = chunkCount(chunk);
+
+      char *ptr;
+      if (staged) {
+        ptr = buffers[chunk % buffers.size()];
+        if (sending) {
+          data.copyTo(ptr,
+                      count * entryBytes,
+                      offset * entryBytes);
+        }
+      } else {
+        ptr = ((char*) data.ptr()) + (offset * entryBytes);
+      }
+
+      if (sending) {
+        MPI_Isend(ptr,
+                  count,
+                  mpiType,
+                  rank,
+                  messageID,
+                  MPI_COMM_WORLD,
+                  &(mpiRequests[chunk]));
+      } else {
+        MPI_Irecv(ptr,
+                  count,
+                  mpiType,
+                  rank,
+                  messageID,
+                  MPI_COMM_WORLD,
+                  &(mpiRequests[chunk]));
+      }
+      ++postedChunks;
+    }
+
+    void pipeline_t::releaseBuffers() {
+      const int bufferCount = (int) buffers.size();
+      for (int i = 0; i < bufferCount; ++i) {
+        releaseStagingBuffer(buffers[i]);
+      }
+      buffers.clear();
+      data = occa::memory();
+      done = true;
+    }
+
+    // Keeps pipelines moving while blocking on a request, the other
+    //   rank might be waiting on one of them
+    static void waitRequest(MPI_Request &mpiRequest) {
+      if (!pipeline_t::hasPending()) {
+        MPI_Wait(&mpiRequest, MPI_STATUS_IGNORE);
+        return;
+      }
+      int flag = false;
+      while (true) {
+        MPI_Test(&mpiRequest, &flag, MPI_STATUS_IGNORE);
+        if (flag) {
+          return;
+        }
+        pipeline_t::progressAll();
+      }
+    }
+    //==================================
+
     //---[ Tag ]------------------------
     tag::tag() :
       mpiRequest(),
       initialized(false),
-      done(false) {}
+      done(false),
+      pipeline(NULL) {}
+
+    tag::tag(pipeline_t *pipeline_) :
+      mpiRequest(),
+      initialized(true),
+      done(false),
+      pipeline(pipeline_) {
+      ++pipeline->refs;
+    }
+
+    tag::tag(const tag &other) :
+      mpiRequest(other.mpiRequest),
+      initialized(other.initialized),
+      done(other.done),
+      pipeline(other.pipeline) {
+      if (pipeline) {
+        ++pipeline->refs;
+      }
+    }
+
+    tag::~tag() {
+      if (pipeline && !(--pipeline->refs)) {
+        delete pipeline;
+      }
+    }
+
+    tag& tag::operator = (const tag &other) {
+      if (pipeline != other.pipeline) {
+        if (other.pipeline) {
+          ++other.pipeline->refs;
+        }
+        if (pipeline && !(--pipeline->refs)) {
+          delete pipeline;
+        }
+        pipeline = other.pipeline;
+      }
+      mpiRequest = other.mpiRequest;
+      initialized = other.initialized;
+      done = other.done;
+      return *this;
+    }
 
     bool tag::isInitialized() {
       return initialized;
@@ -118,8 +501,12 @@ namespace occa {
       if (!initialized || done) {
         return;
       }
-      MPI_Status mpiStatus;
-      MPI_Wait(&mpiRequest, &mpiStatus);
+      if (pipeline) {
+        pipeline->wait();
+        done = true;
+        return;
+      }
+      waitRequest(mpiRequest);
       done = true;
     }
 
@@ -127,6 +514,14 @@ namespace occa {
       if (!initialized || done) {
         return;
       }
+      if (pipeline) {
+        pipeline->updateStatus();
+        done = pipeline->done;
+        return;
+      }
+      if (pipeline_t::hasPending()) {
+        pipeline_t::progressAll();
+      }
       MPI_Status mpiStatus;
       int flag;
       MPI_Request_get_status(mpiRequest,
@@ -144,14 +539,21 @@ namespace occa {
     }
 
     void tags::wait() {
+      const int size_ = (int) tags_.size();
+      if (pipeline_t::hasPending()) {
+        for (int i = 0; i < size_; ++i) {
+          tags_[i].wait();
+        }
+        return;
+      }
+
       std::vector<MPI_Request> mpiRequests;
       std::vector<MPI_Status> mpiStatuses;
       MPI_Status dummyStatus;
-      const int size_ = (int) tags_.size();
       int realSize = 0;
       for (int i = 0; i < size_; ++i) {
         tag &tag_= tags_[i];
-        if (tag_.initialized) {
+        if (!tag_.pipeline && tag_.initialized && !tag_.done) {
           mpiRequests.push_back(tag_.mpiRequest);
           mpiStatuses.push_back(dummyStatus);
           ++realSize;
@@ -164,7 +566,9 @@ namespace occa {
       }
       for (int i = 0; i < size_; ++i) {
         tag &tag_= tags_[i];
-        if (tag_.initialized) {
+        if (tag_.pipeline) {
+          tag_.wait();
+        } else if (tag_.initialized) {
           tag_.done = true;
         }
       }
@@ -190,6 +594,578 @@ namespace occa {
       return *this;
     }
     //==================================
+
+    //---[ Methods ]--------------------
+    static tag startPipeline(const bool sending,
+                             const int rank,
+                             const occa::memory &data,
+                             const dim_t entries,
+                             const int entryBytes,
+                             MPI_Datatype mpiType,
+                             const int messageID) {
+      pipeline_t *pipeline = new pipeline_t(sending,
+                                            rank,
+                                            messageID,
+                                            mpiType,
+                                            data,
+                                            entries,
+                                            entryBytes);
+      tag tag_(pipeline);
+      // Post the first chunks
+      pipeline_t::progressAll();
+      tag_.done = pipeline->done;
+      return tag_;
+    }
+
+    tag sendMemory(const int receiverID,
+                   const occa::memory &data,
+                   const dim_t entries,
+                   const int entryBytes,
+                   MPI_Datatype mpiType,
+                   const int messageID) {
+      occa::device device = data.getDevice();
+      if (device.hasSeparateMemorySpace() ||
+          pipeline_t::hasUnposted(true, receiverID, messageID)) {
+        return startPipeline(true,
+                             receiverID,
+                             data,
+                             entries,
+                             entryBytes,
+                             mpiType,
+                             messageID);
+      }
+
+      tag tag_;
+      MPI_Isend((void*) data.ptr(),
+                entries,
+                mpiType,
+                receiverID,
+                messageID,
+                MPI_COMM_WORLD,
+                &tag_.mpiRequest);
+      tag_.initialized = true;
+      return tag_;
+    }
+
+    tag getMemory(const int senderID,
+                  occa::memory data,
+                  const dim_t entries,
+                  const int entryBytes,
+                  MPI_Datatype mpiType,
+                  const int messageID) {
+      occa::device device = data.getDevice();
+      if (device.hasSeparateMemorySpace() ||
+          pipeline_t::hasUnposted(false, senderID, messageID)) {
+        return startPipeline(false,
+                             senderID,
+                             data,
+                             entries,
+                             entryBytes,
+                             mpiType,
+                             messageID);
+      }
+
+      tag tag_;
+      MPI_Irecv(data.ptr(),
+                entries,
+                mpiType,
+                senderID,
+                messageID,
+                MPI_COMM_WORLD,
+                &tag_.mpiRequest);
+      tag_.initialized = true;
+      return tag_;
+    }
+    //==================================
+
+    //---[ Halo Exchange ]--------------
+    static void appendStridedIndices(std::vector<int> &indices,
+                                     const int offset,
+                                     const int count,
+                                     const int stride) {
+      for (int i = 0; i < count; ++i) {
+        indices.push_back(offset + (i * stride));
+      }
+    }
+
+    haloNeighbor::haloNeighbor(const int rank_) :
+      rank(rank_),
+      sendTag(0),
+      receiveTag(0) {}
+
+    haloNeighbor::haloNeighbor(const int rank_,
+                               const int sendTag_,
+                               const int receiveTag_) :
+      rank(rank_),
+      sendTag(sendTag_),
+      receiveTag(receiveTag_) {}
+
+    haloNeighbor& haloNeighbor::send(const std::vector<int> &indices) {
+      sendIndices.insert(sendIndices.end(), indices.begin(), indices.end());
+      return *this;
+    }
+
+    haloNeighbor& haloNeighbor::send(const int offset,
+                                     const int count,
+                                     const int stride) {
+      appendStridedIndices(sendIndices, offset, count, stride);
+      return *this;
+    }
+
+    haloNeighbor& haloNeighbor::receive(const std::vector<int> &indices) {
+      receiveIndices.insert(receiveIndices.end(), indices.begin(), indices.end());
+      return *this;
+    }
+
+    haloNeighbor& haloNeighbor::receive(const int offset,
+                                        const int count,
+                                        const int stride) {
+      appendStridedIndices(receiveIndices, offset, count, stride);
+      return *this;
+    }
+
+    static const char haloKernelSource[] = (
+      "@kernel void haloPack(const int entries,\n"
+      "                      const int *indices,\n"
+      "                      const HALO_WORD *field,\n"
+      "                      HALO_WORD *buffer) {\n"
+      "  for (int i = 0; i < entries; ++i; @tile(256, @outer, @inner)) {\n"
+      "    const int fieldOffset = indices[i] * HALO_WORDS;\n"
+      "    for (int w = 0; w < HALO_WORDS; ++w) {\n"
+      "      buffer[(i * HALO_WORDS) + w] = field[fieldOffset + w];\n"
+      "    }\n"
+      "  }\n"
+      "}\n"
+      "\n"
+      "@kernel void haloUnpack(const int entries,\n"
+      "                        const int *indices,\n"
+      "                        const HALO_WORD *buffer,\n"
+      "                        HALO_WORD *field) {\n"
+      "  for (int i = 0; i < entries; ++i; @tile(256, @outer, @inner)) {\n"
+      "    const int fieldOffset = indices[i] * HALO_WORDS;\n"
+      "    for (int w = 0; w < HALO_WORDS; ++w) {\n"
+      "      field[fieldOffset + w] = buffer[(i * HALO_WORDS) + w];\n"
+      "    }\n"
+      "  }\n"
+      "}\n"
+    );
+
+    haloExchange::haloExchange(occa::memory field_,
+                               const haloNeighborVector &neighbors,
+                               const int messageID) :
+      device(field_.getDevice()),
+      field(field_.as(dtype::byte)),
+      sendEntries(0),
+      receiveEntries(0),
+      receiveRequests(0) {
+      const int entryBytes = (int) field_.dtype().bytes();
+      const int fieldEntries = (int) field_.length();
+      const int neighborCount = (int) neighbors.size();
+
+      // Messages are matched by (rank, tag), repeated pairs would swap halos
+      std::set<std::pair<int, int> > sendSlots, receiveSlots;
+
+      std::vector<int> allSendIndices, allReceiveIndices;
+      for (int n = 0; n < neighborCount; ++n) {
+        const haloNeighbor &neighbor = neighbors[n];
+        OCCA_ERROR("Halo neighbor rank [" << neighbor.rank << "] is out of bounds",
+                   (0 <= neighbor.rank) && (neighbor.rank < mpi::size()));
+        if (neighbor.sendIndices.size()) {
+          OCCA_ERROR("Halo neighbor rank [" << neighbor.rank << "] repeats send tag ["
+                     << neighbor.sendTag << "]",
+                     sendSlots.insert(std::make_pair(neighbor.rank,
+                                                     neighbor.sendTag)).second);
+        }
+        if (neighbor.receiveIndices.size()) {
+          OCCA_ERROR("Halo neighbor rank [" << neighbor.rank << "] repeats receive tag ["
+                     << neighbor.receiveTag << "]",
+                     receiveSlots.insert(std::make_pair(neighbor.rank,
+                                                        neighbor.receiveTag)).second);
+        }
+        allSendIndices.insert(allSendIndices.end(),
+                              neighbor.sendIndices.begin(),
+                              neighbor.sendIndices.end());
+        allReceiveIndices.insert(allReceiveIndices.end(),
+                                 neighbor.receiveIndices.begin(),
+                                 neighbor.receiveIndices.end());
+      }
+      sendEntries = (int) allSendIndices.size();
+      receiveEntries = (int) allReceiveIndices.size();
+
+      for (int i = 0; i < sendEntries; ++i) {
+        OCCA_ERROR("Halo send index [" << allSendIndices[i] << "] is out of bounds",
+                   (0 <= allSendIndices[i]) && (allSendIndices[i] < fieldEntries));
+      }
+      for (int i = 0; i < receiveEntries; ++i) {
+        OCCA_ERROR("Halo receive index [" << allReceiveIndices[i] << "] is out of bounds",
+                   (0 <= allReceiveIndices[i]) && (allReceiveIndices[i] < fieldEntries));
+      }
+
+      stream = device.createStream();
+      buildKernels(entryBytes);
+
+      const bool separateMemorySpace = device.hasSeparateMemorySpace();
+      char *sendPtr = NULL;
+      char *receivePtr = NULL;
+      if (sendEntries) {
+        sendIndices = device.malloc<int>(sendEntries, &(allSendIndices[0]));
+        sendBuffer  = device.malloc(sendEntries * entryBytes);
+        if (separateMemorySpace) {
+          sendHostBuffer.resize(sendEntries * entryBytes);
+          sendPtr = &(sendHostBuffer[0]);
+        } else {
+          sendPtr = (char*) sendBuffer.ptr();
+        }
+      }
+      if (receiveEntries) {
+        receiveIndices = device.malloc<int>(receiveEntries, &(allReceiveIndices[0]));
+        receiveBuffer  = device.malloc(receiveEntries * entryBytes);
+        if (separateMemorySpace) {
+          receiveHostBuffer.resize(receiveEntries * entryBytes);
+          receivePtr = &(receiveHostBuffer[0]);
+        } else {
+          receivePtr = (char*) receiveBuffer.ptr();
+        }
+      }
+
+      // Requests are matched by rank and tag on both sides
+      for (int n = 0; n < neighborCount; ++n) {
+        const haloNeighbor &neighbor = neighbors[n];
+        const int bytes = (int) neighbor.receiveIndices.size() * entryBytes;
+        if (!bytes) {
+          continue;
+        }
+        MPI_Request mpiRequest;
+        MPI_Recv_init(receivePtr,
+                      bytes,
+                      MPI_BYTE,
+                      neighbor.rank,
+                      messageID + neighbor.receiveTag,
+                      MPI_COMM_WORLD,
+                      &mpiRequest);
+        mpiRequests.push_back(mpiRequest);
+        receivePtr += bytes;
+      }
+      receiveRequests = (int) mpiRequests.size();
+
+      for (int n = 0; n < neighborCount; ++n) {
+        const haloNeighbor &neighbor = neighbors[n];
+        const int bytes = (int) neighbor.sendIndices.size() * entryBytes;
+        if (!bytes) {
+          continue;
+        }
+        MPI_Request mpiRequest;
+        MPI_Send_init(sendPtr,
+                      bytes,
+                      MPI_BYTE,
+                      neighbor.rank,
+                      messageID + neighbor.sendTag,
+                      MPI_COMM_WORLD,
+                      &mpiRequest);
+        mpiRequests.push_back(mpiRequest);
+        sendPtr += bytes;
+      }
+    }
+
+    haloExchange::~haloExchange() {
+      int finalized;
+      MPI_Finalized(&finalized);
+      if (finalized) {
+        return;
+      }
+      pending.wait();
+      const int requestCount = (int) mpiRequests.size();
+      for (int i = 0; i < requestCount; ++i) {
+        MPI_Request_free(&(mpiRequests[i]));
+      }
+    }
+
+    void haloExchange::buildKernels(const int entryBytes) {
+      // Copy entries with a single word when possible
+      std::string word = "char";
+      int words = entryBytes;
+      switch (entryBytes) {
+      case 2: word = "short";     words = 1; break;
+      case 4: word = "int";       words = 1; break;
+      case 8: word = "long long"; words = 1; break;
+      default:
+        break;
+      }
+
+      occa::properties props;
+      props["defines/HALO_WORD"]  = word;
+      props["defines/HALO_WORDS"] = words;
+
+      packKernel = device.buildKernelFromString(haloKernelSource,
+                                                "haloPack",
+                                                props);
+      unpackKernel = device.buildKernelFromString(haloKernelSource,
+                                                  "haloUnpack",
+                                                  props);
+    }
+
+    occa::stream haloExchange::getStream() {
+      return stream;
+    }
+
+    tags haloExchange::start() {
+      OCCA_ERROR("Halo exchange was already started",
+                 !pending.size());
+
+      // Post receives before packing
+      if (receiveRequests) {
+        MPI_Startall(receiveRequests, &(mpiRequests[0]));
+      }
+
+      const int requestCount = (int) mpiRequests.size();
+      if (sendEntries) {
+        // Packing runs on our own stream, wait for work already queued
+        //   on the current stream (e.g. the kernel updating the field)
+        occa::stream previousStream = device.getStream();
+        device.waitFor(device.tagStream());
+        device.setStream(stream);
+
+        packKernel(sendEntries, sendIndices, field, sendBuffer);
+        if (sendHostBuffer.size()) {
+          sendBuffer.copyTo(&(sendHostBuffer[0]), copyOptions(true));
+        }
+        device.waitFor(device.tagStream());
+
+        device.setStream(previousStream);
+
+        MPI_Startall(requestCount - receiveRequests,
+                     &(mpiRequests[receiveRequests]));
+      }
+
+      for (int i = 0; i < requestCount; ++i) {
+        tag tag_;
+        tag_.mpiRequest = mpiRequests[i];
+        tag_.initialized = true;
+        pending += tag_;
+      }
+      return pending;
+    }
+
+    void haloExchange::finish() {
+      if (!pending.size()) {
+        return;
+      }
+      pending.wait();
+      pending = tags();
+
+      if (!receiveEntries) {
+        return;
+      }
+
+      occa::stream previousStream = device.getStream();
+      device.setStream(stream);
+
+      if (receiveHostBuffer.size()) {
+        receiveBuffer.copyFrom(&(receiveHostBuffer[0]), copyOptions(true));
+      }
+      unpackKernel(receiveEntries, receiveIndices, receiveBuffer, field);
+      device.waitFor(device.tagStream());
+
+      device.setStream(previousStream);
+    }
+
+    void haloExchange::exchange() {
+      start();
+      finish();
+    }
+    //==================================
+
+    //---[ Reductions ]-----------------
+    // Mixed reductions are sent as a single contiguous entry so MPI
+    //   never splits the [sumCount, sums..., maxs...] layout
+    static void reduceMixedValues(void *invec,
+                                  void *inoutvec,
+                                  int *len,
+                                  MPI_Datatype *datatype) {
+      int typeBytes;
+      MPI_Type_size(*datatype, &typeBytes);
+      const int valueCount = typeBytes / (int) sizeof(double);
+
+      for (int l = 0; l < *len; ++l) {
+        const double *in = ((const double*) invec) + (l * valueCount);
+        double *inout = ((double*) inoutvec) + (l * valueCount);
+
+        const int sumCount = (int) in[0];
+        for (int i = 1; i <= sumCount; ++i) {
+          inout[i] += in[i];
+        }
+        for (int i = (sumCount + 1); i < valueCount; ++i) {
+          if (inout[i] < in[i]) {
+            inout[i] = in[i];
+          }
+        }
+      }
+    }
+
+    reductions::reductions() :
+      mpiType(MPI_DATATYPE_NULL),
+      mpiOp(MPI_OP_NULL),
+      mpiRequest(MPI_REQUEST_NULL),
+      started(false),
+      done(false) {}
+
+    reductions::~reductions() {
+      int finalized;
+      MPI_Finalized(&finalized);
+      if (started && !done && !finalized) {
+        wait();
+      }
+    }
+
+    int reductions::sum(const double localValue) {
+      return add(localValue, sum_);
+    }
+
+    int reductions::max(const double localValue) {
+      return add(localValue, max_);
+    }
+
+    int reductions::min(const double localValue) {
+      return add(localValue, min_);
+    }
+
+    int reductions::add(const double localValue,
+                        const op_t op,
+                        const bool useExponent,
+                        const double exponent) {
+      OCCA_ERROR("Values can't be added after the reduction started",
+                 !started);
+      localValues.push_back(localValue);
+      ops.push_back(op);
+      useExponents.push_back(useExponent);
+      exponents.push_back(exponent);
+      return (int) localValues.size() - 1;
+    }
+
+    int reductions::size() const {
+      return (int) localValues.size();
+    }
+
+    void reductions::start() {
+      OCCA_ERROR("Reduction was already started",
+                 !started);
+      started = true;
+
+      const int valueCount = size();
+      if (!valueCount) {
+        done = true;
+        return;
+      }
+
+      // Group values by operation, mins are reduced as negated maxs
+      int sumCount = 0;
+      for (int i = 0; i < valueCount; ++i) {
+        sumCount += (ops[i] == sum_);
+      }
+      buffer.resize(valueCount + 1);
+      buffer[0] = sumCount;
+
+      int sumIndex = 1;
+      int maxIndex = sumCount + 1;
+      for (int i = 0; i < valueCount; ++i) {
+        switch (ops[i]) {
+        case sum_: buffer[sumIndex++] = localValues[i];  break;
+        case max_: buffer[maxIndex++] = localValues[i];  break;
+        case min_: buffer[maxIndex++] = -localValues[i]; break;
+        }
+      }
+
+      if (sumCount == valueCount) {
+        MPI_Iallreduce(MPI_IN_PLACE, &(buffer[1]), valueCount,
+                       MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD,
+                       &mpiRequest);
+      } else if (!sumCount) {
+        MPI_Iallreduce(MPI_IN_PLACE, &(buffer[1]), valueCount,
+                       MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD,
+                       &mpiRequest);
+      } else {
+        MPI_Type_contiguous(valueCount + 1, MPI_DOUBLE, &mpiType);
+        MPI_Type_commit(&mpiType);
+        MPI_Op_create(reduceMixedValues, 1, &mpiOp);
+        MPI_Iallreduce(MPI_IN_PLACE, &(buffer[0]), 1,
+                       mpiType, mpiOp, MPI_COMM_WORLD,
+                       &mpiRequest);
+      }
+    }
+
+    bool reductions::isDone() {
+      if (!started || done) {
+        return done;
+      }
+      int flag = 0;
+      MPI_Test(&mpiRequest, &flag, MPI_STATUS_IGNORE);
+      if (flag) {
+        finalize();
+      }
+      return done;
+    }
+
+    void reductions::wait() {
+      if (!started) {
+        start();
+      }
+      if (done) {
+        return;
+      }
+      MPI_Wait(&mpiRequest, MPI_STATUS_IGNORE);
+      finalize();
+    }
+
+    void reductions::finalize() {
+      done = true;
+      if (mpiType != MPI_DATATYPE_NULL) {
+        MPI_Type_free(&mpiType);
+      }
+      if (mpiOp != MPI_OP_NULL) {
+        MPI_Op_free(&mpiOp);
+      }
+
+      const int valueCount = size();
+      const int sumCount = (int) buffer[0];
+      int sumIndex = 1;
+      int maxIndex = sumCount + 1;
+
+      results.resize(valueCount);
+      for (int i = 0; i < valueCount; ++i) {
+        double value = 0;
+        switch (ops[i]) {
+        case sum_: value = buffer[sumIndex++];  break;
+        case max_: value = buffer[maxIndex++];  break;
+        case min_: value = -buffer[maxIndex++]; break;
+        }
+        if (useExponents[i]) {
+          value = ::pow(value, exponents[i]);
+        }
+        results[i] = value;
+      }
+    }
+
+    double reductions::operator [] (const int index) {
+      OCCA_ERROR("Reduction index [" << index << "] is out of bounds",
+                 (0 <= index) && (index < size()));
+      wait();
+      return results[index];
+    }
+
+    void reductions::clear() {
+      if (started && !done) {
+        wait();
+      }
+      localValues.clear();
+      ops.clear();
+      useExponents.clear();
+      exponents.clear();
+      buffer.clear();
+      results.clear();
+      started = false;
+      done = false;
+    }
+    //==================================
   }
 }
 
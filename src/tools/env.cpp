@@ -21,11 +21,14 @@ namespace occa {
     std::string PATH, LD_LIBRARY_PATH;
 
     std::string OCCA_DIR, OCCA_INSTALL_DIR, OCCA_CACHE_DIR;
+    std::string OCCA_LOCAL_CACHE_DIR;
     size_t      OCCA_MEM_BYTE_ALIGN;
     strVector   OCCA_INCLUDE_PATH;
     strVector   OCCA_LIBRARY_PATH;
     strVector   OCCA_KERNEL_PATH;
     bool        OCCA_VERBOSE;
+    bool        OCCA_CACHE_PACK;
+    size_t      OCCA_CACHE_PACK_MAX_BYTES;
     bool        OCCA_COLOR_ENABLED;
 
     properties& baseSettings() {
@@ -78,7 +81,10 @@ namespace occa {
       PATH               = env::var("PATH");
       LD_LIBRARY_PATH    = env::var("LD_LIBRARY_PATH");
 
-      OCCA_CACHE_DIR     = env::var("OCCA_CACHE_DIR");
+      OCCA_CACHE_DIR       = env::var("OCCA_CACHE_DIR");
+      OCCA_LOCAL_CACHE_DIR = env::var("OCCA_LOCAL_CACHE_DIR");
+      OCCA_CACHE_PACK      = env::get<bool>("OCCA_CACHE_PACK", false);
+      OCCA_CACHE_PACK_MAX_BYTES = env::get<size_t>("OCCA_CACHE_PACK_MAX_BYTES", 0);
       OCCA_COLOR_ENABLED = env::get<bool>("OCCA_COLOR_ENABLED", true);
 
       OCCA_INCLUDE_PATH = split(env::var("OCCA_INCLUDE_PATH"), ':', '\\');
@@ -161,6 +167,27 @@ namespace occa {
       if (!io::isDir(env::OCCA_CACHE_DIR)) {
         sys::mkpath(env::OCCA_CACHE_DIR);
       }
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      // The pack format builds kernels in a node-local directory and
+      //   only stores finished entries in the shared pack file
+      if (env::OCCA_CACHE_PACK && !env::OCCA_LOCAL_CACHE_DIR.size()) {
+        env::OCCA_LOCAL_CACHE_DIR = "/tmp/occa_" + env::var("USER");
+      }
+#else
+      env::OCCA_CACHE_PACK = false;
+#endif
+
+      // Optional node-local cache (e.g. /dev/shm or a local SSD)
+      //   consulted before the shared OCCA_CACHE_DIR
+      if (env::OCCA_LOCAL_CACHE_DIR.size()) {
+        env::OCCA_LOCAL_CACHE_DIR = io::filename(env::OCCA_LOCAL_CACHE_DIR);
+        io::endWithSlash(env::OCCA_LOCAL_CACHE_DIR);
+
+        if (!io::isDir(env::OCCA_LOCAL_CACHE_DIR)) {
+          sys::mkpath(env::OCCA_LOCAL_CACHE_DIR);
+        }
+      }
     }
 
     void envInitializer_t::registerFileOpeners() {
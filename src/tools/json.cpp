@@ -5,17 +5,187 @@
 #include <occa/tools/json.hpp>
 
 namespace occa {
+  //---[ jsonValue_t ]------------------
+  std::atomic<uint64_t> jsonValue_t::writeGeneration(0);
+
+  jsonValue_t::jsonValue_t(const jsonValue_t &other) :
+    kind(empty_),
+    payload(NULL) {
+    *this = other;
+  }
+
+  jsonValue_t::~jsonValue_t() {
+    release();
+  }
+
+  jsonValue_t& jsonValue_t::operator = (const jsonValue_t &other) {
+    if (this == &other) {
+      return *this;
+    }
+    switch (other.kind) {
+    case empty_:
+      release();
+      break;
+    case boolean_:
+      setBoolean(other.booleanValue);
+      break;
+    case number_:
+      setNumber(other.numberValue);
+      break;
+    case payload_:
+      if (sharesPayload(other)) {
+        break;
+      }
+      // References into leaked payloads are invalidated by copies so
+      //   they're shared like any other payload
+      ++other.payload->refs;
+      other.payload->leaked = false;
+      release();
+      kind = payload_;
+      payload = other.payload;
+      break;
+    }
+    return *this;
+  }
+
+  void jsonValue_t::clear() {
+    release();
+  }
+
+  void jsonValue_t::release() {
+    // Also called by scalar assignments and when nodes are erased
+    markWritten();
+    if ((kind == payload_) && !(--payload->refs)) {
+      delete payload;
+    }
+    kind = empty_;
+    payload = NULL;
+  }
+
+  bool jsonValue_t::getCachedHash(const int type,
+                                  hash_t &hash) const {
+    if (kind != payload_) {
+      return false;
+    }
+    const unsigned int version = payload->hashVersion;
+    if (!version || (version & 1)) {
+      return false;
+    }
+    const bool isValid = (
+      (payload->hashType == type)
+      && (!payload->leaked
+          || (payload->hashGeneration == writeGeneration))
+    );
+    hash = payload->hash;
+    return (isValid
+            && (payload->hashVersion == version));
+  }
+
+  void jsonValue_t::setCachedHash(const int type,
+                                  const hash_t &hash) const {
+    if (kind != payload_) {
+      return;
+    }
+    // Stale hashes of leaked payloads are replaced
+    unsigned int version = payload->hashVersion;
+    if (!(version & 1)
+        && payload->hashVersion.compare_exchange_strong(version, version + 1)) {
+      payload->hashType = type;
+      payload->hashGeneration = writeGeneration;
+      payload->hash = hash;
+      payload->hashVersion = version + 2;
+    }
+  }
+  //====================================
+
+  //---[ Parsing ]----------------------
+  // Switches compile to bit tests instead of scanning charsets
+  static inline bool isJsonWhitespace(const char c) {
+    switch (c) {
+    case ' ': case '\t': case '\r':
+    case '\n': case '\v': case '\f':
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  static inline void skipJsonWhitespace(const char *&c) {
+    while (isJsonWhitespace(*c)) {
+      ++c;
+    }
+  }
+
+  static inline void skipToJsonKeyEnd(const char *&c) {
+    while ((*c != '\0') && (*c != ':') && !isJsonWhitespace(*c)) {
+      ++c;
+    }
+  }
+
+  static void loadQuotedString(const char *&c,
+                               std::string &str) {
+    // Skip quote
+    const char quote = *c;
+    ++c;
+
+    while (*c != '\0') {
+      if (*c == '\\') {
+        ++c; // Skip '\'
+        OCCA_ERROR("Unclosed string",
+                   *c != '\0');
+
+        switch (*c) {
+          // Escape newline character
+        case '\n': ++c; continue;
+        case 'b':  str += '\b'; break;
+        case 'f':  str += '\f'; break;
+        case 'n':  str += '\n'; break;
+        case 'r':  str += '\r'; break;
+        case 't':  str += '\t'; break;
+        case 'u':
+          // Found unicode character
+          // Load \uXXXX
+          ++c; // Skip 'u'
+          str += "\\u";
+          for (int i = 0; i < 4; ++i) {
+            const char ci = c[i];
+            OCCA_ERROR("Expected hex value",
+                       (('0' <= ci) && (ci <= '9')) ||
+                       (('a' <= ci) && (ci <= 'f')) ||
+                       (('A' <= ci) && (ci <= 'F')));
+            str += ci;
+          }
+          // Let the ++c increment the last character
+          c += 3;
+          break;
+        default:
+          str += *c;
+        }
+        // Skip the last used character
+        ++c;
+      } else if (*c == quote) {
+        ++c;
+        return;
+      } else {
+        // Copy unescaped characters in one chunk
+        const char *cStart = c;
+        while ((*c != '\0') && (*c != '\\') && (*c != quote)) {
+          ++c;
+        }
+        str.append(cStart, c - cStart);
+      }
+    }
+    OCCA_FORCE_ERROR("Unclosed string");
+  }
+  //====================================
+
   const char json::objectKeyEndChars[] = " \t\r\n\v\f:";
 
   json::~json() {}
 
   json& json::clear() {
     type = none_;
-    value_.string = "";
-    value_.number = 0;
-    value_.object.clear();
-    value_.array.clear();
-    value_.boolean = false;
+    value_.clear();
     return *this;
   }
 
@@ -31,7 +201,7 @@ namespace occa {
 
   json& json::load(const char *&c) {
     clear();
-    lex::skipWhitespace(c);
+    skipJsonWhitespace(c);
     switch (*c) {
       case '0': case '1': case '2': case '3': case '4':
       case '5': case '6': case '7': case '8': case '9':
@@ -77,18 +247,19 @@ namespace occa {
       break;
     }
     case boolean_: {
-      out += value_.boolean ? "true" : "false";
+      out += value_.boolean() ? "true" : "false";
       break;
     }
     case number_: {
-      out += value_.number.toString();
+      out += value_.number().toString();
       break;
     }
     case string_: {
+      const std::string &str = value_.string();
       out += '"';
-      const int chars = (int) value_.string.size();
+      const int chars = (int) str.size();
       for (int i = 0; i < chars; ++i) {
-        const char c = value_.string[i];
+        const char c = str[i];
         switch (c) {
         case '"' : out += "\\\"";  break;
         case '\\': out += "\\\\";  break;
@@ -105,8 +276,9 @@ namespace occa {
       break;
     }
     case array_: {
+      const jsonArray &array = value_.array();
       out += '[';
-      const int arraySize = (int) value_.array.size();
+      const int arraySize = (int) array.size();
       if (arraySize) {
         std::string newIndent = currentIndent + indent;
         if (indent.size()) {
@@ -114,7 +286,7 @@ namespace occa {
         }
         for (int i = 0; i < arraySize; ++i) {
           out += newIndent;
-          value_.array[i].dumpToString(out, indent, newIndent);
+          array[i].dumpToString(out, indent, newIndent);
           if (i < (arraySize - 1)) {
             if (indent.size()) {
               out += ",\n";
@@ -131,18 +303,19 @@ namespace occa {
       break;
     }
     case object_: {
-      if (!value_.object.size()) {
+      const jsonObject &object = value_.object();
+      if (!object.size()) {
         out += "{}";
         break;
       }
-      jsonObject::const_iterator it = value_.object.begin();
+      jsonObject::const_iterator it = object.begin();
       out += '{';
-      if (it != value_.object.end()) {
+      if (it != object.end()) {
         std::string newIndent = currentIndent + indent;
         if (indent.size()) {
           out += '\n';
         }
-        while (it != value_.object.end()) {
+        while (it != object.end()) {
           const std::string &key = it->first;
           const json &value = it->second;
 
@@ -158,7 +331,7 @@ namespace occa {
           }
 
           ++it;
-          if (it != value_.object.end()) {
+          if (it != object.end()) {
             if (indent.size()) {
               out += ",\n";
             } else {
@@ -200,59 +373,13 @@ namespace occa {
   }
 
   void json::loadString(const char *&c) {
-    // Skip quote
-    const char quote = *c;
-    ++c;
     type = string_;
-
-    while (*c != '\0') {
-      if (*c == '\\') {
-        ++c; // Skip '\'
-        OCCA_ERROR("Unclosed string",
-                   *c != '\0');
-
-        switch (*c) {
-          // Escape newline character
-        case '\n': ++c; continue;
-        case 'b':  value_.string += '\b'; break;
-        case 'f':  value_.string += '\f'; break;
-        case 'n':  value_.string += '\n'; break;
-        case 'r':  value_.string += '\r'; break;
-        case 't':  value_.string += '\t'; break;
-        case 'u':
-          // Found unicode character
-          // Load \uXXXX
-          ++c; // Skip 'u'
-          value_.string += "\\u";
-          for (int i = 0; i < 4; ++i) {
-            const char ci = c[i];
-            OCCA_ERROR("Expected hex value",
-                       (('0' <= ci) && (ci <= '9')) ||
-                       (('a' <= ci) && (ci <= 'f')) ||
-                       (('A' <= ci) && (ci <= 'F')));
-            value_.string += ci;
-          }
-          // Let the ++c increment the last character
-          c += 3;
-          break;
-        default:
-          value_.string += *c;
-        }
-        // Skip the last used character
-        ++c;
-      } else if (*c == quote) {
-        ++c;
-        return;
-      } else {
-        value_.string += *(c++);
-      }
-    }
-    OCCA_FORCE_ERROR("Unclosed string");
+    loadQuotedString(c, value_.writeString());
   }
 
   void json::loadNumber(const char *&c) {
     type = number_;
-    value_.number = primitive::load(c);
+    value_.setNumber(primitive::load(c));
   }
 
   void json::loadObject(const char *&c) {
@@ -264,7 +391,7 @@ namespace occa {
     type = object_;
 
     while (*c != '\0') {
-      lex::skipWhitespace(c);
+      skipJsonWhitespace(c);
       // Trailing ,
       if ((*c == '}') ||
           (*c == '\0')) {
@@ -272,7 +399,7 @@ namespace occa {
       }
 
       loadObjectField(c);
-      lex::skipWhitespace(c);
+      skipJsonWhitespace(c);
 
       if (*c == ',') {
         ++c;
@@ -298,40 +425,43 @@ namespace occa {
   void json::loadObjectField(const char *&c) {
     std::string key;
     if (*c == '"') {
-      json jKey;
-      jKey.loadString(c);
-      key = jKey.value_.string;
+      loadQuotedString(c, key);
     } else {
       const char *cStart = c;
-      lex::skipTo(c, objectKeyEndChars);
-      key = std::string(cStart, c - cStart);
+      skipToJsonKeyEnd(c);
+      key.assign(cStart, c - cStart);
     }
     OCCA_ERROR("Key cannot be of size 0",
                key.size());
 
-    lex::skipWhitespace(c);
+    skipJsonWhitespace(c);
     OCCA_ERROR("Key must be followed by ':'",
                *c == ':');
     ++c;
-    value_.object[key].load(c);
+
+    // Dumped objects are sorted, so appending is the common case
+    jsonObject &object = value_.writeObject();
+    object.insert(object.end(),
+                  jsonObject::value_type(key, json()))->second.load(c);
   }
 
   void json::loadArray(const char *&c) {
     // Skip [
     ++c;
     type = array_;
+    jsonArray &array = value_.writeArray();
 
     while (*c != '\0') {
-      lex::skipWhitespace(c);
+      skipJsonWhitespace(c);
       // Trailing ,
       if (*c == ']') {
         ++c; // Skip ]
         return;
       }
 
-      value_.array.push_back(json());
-      value_.array[value_.array.size() - 1].load(c);
-      lex::skipWhitespace(c);
+      array.push_back(json());
+      array[array.size() - 1].load(c);
+      skipJsonWhitespace(c);
 
       if (*c == ',') {
         ++c;
@@ -352,7 +482,7 @@ namespace occa {
                !strncmp(c, "true", 4));
     c += 4;
     type = boolean_;
-    value_.boolean = true;
+    value_.setBoolean(true);
   }
 
   void json::loadFalse(const char *&c) {
@@ -360,7 +490,7 @@ namespace occa {
                !strncmp(c, "false", 5));
     c += 5;
     type = boolean_;
-    value_.boolean = false;
+    value_.setBoolean(false);
   }
 
   void json::loadNull(const char *&c) {
@@ -400,29 +530,34 @@ namespace occa {
     case none_: break;
     case null_: break;
     case boolean_: {
-      value_.boolean |= j.value_.boolean;
+      value_.setBoolean(value_.boolean() || j.value_.boolean());
       break;
     }
     case number_: {
-      primitive::addEq(value_.number, j.value_.number);
+      primitive::addEq(value_.leakNumber(), j.value_.number());
       break;
     }
     case string_: {
-      value_.string += j.value_.string;
+      value_.writeString() += j.value_.string();
       break;
     }
     case array_: {
-      value_.array.push_back(j);
+      value_.writeArray().push_back(j);
       break;
     }
     case object_: {
-      mergeWithObject(j.value_.object);
+      mergeWithObject(j.value_.object());
       break;
     }}
     return *this;
   }
 
   void json::mergeWithObject(const jsonObject &obj) {
+    if (!obj.size()) {
+      return;
+    }
+    // Unchanged keys keep sharing their values with the original
+    jsonObject &object = value_.writeObject();
     jsonObject::const_iterator it = obj.begin();
     while (it != obj.end()) {
       const std::string &key = it->first;
@@ -430,16 +565,16 @@ namespace occa {
       ++it;
 
       // If we're merging two json objects, recursively merge them
-      if (val.isObject() && has(key)) {
-        // Reuse prefetch
-        json &oldVal = value_.object[key];
-        if (oldVal.isObject()) {
-          oldVal += val;
-        } else {
-          oldVal = val;
-        }
+      jsonObject::iterator oldIt = object.find(key);
+      if (oldIt == object.end()) {
+        object.insert(oldIt, jsonObject::value_type(key, val));
+        continue;
+      }
+      json &oldVal = oldIt->second;
+      if (val.isObject() && oldVal.isObject()) {
+        oldVal += val;
       } else {
-        value_.object[key] = val;
+        oldVal = val;
       }
     }
   }
@@ -461,8 +596,9 @@ namespace occa {
         ++c;
       }
 
-      jsonObject::const_iterator it = j->value_.object.find(key);
-      if (it == j->value_.object.end()) {
+      const jsonObject &object = j->value_.object();
+      jsonObject::const_iterator it = object.find(key);
+      if (it == object.end()) {
         return false;
       }
       j = &(it->second);
@@ -477,6 +613,7 @@ namespace occa {
     json *j = this;
     bool exists = true;
 
+    // Callers can mutate any node along the path through the returned reference
     if (type == none_) {
       type = object_;
       exists = false;
@@ -493,7 +630,8 @@ namespace occa {
         ++c;
       }
 
-      j = &(j->value_.object[key]);
+      // The returned reference points into every object along the path
+      j = &(j->value_.leakObject()[key]);
       if (j->type == none_) {
         j->type = object_;
         exists = false;
@@ -520,8 +658,9 @@ namespace occa {
         ++c;
       }
 
-      jsonObject::const_iterator it = j->value_.object.find(key);
-      if (it == j->value_.object.end()) {
+      const jsonObject &object = j->value_.object();
+      jsonObject::const_iterator it = object.find(key);
+      if (it == object.end()) {
         return default_;
       }
       j = &(it->second);
@@ -532,20 +671,21 @@ namespace occa {
   json& json::operator [] (const int n) {
     OCCA_ERROR("Can only apply operator [] with JSON arrays",
                type == array_);
-    const int arraySize = (int) value_.array.size();
+    jsonArray &array = value_.leakArray();
+    const int arraySize = (int) array.size();
     if (arraySize < n) {
-      value_.array.resize(n + 1);
+      array.resize(n + 1);
       for (int i = arraySize; i < n; ++i) {
-        value_.array[i].asNull();
+        array[i].asNull();
       }
     }
-    return value_.array[n];
+    return array[n];
   }
 
   const json& json::operator [] (const int n) const {
     OCCA_ERROR("Can only apply operator [] with JSON arrays",
                type == array_);
-    return value_.array[n];
+    return value_.array()[n];
   }
 
   int json::size() const {
@@ -563,13 +703,13 @@ namespace occa {
       return 0;
     }
     case string_: {
-      return (int) value_.string.size();
+      return (int) value_.string().size();
     }
     case array_: {
-      return (int) value_.array.size();
+      return (int) value_.array().size();
     }
     case object_: {
-      return (int) value_.object.size();
+      return (int) value_.object().size();
     }}
     return 0;
   }
@@ -588,29 +728,79 @@ namespace occa {
         ++c;
       }
 
-      if (*c == '\0') {
-        j->value_.object.erase(key);
+      if (!j->value_.object().count(key)) {
         return *this;
       }
 
-      jsonObject::iterator it = j->value_.object.find(key);
-      if (it == j->value_.object.end()) {
+      jsonObject &object = j->value_.writeObject();
+      if (*c == '\0') {
+        object.erase(key);
         return *this;
       }
+
+      jsonObject::iterator it = object.find(key);
       j = &(it->second);
     }
     return *this;
   }
 
   hash_t json::hash() const {
-    std::string out;
-    dumpToString(out);
-    return occa::hash(out);
+    hash_t cachedHash;
+    if (value_.getCachedHash(type, cachedHash)) {
+      return cachedHash;
+    }
+
+    // Hash the structure directly rather than its serialized form
+    // Objects are stored sorted by key so the hash is key-order independent
+    //   and nested values reuse their own memoized hashes
+    std::string buffer;
+    buffer += (char) type;
+    switch (type) {
+    case none_:
+    case null_:
+      break;
+    case boolean_: {
+      buffer += value_.boolean() ? '1' : '0';
+      break;
+    }
+    case number_: {
+      buffer += value_.number().toString();
+      break;
+    }
+    case string_: {
+      buffer += value_.string();
+      break;
+    }
+    case array_: {
+      const jsonArray &array = value_.array();
+      const int arraySize = (int) array.size();
+      for (int i = 0; i < arraySize; ++i) {
+        const hash_t valueHash = array[i].hash();
+        buffer.append((const char*) valueHash.h, sizeof(valueHash.h));
+      }
+      break;
+    }
+    case object_: {
+      const jsonObject &object = value_.object();
+      jsonObject::const_iterator it = object.begin();
+      while (it != object.end()) {
+        const hash_t valueHash = it->second.hash();
+        buffer += it->first;
+        buffer += '\0';
+        buffer.append((const char*) valueHash.h, sizeof(valueHash.h));
+        ++it;
+      }
+      break;
+    }}
+
+    const hash_t hash_ = occa::hash(buffer);
+    value_.setCachedHash(type, hash_);
+    return hash_;
   }
 
   std::string json::toString() const {
     if (type == string_) {
-      return value_.string;
+      return value_.string();
     }
     return dump();
   }
@@ -618,7 +808,7 @@ namespace occa {
   strVector json::keys() const {
     strVector vec;
     if (type == object_) {
-      const jsonObject &obj = value_.object;
+      const jsonObject &obj = value_.object();
       jsonObject::const_iterator it = obj.begin();
       while (it != obj.end()) {
         vec.push_back(it->first);
@@ -631,7 +821,7 @@ namespace occa {
   jsonArray json::values() const {
     jsonArray vec;
     if (type == object_) {
-      const jsonObject &obj = value_.object;
+      const jsonObject &obj = value_.object();
       jsonObject::const_iterator it = obj.begin();
       while (it != obj.end()) {
         vec.push_back(it->second);
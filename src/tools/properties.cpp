@@ -42,7 +42,7 @@ namespace occa {
 
   bool properties::isInitialized() const {
     if (!initialized) {
-      initialized = value_.object.size();
+      initialized = value_.object().size();
     }
     return initialized;
   }
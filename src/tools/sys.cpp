@@ -644,6 +644,68 @@ namespace occa {
 #endif
     }
 
+    strVector getCpuFeatures() {
+      static strVector features;
+      static bool detected = false;
+      if (detected) {
+        return features;
+      }
+      detected = true;
+
+#if ((defined(__x86_64__) || defined(__i386))                          \
+     && (OCCA_COMPILED_WITH & (OCCA_GNU_COMPILER | OCCA_LLVM_COMPILER)))
+      // Features that change which instructions compilers can emit
+      //   with flags such as -march=native
+      __builtin_cpu_init();
+#  define OCCA_CHECK_CPU_FEATURE(FEATURE)     \
+      if (__builtin_cpu_supports(FEATURE)) {  \
+        features.push_back(FEATURE);          \
+      }
+      OCCA_CHECK_CPU_FEATURE("sse4.2");
+      OCCA_CHECK_CPU_FEATURE("avx");
+      OCCA_CHECK_CPU_FEATURE("avx2");
+      OCCA_CHECK_CPU_FEATURE("fma");
+      OCCA_CHECK_CPU_FEATURE("bmi2");
+      OCCA_CHECK_CPU_FEATURE("avx512f");
+      OCCA_CHECK_CPU_FEATURE("avx512cd");
+      OCCA_CHECK_CPU_FEATURE("avx512bw");
+      OCCA_CHECK_CPU_FEATURE("avx512dq");
+      OCCA_CHECK_CPU_FEATURE("avx512vl");
+#  undef OCCA_CHECK_CPU_FEATURE
+#endif
+
+      return features;
+    }
+
+    strVector getCpuIsas() {
+      const strVector features = getCpuFeatures();
+#define OCCA_HAS_CPU_FEATURE(FEATURE)           \
+      (indexOf(features, std::string(FEATURE)) >= 0)
+
+      // Ordered from least to most capable
+      strVector isas;
+      if (OCCA_HAS_CPU_FEATURE("sse4.2")) {
+        isas.push_back("sse4");
+      }
+      if (OCCA_HAS_CPU_FEATURE("avx")) {
+        isas.push_back("avx");
+      }
+      if (OCCA_HAS_CPU_FEATURE("avx2")
+          && OCCA_HAS_CPU_FEATURE("fma")) {
+        isas.push_back("avx2");
+      }
+      if (OCCA_HAS_CPU_FEATURE("avx512f")
+          && OCCA_HAS_CPU_FEATURE("avx512cd")
+          && OCCA_HAS_CPU_FEATURE("avx512bw")
+          && OCCA_HAS_CPU_FEATURE("avx512dq")
+          && OCCA_HAS_CPU_FEATURE("avx512vl")) {
+        isas.push_back("avx512");
+      }
+#undef OCCA_HAS_CPU_FEATURE
+
+      return isas;
+    }
+
     int compilerVendor(const std::string &compiler) {
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
       const std::string safeCompiler = io::slashToSnake(compiler);
@@ -784,6 +846,28 @@ namespace occa {
       return "";
     }
 
+    std::string compilerIsaFlags(const int vendor_,
+                                 const std::string &isa) {
+      if (!(vendor_ & (sys::vendor::GNU  |
+                       sys::vendor::LLVM |
+                       sys::vendor::Intel))) {
+        return "";
+      }
+      if (isa == "sse4") {
+        return "-msse4.2";
+      }
+      if (isa == "avx") {
+        return "-mavx";
+      }
+      if (isa == "avx2") {
+        return "-mavx2 -mfma";
+      }
+      if (isa == "avx512") {
+        return "-mavx512f -mavx512cd -mavx512bw -mavx512dq -mavx512vl";
+      }
+      return "";
+    }
+
     void addCompilerIncludeFlags(std::string &compilerFlags) {
       strVector includeDirs = env::OCCA_INCLUDE_PATH;
 
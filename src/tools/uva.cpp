@@ -1,4 +1,4 @@
-#include <map>
+#include <algorithm>
 
 #include <occa/core/base.hpp>
 #include <occa/tools/misc.hpp>
@@ -6,7 +6,10 @@
 #include <occa/tools/uva.hpp>
 
 namespace occa {
-  ptrRangeMap uvaMap;
+  // Versions are unique across registries to keep per-thread caches valid
+  static std::atomic<udim_t> uvaRegistryVersions(0);
+
+  uvaRegistry uvaMap;
   memoryVector uvaStaleMemory;
 
   //---[ ptrRange ]---------------------
@@ -53,13 +56,214 @@ namespace occa {
   //====================================
 
 
+  //---[ byteRangeSet ]----------------
+  void byteRangeSet::add(const udim_t start, const udim_t end) {
+    if (start >= end) {
+      return;
+    }
+    range_t newRange(start, end);
+    rangeVector newRanges;
+    newRanges.reserve(ranges.size() + 1);
+
+    bool added = false;
+    const int rangeCount = (int) ranges.size();
+    for (int i = 0; i < rangeCount; ++i) {
+      const range_t &r = ranges[i];
+      if (r.second < newRange.first) {
+        newRanges.push_back(r);
+      } else if (newRange.second < r.first) {
+        if (!added) {
+          newRanges.push_back(newRange);
+          added = true;
+        }
+        newRanges.push_back(r);
+      } else {
+        // Overlapping or adjacent
+        newRange.first  = std::min(newRange.first, r.first);
+        newRange.second = std::max(newRange.second, r.second);
+      }
+    }
+    if (!added) {
+      newRanges.push_back(newRange);
+    }
+    ranges.swap(newRanges);
+  }
+
+  void byteRangeSet::remove(const udim_t start, const udim_t end) {
+    if (start >= end) {
+      return;
+    }
+    rangeVector newRanges;
+    newRanges.reserve(ranges.size() + 1);
+
+    const int rangeCount = (int) ranges.size();
+    for (int i = 0; i < rangeCount; ++i) {
+      const range_t &r = ranges[i];
+      if ((r.second <= start) || (end <= r.first)) {
+        newRanges.push_back(r);
+        continue;
+      }
+      if (r.first < start) {
+        newRanges.push_back(range_t(r.first, start));
+      }
+      if (end < r.second) {
+        newRanges.push_back(range_t(end, r.second));
+      }
+    }
+    ranges.swap(newRanges);
+  }
+
+  void byteRangeSet::clear() {
+    ranges.clear();
+  }
+
+  bool byteRangeSet::isEmpty() const {
+    return ranges.empty();
+  }
+
+  udim_t byteRangeSet::bytes() const {
+    udim_t bytes_ = 0;
+    const int rangeCount = (int) ranges.size();
+    for (int i = 0; i < rangeCount; ++i) {
+      bytes_ += ranges[i].second - ranges[i].first;
+    }
+    return bytes_;
+  }
+  //====================================
+
+
+  //---[ uvaRegistry ]------------------
+  struct uvaCacheEntry {
+    const uvaRegistry *registry;
+    udim_t version;
+    const char *start, *end;
+    modeMemory_t *mem;
+  };
+
+  static const int uvaCacheSize = 4;
+
+  static thread_local uvaCacheEntry uvaCache[uvaCacheSize];
+  static thread_local int uvaCacheNext = 0;
+
+  static bool startsBefore(const char *ptr, const ptrRange &range) {
+    return ptr < range.start;
+  }
+
+  uvaRegistry::uvaRegistry() :
+    version(++uvaRegistryVersions) {}
+
+  uvaRegistry::~uvaRegistry() {
+    mutex_.free();
+  }
+
+  void uvaRegistry::insert(const ptrRange &range,
+                           modeMemory_t *mem) {
+    mutex_.lock();
+
+    // Matches the std::map<ptrRange> semantics where overlapping
+    //   ranges and ranges with the same start are equivalent
+    int i = 0;
+    while (i < (int) ranges.size()) {
+      if ((ranges[i] == range) || (ranges[i].start == range.start)) {
+        ranges.erase(ranges.begin() + i);
+        memories.erase(memories.begin() + i);
+      } else {
+        ++i;
+      }
+    }
+
+    const int index = (
+      std::upper_bound(ranges.begin(), ranges.end(), range.start, startsBefore)
+      - ranges.begin()
+    );
+    ranges.insert(ranges.begin() + index, range);
+    memories.insert(memories.begin() + index, mem);
+
+    updateVersion();
+    mutex_.unlock();
+  }
+
+  void uvaRegistry::erase(void *ptr) {
+    mutex_.lock();
+    const int index = findIndex((const char*) ptr);
+    if (index >= 0) {
+      ranges.erase(ranges.begin() + index);
+      memories.erase(memories.begin() + index);
+      updateVersion();
+    }
+    mutex_.unlock();
+  }
+
+  modeMemory_t* uvaRegistry::find(const void *ptr) const {
+    const char *cptr = (const char*) ptr;
+    const udim_t currentVersion = version.load();
+
+    // Lock-free path, cached entries are dropped once the registry changes
+    for (int i = 0; i < uvaCacheSize; ++i) {
+      const uvaCacheEntry &entry = uvaCache[i];
+      if ((entry.registry == this)
+          && (entry.version == currentVersion)
+          && ((cptr == entry.start)
+              || ((entry.start < cptr) && (cptr < entry.end)))) {
+        return entry.mem;
+      }
+    }
+
+    mutex_.lock();
+    // Misses are cached as empty ranges
+    uvaCacheEntry entry;
+    entry.registry = this;
+    entry.version = version.load();
+    entry.start = entry.end = cptr;
+    entry.mem = NULL;
+
+    const int index = findIndex(cptr);
+    if (index >= 0) {
+      entry.start = ranges[index].start;
+      entry.end = ranges[index].end;
+      entry.mem = memories[index];
+    }
+    mutex_.unlock();
+
+    uvaCache[uvaCacheNext] = entry;
+    uvaCacheNext = (uvaCacheNext + 1) % uvaCacheSize;
+
+    return entry.mem;
+  }
+
+  size_t uvaRegistry::size() const {
+    mutex_.lock();
+    const size_t size_ = ranges.size();
+    mutex_.unlock();
+    return size_;
+  }
+
+  int uvaRegistry::findIndex(const char *ptr) const {
+    // Last range starting at or before ptr
+    const int index = (
+      std::upper_bound(ranges.begin(), ranges.end(), ptr, startsBefore)
+      - ranges.begin()
+    ) - 1;
+    if ((index >= 0)
+        && ((ptr == ranges[index].start)
+            || (ptr < ranges[index].end))) {
+      return index;
+    }
+    return -1;
+  }
+
+  void uvaRegistry::updateVersion() {
+    version.store(++uvaRegistryVersions);
+  }
+  //====================================
+
+
   //---[ UVA ]--------------------------
   occa::modeMemory_t* uvaToMemory(void *ptr) {
     if (!ptr) {
       return NULL;
     }
-    ptrRangeMap::iterator it = uvaMap.find(ptr);
-    return (it == uvaMap.end()) ? NULL : it->second;
+    return uvaMap.find(ptr);
   }
 
   bool isManaged(void *ptr) {
@@ -137,12 +341,12 @@ namespace occa {
   }
 
   void removeFromStaleMap(void *ptr) {
-    ptrRangeMap::iterator it = uvaMap.find(ptr);
-    if (it == uvaMap.end()) {
+    modeMemory_t *mem = uvaMap.find(ptr);
+    if (!mem) {
       return;
     }
 
-    memory m(it->second);
+    memory m(mem);
     if (!m.uvaIsStale()) {
       return;
     }
@@ -0,0 +1,85 @@
+#include <occa.hpp>
+#include <occa/array.hpp>
+#include <occa/tools/testing.hpp>
+
+void testFusedExpressions();
+void testMixedTypes();
+
+int main(const int argc, const char **argv) {
+  occa::setDevice("mode: 'Serial'");
+
+  testFusedExpressions();
+  testMixedTypes();
+
+  return 0;
+}
+
+void testFusedExpressions() {
+  occa::device device = occa::getDevice();
+
+  const int entries = 20;
+  float values[entries];
+  for (int i = 0; i < entries; ++i) {
+    values[i] = i;
+  }
+
+  occa::array<float> a(device, entries);
+  occa::array<float> b(device, entries, values);
+  occa::array<float> c(device, entries, values);
+  occa::array<float> d(device, entries, values);
+
+  const float alpha = 0.5;
+  a = b + alpha * c * d;
+
+  a.memory().copyTo(values);
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(values[i], i + (alpha * i * i));
+  }
+
+  // Compound assignments reuse the output as v0
+  a -= (b - 1.0f) / 2.0;
+  a.memory().copyTo(values);
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(values[i], (float) ((i + (alpha * i * i)) - ((i - 1.0) / 2.0)));
+  }
+
+  a = 2.0f * b;
+  a *= b + b;
+  a.memory().copyTo(values);
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(values[i], (float) (4 * i * i));
+  }
+
+  // Integer offsets are still subarrays
+  occa::array<float> subarray = b + 5;
+  ASSERT_EQ((int) subarray.size(), entries - 5);
+}
+
+void testMixedTypes() {
+  occa::device device = occa::getDevice();
+
+  const int entries = 10;
+  int intValues[entries];
+  double doubleValues[entries];
+  for (int i = 0; i < entries; ++i) {
+    intValues[i] = i;
+    doubleValues[i] = 0.25 * i;
+  }
+
+  occa::array<int> ints(device, entries, intValues);
+  occa::array<double> doubles(device, entries, doubleValues);
+  occa::array<double> out(device, entries);
+
+  out = ints * doubles + 1.0;
+  out.memory().copyTo(doubleValues);
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(doubleValues[i], (0.25 * i * i) + 1.0);
+  }
+
+  // Results are converted to the output type
+  ints = doubles * 2.0;
+  ints.memory().copyTo(intValues);
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(intValues[i], (int) (0.5 * i));
+  }
+}
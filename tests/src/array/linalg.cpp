@@ -0,0 +1,280 @@
+#include <occa.hpp>
+#include <occa/array/linalg.hpp>
+#include <occa/tools/testing.hpp>
+
+void testChunkedLaunches();
+void testStats();
+void testAsyncReductions();
+void testBatched();
+
+int main(const int argc, const char **argv) {
+  testChunkedLaunches();
+  testStats();
+  testAsyncReductions();
+  testBatched();
+
+  return 0;
+}
+
+void testChunkedLaunches() {
+  occa::device device("mode: 'Serial', linalg: { max_launch_entries: 100 }");
+  occa::setDevice(device);
+
+  const int entries = 250;
+  float values[entries];
+  for (int i = 0; i < entries; ++i) {
+    values[i] = i;
+  }
+
+  occa::memory in = device.malloc<float>(entries, values);
+  occa::memory out = device.malloc<float>(entries);
+
+  // Elementwise kernels are split into 3 launches
+  occa::linalg::operator_eq<float>(out, 1.0f, 64);
+  occa::linalg::operator_plus_eq<float, float>(in, out, 64);
+  occa::linalg::axpy<float, float, float>(2.0f, in, out, 64);
+
+  out.copyTo(values);
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(values[i], (float) (1 + (3 * i)));
+  }
+
+  // Untyped memory is sliced in bytes
+  occa::memory bytes = device.malloc(entries * sizeof(float));
+  occa::linalg::operator_eq<float>(bytes, 3.0f, 64);
+  bytes.copyTo(values);
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(values[i], 3.0f);
+  }
+
+  // Reductions don't need chunking
+  ASSERT_EQ((occa::linalg::sum<float, double>(in)),
+            (double) ((entries * (entries - 1)) / 2));
+  ASSERT_EQ((occa::linalg::max<float, float>(in)),
+            (float) (entries - 1));
+}
+
+void testStats() {
+  occa::device device("mode: 'Serial'");
+  occa::setDevice(device);
+
+  const int entries = 1000;
+  float values[entries];
+  for (int i = 0; i < entries; ++i) {
+    values[i] = (i % 7) - 3;
+  }
+  values[500] = -10;
+  values[501] = 8;
+
+  float min = values[0], max = values[0];
+  double sum = 0, l1 = 0, l2 = 0;
+  for (int i = 0; i < entries; ++i) {
+    min = std::min(min, values[i]);
+    max = std::max(max, values[i]);
+    sum += values[i];
+    l1 += fabs(values[i]);
+    l2 += values[i] * values[i];
+  }
+  l2 = sqrt(l2);
+
+  occa::memory vec = device.malloc<float>(entries, values);
+
+  occa::linalg::vectorStats<double> stats = (
+    occa::linalg::stats<float, double>(vec)
+  );
+  ASSERT_EQ(stats.flags, occa::linalg::stat::all);
+  ASSERT_EQ(stats.min, (double) min);
+  ASSERT_EQ(stats.max, (double) max);
+  ASSERT_EQ(stats.sum, sum);
+  ASSERT_EQ(stats.l1Norm, l1);
+  ASSERT_LE(fabs(stats.l2Norm - l2), 1e-10);
+  ASSERT_EQ(stats.lInfNorm, 10.0);
+
+  // Matches the single-statistic reductions
+  ASSERT_EQ(stats.min, (occa::linalg::min<float, double>(vec)));
+  ASSERT_EQ(stats.sum, (occa::linalg::sum<float, double>(vec)));
+
+  // Only requested statistics are computed
+  stats = occa::linalg::stats<float, double>(
+    vec,
+    occa::linalg::stat::max | occa::linalg::stat::l1Norm
+  );
+  ASSERT_TRUE(stats.has(occa::linalg::stat::max));
+  ASSERT_FALSE(stats.has(occa::linalg::stat::min));
+  ASSERT_EQ(stats.max, (double) max);
+  ASSERT_EQ(stats.l1Norm, l1);
+  ASSERT_EQ(stats.min, 0.0);
+  ASSERT_EQ(stats.sum, 0.0);
+
+  // Empty vectors skip the launch
+  stats = occa::linalg::stats<float, double>(vec.slice(0, 0));
+  ASSERT_EQ(stats.max, 0.0);
+
+  // User-composed terms
+  double cubes = 0, maxShifted = values[0] + 1;
+  for (int i = 0; i < entries; ++i) {
+    cubes += (double) values[i] * values[i] * values[i];
+    maxShifted = std::max(maxShifted, (double) values[i] + 1);
+  }
+  occa::linalg::reductionTuple terms;
+  const int cubesIndex = terms.sum("(RETTYPE) v * v * v");
+  const int maxIndex = terms.max("v + 1");
+  const int minIndex = terms.min("v");
+  std::vector<double> results = occa::linalg::reduce<float, double>(vec, terms);
+  ASSERT_EQ((int) results.size(), 3);
+  ASSERT_EQ(results[cubesIndex], cubes);
+  ASSERT_EQ(results[maxIndex], maxShifted);
+  ASSERT_EQ(results[minIndex], (double) min);
+}
+
+void testAsyncReductions() {
+  occa::device device("mode: 'Serial'");
+  occa::setDevice(device);
+
+  const int entries = 300;
+  double values1[entries], values2[entries];
+  double dot = 0, distance = 0, l3 = 0;
+  for (int i = 0; i < entries; ++i) {
+    values1[i] = (i % 5) - 2;
+    values2[i] = i % 3;
+    dot += values1[i] * values2[i];
+    distance += (values1[i] - values2[i]) * (values1[i] - values2[i]);
+    l3 += pow(values2[i], 3.0);
+  }
+  distance = sqrt(distance);
+  l3 = pow(l3, 1.0 / 3.0);
+
+  occa::memory vec1 = device.malloc<double>(entries, values1);
+  occa::memory vec2 = device.malloc<double>(entries, values2);
+
+  // Results stay on the device until requested
+  occa::memory results = device.malloc<double>(2);
+  occa::linalg::asyncReduction<double> dotReduction = (
+    occa::linalg::dotAsync<double, double, double>(vec1, vec2, results.slice(0, 1))
+  );
+  occa::linalg::asyncReduction<double> distanceReduction = (
+    occa::linalg::distanceAsync<double, double, double>(vec1, vec2, results.slice(1, 1))
+  );
+  ASSERT_TRUE(dotReduction.isInitialized());
+  ASSERT_TRUE(dotReduction.tag.isInitialized());
+
+  ASSERT_EQ(dotReduction.value(), dot);
+  ASSERT_LE(fabs(distanceReduction.value() - distance), 1e-10);
+
+  double hostResults[2];
+  results.copyTo(hostResults);
+  ASSERT_EQ(hostResults[0], dot);
+  ASSERT_EQ(hostResults[1], distanceReduction.value());
+
+  // Results are allocated if not given
+  occa::linalg::asyncReduction<double> maxReduction = (
+    occa::linalg::maxAsync<double, double>(vec1)
+  );
+  ASSERT_EQ((int) maxReduction.result.size(), (int) sizeof(double));
+  ASSERT_EQ(maxReduction.value(), 2.0);
+
+  // Blocking reductions finish on the device
+  ASSERT_EQ((occa::linalg::min<double, double>(vec1)), -2.0);
+  ASSERT_EQ((occa::linalg::lInfNorm<double, double>(vec1)), 2.0);
+  ASSERT_EQ((occa::linalg::dot<double, double, double>(vec1, vec2)), dot);
+  ASSERT_LE(fabs((occa::linalg::lpNorm<double, double>(3, vec2)) - l3), 1e-10);
+
+  // Blocking reductions reuse the stream's buffers
+  const occa::udim_t allocatedBytes = device.memoryAllocated();
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ((occa::linalg::dot<double, double, double>(vec1, vec2)), dot);
+    ASSERT_EQ((occa::linalg::sum<double, double>(vec1)), 0.0);
+  }
+  ASSERT_EQ(device.memoryAllocated(), allocatedBytes);
+
+  // Roots of float and integer results are taken in float
+  float floatValues[entries];
+  int intValues[entries];
+  for (int i = 0; i < entries; ++i) {
+    floatValues[i] = (float) values2[i];
+    intValues[i] = (int) values2[i];
+  }
+  occa::memory floatVec = device.malloc<float>(entries, floatValues);
+  occa::memory intVec = device.malloc<int>(entries, intValues);
+
+  const double l2 = sqrt((entries / 3) * 5.0);
+  ASSERT_LE(fabs((occa::linalg::l2Norm<float, float>(floatVec)) - l2), 1e-4);
+  ASSERT_EQ((occa::linalg::l2Norm<int, int>(intVec)), (int) l2);
+}
+
+void testBatched() {
+  occa::device device("mode: 'Serial'");
+  occa::setDevice(device);
+
+  // Vectors of different lengths, x packed back to back and y with gaps
+  const int batches = 4;
+  occa::dim_t lengths[batches] = {3, 0, 17, 5};
+  occa::dim_t xOffsets[batches], yOffsets[batches];
+  occa::dim_t xEntries = 0, yEntries = 0;
+  for (int b = 0; b < batches; ++b) {
+    xOffsets[b] = xEntries;
+    yOffsets[b] = yEntries + 2;
+    xEntries += lengths[b];
+    yEntries += lengths[b] + 2;
+  }
+
+  double xValues[25], yValues[33];
+  for (int i = 0; i < xEntries; ++i) {
+    xValues[i] = (i % 4) - 1;
+  }
+  for (int i = 0; i < yEntries; ++i) {
+    yValues[i] = i % 3;
+  }
+
+  occa::memory o_lengths  = device.malloc<occa::dim_t>(batches, lengths);
+  occa::memory o_xOffsets = device.malloc<occa::dim_t>(batches, xOffsets);
+  occa::memory o_yOffsets = device.malloc<occa::dim_t>(batches, yOffsets);
+  occa::memory x = device.malloc<double>(xEntries, xValues);
+  occa::memory y = device.malloc<double>(yEntries, yValues);
+
+  double dots[batches], norms[batches];
+  for (int b = 0; b < batches; ++b) {
+    dots[b] = norms[b] = 0;
+    for (int i = 0; i < lengths[b]; ++i) {
+      const double xi = xValues[xOffsets[b] + i];
+      dots[b] += xi * yValues[yOffsets[b] + i];
+      norms[b] += xi * xi;
+    }
+    norms[b] = sqrt(norms[b]);
+  }
+
+  double results[batches];
+  occa::memory o_dots = occa::linalg::batchedDot<double, double, double>(
+    batches, o_lengths, x, o_xOffsets, y, o_yOffsets
+  );
+  ASSERT_EQ((int) o_dots.size(), (int) (batches * sizeof(double)));
+  o_dots.copyTo(results);
+  for (int b = 0; b < batches; ++b) {
+    ASSERT_EQ(results[b], dots[b]);
+  }
+
+  occa::memory o_norms = device.malloc<double>(batches);
+  occa::linalg::batchedNorm<double, double>(
+    batches, o_lengths, x, o_xOffsets, o_norms
+  );
+  o_norms.copyTo(results);
+  for (int b = 0; b < batches; ++b) {
+    ASSERT_LE(fabs(results[b] - norms[b]), 1e-12);
+  }
+
+  // y_b += dot_b * x_b, entries between vectors are untouched
+  occa::linalg::batchedAxpy<double, double, double>(
+    batches, o_lengths, o_dots, x, o_xOffsets, y, o_yOffsets
+  );
+  double newYValues[33];
+  y.copyTo(newYValues);
+  for (int b = 0; b < batches; ++b) {
+    for (int i = 0; i < lengths[b]; ++i) {
+      const occa::dim_t yi = yOffsets[b] + i;
+      yValues[yi] += dots[b] * xValues[xOffsets[b] + i];
+    }
+  }
+  for (int i = 0; i < yEntries; ++i) {
+    ASSERT_EQ(newYValues[i], yValues[i]);
+  }
+}
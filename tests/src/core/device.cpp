@@ -2,9 +2,11 @@
 #include <occa/tools/testing.hpp>
 
 void testProperties();
+void testMemoryPool();
 
 int main(const int argc, const char **argv) {
   testProperties();
+  testMemoryPool();
 
   return 0;
 }
@@ -97,3 +99,65 @@ void testProperties() {
     (int) device.kernelProperties()["one"]
   );
 }
+
+void testMemoryPool() {
+  ASSERT_EQ(occa::memoryPool_t::sizeClass(1), (occa::udim_t) 256);
+  ASSERT_EQ(occa::memoryPool_t::sizeClass(1000), (occa::udim_t) 1024);
+  ASSERT_EQ(occa::memoryPool_t::sizeClass(1025), (occa::udim_t) 1280);
+
+  occa::device device("mode: 'Serial'");
+  occa::memory mem = device.malloc<float>(100);
+  mem.free();
+  ASSERT_EQ(device.memoryCached(), (occa::udim_t) 0);
+  ASSERT_EQ(device.poolStats().misses, (occa::udim_t) 0);
+
+  device.setup(
+    "mode: 'Serial',"
+    "memory_pool: true,"
+    "memory_pool_max_cached_bytes: 1024,"
+  );
+
+  int values[3] = {1, 2, 3};
+  mem = device.malloc<int>(3, values);
+  void *ptr = mem.ptr();
+  ASSERT_EQ(mem.size(), 3 * sizeof(int));
+  ASSERT_EQ(device.memoryAllocated(), 3 * sizeof(int));
+
+  // Freed blocks are reused on the same stream
+  mem.free();
+  ASSERT_FALSE(mem.isInitialized());
+  ASSERT_EQ(device.memoryAllocated(), (occa::udim_t) 0);
+  ASSERT_EQ(device.memoryCached(), (occa::udim_t) 256);
+
+  mem = device.malloc<int>(2, values + 1);
+  ASSERT_EQ(mem.ptr(), ptr);
+  ASSERT_EQ(mem.size(), 2 * sizeof(int));
+  ASSERT_EQ(mem.ptr<int>()[0], 2);
+  ASSERT_EQ(device.poolStats().hits, (occa::udim_t) 1);
+  ASSERT_EQ(device.poolStats().misses, (occa::udim_t) 1);
+
+  // Other streams wait until the device is finished
+  occa::stream stream = device.getStream();
+  mem.free();
+  device.setStream(device.createStream());
+  mem = device.malloc<int>(2);
+  ASSERT_NEQ(mem.ptr(), ptr);
+  mem.free();
+
+  device.finish();
+  mem = device.malloc<int>(2);
+  ASSERT_EQ(device.poolStats().hits, (occa::udim_t) 2);
+  mem.free();
+  device.setStream(stream);
+
+  // finish() trims down to the cache limit
+  occa::memory big = device.malloc<char>(4096);
+  big.free();
+  ASSERT_EQ(device.memoryCached(), (occa::udim_t) (4096 + 512));
+  device.finish();
+  ASSERT_LE(device.memoryCached(), (occa::udim_t) 1024);
+  ASSERT_GT(device.poolStats().trimmedBytes, (occa::udim_t) 0);
+
+  device.trimMemoryPool();
+  ASSERT_EQ(device.memoryCached(), (occa::udim_t) 0);
+}
@@ -1,3 +1,6 @@
+#include <stdlib.h>
+#include <time.h>
+
 #include <occa.hpp>
 #include <occa/tools/testing.hpp>
 
@@ -12,8 +15,14 @@ void testParsingFailure();
 void testCompilingFailure();
 void testArgumentFailure();
 void testRun();
+void testSpecialization();
+void testAutotune();
+void testPgo();
+void testTargetIsas();
 
 int main(const int argc, const char **argv) {
+  srand(time(NULL));
+
   addVectors = occa::buildKernel(addVectorsFile,
                                  "addVectors");
 
@@ -23,6 +32,10 @@ int main(const int argc, const char **argv) {
   testCompilingFailure();
   testArgumentFailure();
   testRun();
+  testSpecialization();
+  testAutotune();
+  testPgo();
+  testTargetIsas();
 
   return 0;
 }
@@ -180,3 +193,190 @@ void testRun() {
 
   occa::freeUvaPtr(uvaPtr);
 }
+
+void testSpecialization() {
+  occa::kernel kernel = occa::buildKernelFromString(
+    "@kernel void shift(const int entries, const int N, int *values) {"
+    "  for (int i = 0; i < entries; ++i; @tile(16, @outer, @inner)) {"
+    "    values[i] = N + (2 * N);"
+    "  }"
+    "}",
+    "shift",
+    "specialize: ['N'],"
+    "max_specializations: 2"
+  );
+
+  const int entries = 10;
+  int values[entries];
+  occa::memory mem = occa::malloc<int>(entries);
+
+  const int Ns[4] = {3, -2, 3, 7};
+  for (int n = 0; n < 4; ++n) {
+    kernel(entries, Ns[n], mem);
+    mem.copyTo(values);
+    for (int i = 0; i < entries; ++i) {
+      ASSERT_EQ(values[i],
+                3 * Ns[n]);
+    }
+  }
+
+  // Values past max_specializations use the generic kernel
+  occa::modeKernel_t *modeKernel = kernel.getModeKernel();
+  ASSERT_EQ((int) modeKernel->specializedKernels.size(),
+            2);
+  ASSERT_TRUE(modeKernel->specializedKernels["N=3;"] != NULL);
+
+  // Specialized arguments are resolved once at build time
+  ASSERT_EQ((int) modeKernel->specializedArgs.size(),
+            1);
+  ASSERT_EQ(modeKernel->specializedArgs[0],
+            1);
+  ASSERT_TRUE(modeKernel->specializedKernels["N=3;"]->specializedArgs.empty());
+}
+
+class countingBenchmark : public occa::kernelBenchmark {
+public:
+  int runs;
+  occa::memory mem;
+
+  countingBenchmark() :
+    runs(0),
+    mem(occa::malloc<int>(10)) {}
+
+  void run(occa::kernel kernel) {
+    ++runs;
+    kernel(10, mem);
+  }
+};
+
+void testAutotune() {
+  const std::string source = (
+    "@kernel void fill(const int entries, int *values) {"
+    "  for (int i = 0; i < entries; ++i; @tile(TILESIZE, @outer, @inner)) {"
+    "    values[i] = TILESIZE;"
+    "  }"
+    "}"
+  );
+  // Avoid picking up winners stored by previous test runs
+  const occa::properties props = (
+    "defines: { TILESIZE: 8, SEED: " + occa::toString(rand()) + " }"
+  );
+  const occa::json paramSpace = occa::json::parse("{ TILESIZE: [16, 32] }");
+
+  occa::kernelBuilder builder = occa::kernelBuilder::fromString(source, "fill", props);
+  countingBenchmark benchmark;
+
+  occa::kernel kernel = builder.autotune(occa::host(), paramSpace, benchmark, 10);
+  ASSERT_TRUE(kernel.isInitialized());
+  // Warm up + 3 timed runs per variant
+  ASSERT_EQ(benchmark.runs,
+            8);
+  const int tileSize = kernel.properties().get("defines/TILESIZE", 0);
+  ASSERT_TRUE((tileSize == 16) || (tileSize == 32));
+
+  // Tuned kernels are reused
+  ASSERT_TRUE(builder.autotune(occa::host(), paramSpace, benchmark, 10) == kernel);
+  ASSERT_EQ(benchmark.runs,
+            8);
+
+  // Other builders pick up the stored winner
+  occa::kernelBuilder builder2 = occa::kernelBuilder::fromString(source, "fill", props);
+  occa::kernel kernel2 = builder2.autotune(occa::host(), paramSpace, benchmark, 12);
+  ASSERT_EQ(benchmark.runs,
+            8);
+  ASSERT_EQ(kernel2.properties().get("defines/TILESIZE", 0),
+            tileSize);
+
+  // Problem sizes in other buckets are tuned separately
+  builder2.autotune(occa::host(), paramSpace, benchmark, 1000);
+  ASSERT_EQ(benchmark.runs,
+            16);
+}
+
+void testPgo() {
+  // Unique source to avoid picking up profiles from previous test runs
+  const std::string source = (
+    "@kernel void branchy(const int entries, int *values) {"
+    "  for (int i = 0; i < entries; ++i; @tile(16, @outer, @inner)) {"
+    "    values[i] = (i % 3) ? -i : i;"
+    "  }"
+    "}\n"
+    "// " + occa::toString(rand())
+  );
+  const occa::properties props(
+    "pgo: true,"
+    "pgo_launches: 2"
+  );
+
+  const int entries = 10;
+  int values[entries];
+  occa::memory mem = occa::malloc<int>(entries);
+
+  // Launches past pgo_launches use the profile-optimized binary
+  occa::kernel kernel = occa::buildKernelFromString(source, "branchy", props);
+  for (int i = 0; i < 3; ++i) {
+    kernel(entries, mem);
+    mem.copyTo(values);
+    for (int j = 0; j < entries; ++j) {
+      ASSERT_EQ(values[j],
+                (j % 3) ? -j : j);
+    }
+  }
+
+  // Later builds load it directly
+  occa::kernel optimizedKernel = occa::buildKernelFromString(source, "branchy", props);
+  optimizedKernel(entries, mem);
+  mem.copyTo(values);
+  for (int j = 0; j < entries; ++j) {
+    ASSERT_EQ(values[j],
+              (j % 3) ? -j : j);
+  }
+
+  const int vendor = kernel.properties().get("compiler_vendor", 0);
+  if (vendor & occa::sys::vendor::GNU) {
+    ASSERT_TRUE(occa::endsWith(kernel.binaryFilename(),
+                               occa::kc::pgoBinaryFile));
+    ASSERT_TRUE(occa::endsWith(optimizedKernel.binaryFilename(),
+                               occa::kc::pgoBinaryFile));
+  }
+}
+
+void testTargetIsas() {
+  occa::kernel kernel = occa::buildKernelFromString(
+    "@kernel void scale(const int entries, float *values) {"
+    "  for (int i = 0; i < entries; ++i; @tile(16, @outer, @inner)) {"
+    "    values[i] *= 2;"
+    "  }"
+    "}",
+    "scale",
+    "target_isas: ['avx2', 'avx512']"
+  );
+
+  const int entries = 10;
+  float values[entries];
+  for (int i = 0; i < entries; ++i) {
+    values[i] = i;
+  }
+  occa::memory mem = occa::malloc<float>(entries, values);
+
+  kernel(entries, mem);
+  mem.copyTo(values);
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(values[i],
+              (float) (2 * i));
+  }
+
+  // The best supported ISA is loaded, otherwise the baseline binary
+  const occa::strVector isas = occa::sys::getCpuIsas();
+  const int vendor = kernel.properties().get("compiler_vendor", 0);
+  std::string binarySuffix = occa::kc::binaryFile;
+  if (vendor & occa::sys::vendor::GNU) {
+    if (occa::indexOf(isas, std::string("avx512")) >= 0) {
+      binarySuffix += "_avx512";
+    } else if (occa::indexOf(isas, std::string("avx2")) >= 0) {
+      binarySuffix += "_avx2";
+    }
+  }
+  ASSERT_TRUE(occa::endsWith(kernel.binaryFilename(),
+                             binarySuffix));
+}
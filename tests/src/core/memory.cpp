@@ -4,11 +4,17 @@
 void testMalloc();
 void testCpuWrapMemory();
 void testSlice();
+void testScratch();
+void testMemoryView();
+void testCopyOptions();
 
 int main(const int argc, const char **argv) {
   testMalloc();
   testCpuWrapMemory();
   testSlice();
+  testScratch();
+  testMemoryView();
+  testCopyOptions();
 
   return 0;
 }
@@ -116,3 +122,153 @@ void testSlice() {
   }
   ASSERT_SAME_SIZE(device.memoryAllocated(), 0);
 }
+
+void testScratch() {
+  occa::device device(
+    "mode: 'Serial',"
+    "scratch_bytes: 1024,"
+  );
+
+  ASSERT_THROW(
+    device.scratch(10);
+  );
+
+  {
+    occa::scratchScope scope(device);
+
+    occa::memory a = device.scratch(10, occa::dtype::float_);
+    occa::memory b = device.scratch(1);
+    ASSERT_EQ(a.size(), 10 * sizeof(float));
+    ASSERT_EQ(a.dtype(), occa::dtype::float_);
+    ASSERT_EQ(b.ptr<char>() - a.ptr<char>(),
+              (long) occa::scratchArena_t::alignment);
+    ASSERT_EQ(device.scratchCapacity(), (occa::udim_t) 1024);
+
+    {
+      occa::scratchScope innerScope(device);
+      // Doesn't fit in the first arena
+      occa::memory c = device.scratch(1024);
+      ASSERT_EQ(device.scratchCapacity(), (occa::udim_t) (1024 + 2048));
+    }
+
+    // Inner scope allocations are released
+    occa::memory d = device.scratch(1);
+    ASSERT_EQ(d.ptr<char>() - a.ptr<char>(),
+              (long) (2 * occa::scratchArena_t::alignment));
+  }
+
+  // Arenas are merged once the outermost scope ends
+  ASSERT_EQ(device.scratchCapacity(), (occa::udim_t) 0);
+  {
+    occa::scratchScope scope(device);
+    occa::memory a = device.scratch(2048);
+    ASSERT_EQ(device.scratchCapacity(), (occa::udim_t) (1024 + 2048));
+    ASSERT_EQ(device.memoryAllocated(), (occa::udim_t) (1024 + 2048));
+  }
+  ASSERT_EQ(device.scratchCapacity(), (occa::udim_t) (1024 + 2048));
+
+  // Releases are tagged with the current stream
+  occa::scratchArena_t &arena = device.getModeDevice()->scratchArena;
+  occa::stream defaultStream = device.getStream();
+  ASSERT_EQ(arena.releaseStream, defaultStream.getModeStream());
+
+  occa::stream otherStream = device.createStream();
+  device.setStream(otherStream);
+  {
+    occa::scratchScope scope(device);
+    // Waits for the release on the default stream
+    device.scratch(1);
+    ASSERT_EQ(arena.releaseStream, (occa::modeStream_t*) NULL);
+  }
+  ASSERT_EQ(arena.releaseStream, otherStream.getModeStream());
+  device.setStream(defaultStream);
+}
+
+void testMemoryView() {
+  occa::device device("mode: 'Serial'");
+
+  int values[6] = {0, 1, 2, 3, 4, 5};
+  occa::memory mem = device.malloc<int>(6, values);
+
+  occa::memoryView view;
+  ASSERT_FALSE(view.isInitialized());
+
+  view = occa::memoryView(mem, 2, 3);
+  ASSERT_TRUE(view.getMemory() == mem);
+  ASSERT_EQ(view.offset(), 2 * sizeof(int));
+  ASSERT_EQ(view.size(), 3 * sizeof(int));
+  ASSERT_EQ(view.length(), (occa::udim_t) 3);
+  ASSERT_EQ(view.ptr<int>()[0], 2);
+  ASSERT_EQ((view + 1).ptr<int>()[0], 3);
+  ASSERT_EQ(view.as(occa::dtype::byte).length(), 3 * sizeof(int));
+
+  ASSERT_THROW(
+    view.slice(2, 2);
+  );
+
+  // Views don't allocate backend memory
+  ASSERT_TRUE(view == occa::memoryView(mem).slice(2, 3));
+
+  int hostValues[3];
+  view.copyTo(hostValues);
+  ASSERT_EQ(hostValues[2], 4);
+
+  const int newValue = 10;
+  view.copyFrom(&newValue, sizeof(int), sizeof(int));
+  ASSERT_EQ(mem.ptr<int>()[3], 10);
+
+  // Kernel arguments start at the view offset
+  occa::kernel setFirst = device.buildKernelFromString(
+    "@kernel void setFirst(int *values) {"
+    "  for (int i = 0; i < 1; ++i; @tile(1, @outer, @inner)) {"
+    "    values[i] = -1;"
+    "  }"
+    "}",
+    "setFirst"
+  );
+  setFirst(view + 2);
+  ASSERT_EQ(mem.ptr<int>()[4], -1);
+  ASSERT_EQ(mem.ptr<int>()[3], 10);
+
+  // Offset memory used by backends that can't offset their handles is bounded
+  occa::memory bytes = device.malloc(2 * occa::modeMemory_t::maxOffsetMemory);
+  occa::modeMemory_t *modeMemory = bytes.getModeMemory();
+  for (int i = 1; i < (2 * occa::modeMemory_t::maxOffsetMemory); ++i) {
+    modeMemory->occa::modeMemory_t::makeOffsetKernelArg(i);
+  }
+  ASSERT_EQ((int) modeMemory->offsetMemory.size(),
+            occa::modeMemory_t::maxOffsetMemory);
+  ASSERT_EQ((int) modeMemory->offsetMemory.begin()->first,
+            occa::modeMemory_t::maxOffsetMemory);
+}
+
+void testCopyOptions() {
+  occa::device device("mode: 'Serial'");
+
+  occa::copyOptions defaults;
+  ASSERT_FALSE(defaults.async);
+  ASSERT_EQ(defaults.stream, (occa::modeStream_t*) NULL);
+
+  ASSERT_TRUE(occa::copyOptions(occa::properties("async: true")).async);
+  ASSERT_FALSE(occa::copyOptions(occa::properties()).async);
+
+  occa::stream stream = device.createStream();
+  occa::copyOptions streamOptions(true, stream);
+  ASSERT_EQ(streamOptions.stream, stream.getModeStream());
+
+  int values[4] = {1, 2, 3, 4};
+  occa::memory mem = device.malloc<int>(4);
+  mem.copyFrom(values, streamOptions);
+
+  int hostValues[4] = {0, 0, 0, 0};
+  mem.copyTo(hostValues, 2 * sizeof(int), sizeof(int), occa::copyOptions());
+  ASSERT_EQ(hostValues[0], 2);
+  ASSERT_EQ(hostValues[1], 3);
+
+  occa::memory mem2 = device.malloc<int>(4);
+  mem2.copyFrom(mem, occa::copyOptions(true));
+  ASSERT_EQ(mem2.ptr<int>()[3], 4);
+
+  // The current stream is restored after copying on another stream
+  ASSERT_NEQ(device.getStream().getModeStream(), stream.getModeStream());
+}
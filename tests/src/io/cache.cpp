@@ -2,12 +2,18 @@
 #include <time.h>
 
 #include <occa/io.hpp>
+#include <occa/lang/kernelMetadata.hpp>
 #include <occa/tools/env.hpp>
 #include <occa/tools/testing.hpp>
 
 void testCacheInfoMethods();
 void testHashDir();
 void testBuild();
+void testMetadataFile();
+void testLocalCache();
+void testSharedBinaries();
+void testDefinesIndex();
+void testPackedBuildFile();
 
 int main(const int argc, const char **argv) {
 #ifndef USE_CMAKE
@@ -15,9 +21,17 @@ int main(const int argc, const char **argv) {
 #endif
   srand(time(NULL));
 
+  // Must be set before the local cache path is first queried
+  occa::env::OCCA_LOCAL_CACHE_DIR = occa::env::OCCA_CACHE_DIR + "local_cache/";
+
   testCacheInfoMethods();
   testHashDir();
   testBuild();
+  testMetadataFile();
+  testLocalCache();
+  testSharedBinaries();
+  testDefinesIndex();
+  testPackedBuildFile();
 
   occa::sys::rmdir(occa::env::OCCA_CACHE_DIR + "locks",
                    true);
@@ -95,3 +109,257 @@ void testBuild() {
 
   occa::sys::rmrf("build.json");
 }
+
+void testMetadataFile() {
+  occa::hash_t hash = occa::hash(occa::toString(rand()));
+  const std::string hashDir = occa::io::hashDir(hash);
+  const std::string buildFile = hashDir + occa::kc::buildFile;
+  const std::string metadataFile = (
+    occa::lang::sourceMetadata_t::metadataFilename(buildFile)
+  );
+  ASSERT_EQ(metadataFile,
+            hashDir + occa::kc::buildMetadataFile);
+
+  occa::lang::kernelMetadata_t kernel;
+  kernel.name = "addVectors";
+  kernel += occa::lang::argMetadata_t(false, false, occa::dtype::int_, "entries");
+  kernel += occa::lang::argMetadata_t(true, true, occa::dtype::double_, "a");
+
+  occa::lang::sourceMetadata_t metadata;
+  metadata.kernelsMetadata[kernel.name] = kernel;
+  metadata.dependencyHashes["/a/b.hpp"] = hash;
+  metadata.macroReferences.push_back("N");
+
+  // Binary metadata doesn't need the build file
+  metadata.writeMetadataFile(metadataFile);
+  occa::lang::sourceMetadata_t loaded = (
+    occa::lang::sourceMetadata_t::fromBuildFile(buildFile)
+  );
+  ASSERT_EQ(loaded.getKernelMetadataJson(),
+            metadata.getKernelMetadataJson());
+  ASSERT_EQ(loaded.getDependencyJson(),
+            metadata.getDependencyJson());
+  ASSERT_EQ(loaded.getMacroReferencesJson(),
+            metadata.getMacroReferencesJson());
+  ASSERT_EQ(loaded.kernelsMetadata["addVectors"].arguments[1].dtype,
+            occa::dtype::double_);
+
+  // Invalid metadata files fall back on the build file
+  occa::properties buildProps;
+  buildProps["kernel/metadata"] = metadata.getKernelMetadataJson();
+  buildProps["kernel/dependencies"] = metadata.getDependencyJson();
+  buildProps["kernel/macro_references"] = metadata.getMacroReferencesJson();
+  buildProps.write(buildFile);
+
+  const std::string contents = occa::io::read(metadataFile, true);
+  occa::io::write(metadataFile, contents.substr(0, contents.size() - 1));
+  occa::lang::sourceMetadata_t partial;
+  ASSERT_FALSE(
+    occa::lang::sourceMetadata_t::loadMetadataFile(metadataFile, partial)
+  );
+
+  loaded = occa::lang::sourceMetadata_t::fromBuildFile(buildFile);
+  ASSERT_EQ(loaded.getKernelMetadataJson(),
+            metadata.getKernelMetadataJson());
+  ASSERT_EQ(loaded.getDependencyJson(),
+            metadata.getDependencyJson());
+
+  occa::sys::rmdir(hashDir, true);
+}
+
+void testLocalCache() {
+  occa::hash_t hash = occa::hash(occa::toString(rand()));
+  const std::string hashDir = occa::io::hashDir(hash);
+  const std::string localDir = occa::io::localHashDir(hashDir);
+
+  ASSERT_EQ(localDir,
+            occa::io::localCachePath() + hash.getString() + "/");
+  ASSERT_EQ(occa::io::localHashDir("foo/"),
+            "");
+
+  occa::strVector metadataFiles;
+  metadataFiles.push_back("build.json");
+
+  occa::io::write(hashDir + "binary", "binary");
+  occa::io::write(hashDir + "build.json", "{}");
+
+  // Incomplete files are not cached
+  ASSERT_EQ(occa::io::findCachedFile(hashDir, "binary", metadataFiles),
+            "");
+  ASSERT_FALSE(occa::io::isFile(localDir + "binary"));
+
+  // Shared hits are copied into the local cache
+  occa::io::markCachedFileComplete(hashDir, "binary");
+  ASSERT_EQ(occa::io::findCachedFile(hashDir, "binary", metadataFiles),
+            localDir);
+  ASSERT_EQ(occa::io::read(localDir + "binary"),
+            "binary");
+  ASSERT_EQ(occa::io::read(localDir + "build.json"),
+            "{}");
+
+  // Local hits don't touch the shared cache
+  occa::sys::rmdir(hashDir, true);
+  ASSERT_EQ(occa::io::findCachedFile(hashDir, "binary", metadataFiles),
+            localDir);
+
+  occa::sys::rmdir(occa::env::OCCA_LOCAL_CACHE_DIR, true);
+  occa::sys::rmdir(occa::io::cachePath());
+}
+
+void testSharedBinaries() {
+  const std::string hashDir1 = occa::io::hashDir(occa::hash(occa::toString(rand())));
+  const std::string hashDir2 = occa::io::hashDir(occa::hash(occa::toString(rand())));
+
+  occa::io::write(hashDir1 + "source.cpp", "source");
+  occa::io::write(hashDir2 + "source.cpp", "source");
+
+  // Kernel hash directories are ignored
+  const occa::hash_t binaryHash = occa::io::compiledBinaryHash(
+    hashDir1 + "source.cpp",
+    "g++ -O3 " + hashDir1 + "source.cpp -o " + hashDir1 + "binary",
+    hashDir1
+  );
+  ASSERT_EQ(binaryHash,
+            occa::io::compiledBinaryHash(
+              hashDir2 + "source.cpp",
+              "g++ -O3 " + hashDir2 + "source.cpp -o " + hashDir2 + "binary",
+              hashDir2
+            ));
+  ASSERT_NEQ(binaryHash,
+             occa::io::compiledBinaryHash(
+               hashDir2 + "source.cpp",
+               "g++ -O2 " + hashDir2 + "source.cpp -o " + hashDir2 + "binary",
+               hashDir2
+             ));
+
+  ASSERT_FALSE(occa::io::loadSharedBinary(binaryHash, hashDir2 + "binary"));
+
+  occa::io::write(hashDir1 + "binary", "binary");
+  occa::io::storeSharedBinary(binaryHash, hashDir1 + "binary");
+
+  ASSERT_TRUE(occa::io::loadSharedBinary(binaryHash, hashDir2 + "binary"));
+  ASSERT_EQ(occa::io::read(hashDir2 + "binary"),
+            "binary");
+
+  occa::sys::rmdir(hashDir1, true);
+  occa::sys::rmdir(hashDir2, true);
+  occa::sys::rmdir(occa::io::binaryHashDir(binaryHash), true);
+  occa::sys::rmdir(occa::io::cachePath() + "binaries");
+  occa::sys::rmdir(occa::env::OCCA_LOCAL_CACHE_DIR, true);
+  occa::sys::rmdir(occa::io::cachePath());
+}
+
+void testDefinesIndex() {
+  const occa::hash_t definesFreeHash = occa::hash(occa::toString(rand()));
+  const occa::hash_t kernelHash = occa::hash(occa::toString(rand()));
+  const std::string hashDir = occa::io::hashDir(kernelHash);
+
+  occa::json defines = occa::json::parse("{ N: 1, UNUSED: 1 }");
+
+  ASSERT_FALSE(occa::io::findKernelWithDefines(definesFreeHash, defines).initialized);
+
+  // Builds without macro references aren't registered
+  occa::io::write(hashDir + "build.json", "{}");
+  occa::io::registerKernelDefines(definesFreeHash, kernelHash, defines);
+  ASSERT_FALSE(occa::io::isFile(occa::io::definesIndexFile(definesFreeHash)));
+
+  occa::sys::rmrf(hashDir + "build.json");
+  occa::io::write(hashDir + "build.json",
+                  "{ kernel: { macro_references: ['M', 'N'] } }");
+  occa::io::registerKernelDefines(definesFreeHash, kernelHash, defines);
+
+  ASSERT_EQ(occa::io::findKernelWithDefines(definesFreeHash, defines),
+            kernelHash);
+  ASSERT_EQ(occa::io::findKernelWithDefines(definesFreeHash,
+                                            occa::json::parse("{ N: 1, UNUSED: 2 }")),
+            kernelHash);
+  ASSERT_EQ(occa::io::findKernelWithDefines(definesFreeHash,
+                                            occa::json::parse("{ N: 1 }")),
+            kernelHash);
+  ASSERT_FALSE(occa::io::findKernelWithDefines(definesFreeHash,
+                                               occa::json::parse("{ N: 2 }")).initialized);
+  ASSERT_FALSE(occa::io::findKernelWithDefines(definesFreeHash,
+                                               occa::json::parse("{ N: 1, M: 1 }")).initialized);
+
+  // Cleared builds are ignored
+  occa::sys::rmdir(hashDir, true);
+  ASSERT_FALSE(occa::io::findKernelWithDefines(definesFreeHash, defines).initialized);
+
+  occa::sys::rmdir(occa::io::cachePath() + "defines/", true);
+  occa::sys::rmdir(occa::io::cachePath());
+}
+
+void testPackedBuildFile() {
+  occa::env::OCCA_CACHE_PACK = true;
+
+  // Kernels are staged in the node-local cache
+  occa::hash_t hash = occa::hash(occa::toString(rand()));
+  const std::string hashDir = occa::io::hashDir(hash);
+  ASSERT_EQ(occa::io::localHashDir(hashDir),
+            hashDir);
+  ASSERT_EQ(hashDir,
+            occa::io::localCachePath() + hash.getString() + "/");
+
+  ASSERT_EQ(occa::io::cachedBuildFile(hashDir),
+            "");
+
+  occa::io::pack_t &pack = occa::io::cachePack();
+  pack.append(occa::io::packKey(hashDir, occa::kc::buildMetadataFile),
+              "metadata");
+  pack.append(occa::io::packKey(hashDir, occa::kc::buildFile),
+              "{}");
+
+  // Build info is extracted from the pack before the binary
+  ASSERT_EQ(occa::io::cachedBuildFile(hashDir),
+            hashDir + occa::kc::buildFile);
+  ASSERT_EQ(occa::io::read(hashDir + occa::kc::buildFile),
+            "{}");
+  ASSERT_EQ(occa::io::read(hashDir + occa::kc::buildMetadataFile),
+            "metadata");
+
+  // Binaries are extracted into the node-local cache
+  occa::strVector metadataFiles;
+  metadataFiles.push_back(occa::kc::buildFile);
+  ASSERT_EQ(occa::io::findCachedFile(hashDir, "binary", metadataFiles),
+            "");
+  pack.append(occa::io::packKey(hashDir, "binary"),
+              "binary");
+  occa::sys::rmdir(hashDir, true);
+  ASSERT_EQ(occa::io::findCachedFile(hashDir, "binary", metadataFiles),
+            hashDir);
+  ASSERT_EQ(occa::io::read(hashDir + "binary"),
+            "binary");
+  ASSERT_EQ(occa::io::read(hashDir + occa::kc::buildFile),
+            "{}");
+
+  // Replaced packs are reindexed, even if they grew
+  const std::string key = occa::io::packKey(hashDir, "binary");
+  const occa::udim_t packBytes = pack.bytes();
+  occa::sys::rmrf(occa::io::cachePackFilename());
+  ASSERT_FALSE(pack.has(key));
+  pack.append("padding", std::string(packBytes, ' '));
+  pack.append(key, "new binary");
+  ASSERT_EQ(pack.read(key),
+            "new binary");
+
+  // Eviction drops the oldest entries together with their metadata
+  occa::sys::rmrf(occa::io::cachePackFilename());
+  const occa::udim_t maxBytes = 4096;
+  pack.append("old/build.json", "{}", maxBytes);
+  pack.append("old/binary", std::string(1024, 'o'), maxBytes);
+  pack.append("new/build.json", "{}", maxBytes);
+  ASSERT_EQ(pack.size(), (occa::udim_t) 3);
+
+  pack.append("new/binary", std::string(3000, 'n'), maxBytes);
+  ASSERT_FALSE(pack.has("old/build.json"));
+  ASSERT_FALSE(pack.has("old/binary"));
+  ASSERT_EQ(pack.read("new/build.json"),
+            "{}");
+  ASSERT_EQ(pack.read("new/binary"),
+            std::string(3000, 'n'));
+  ASSERT_LE(pack.bytes(), maxBytes);
+
+  occa::sys::rmrf(occa::io::cachePackFilename());
+  occa::sys::rmdir(occa::env::OCCA_LOCAL_CACHE_DIR, true);
+  occa::env::OCCA_CACHE_PACK = false;
+}
@@ -0,0 +1,113 @@
+#include <stdlib.h>
+#include <time.h>
+
+#include <occa/io.hpp>
+#include <occa/tools/env.hpp>
+#include <occa/tools/testing.hpp>
+
+void testAppend();
+void testReload();
+void testExtract();
+void testTornRecord();
+void clearPack();
+
+const std::string packFile = occa::env::CWD + "test.pack";
+
+int main(const int argc, const char **argv) {
+#ifndef USE_CMAKE
+  occa::env::OCCA_CACHE_DIR = occa::io::dirname(__FILE__);
+#endif
+  srand(time(NULL));
+
+  clearPack();
+
+  testAppend();
+  testReload();
+  testExtract();
+  testTornRecord();
+
+  clearPack();
+  occa::sys::rmdir(occa::env::OCCA_CACHE_DIR + "locks",
+                   true);
+
+  return 0;
+}
+
+void testAppend() {
+  occa::io::pack_t pack(packFile);
+  ASSERT_EQ((int) pack.size(),
+            0);
+  ASSERT_FALSE(pack.has("a/binary"));
+
+  ASSERT_TRUE(pack.append("a/binary", std::string("bin\0ary", 7)));
+  ASSERT_TRUE(pack.append("a/build.json", "{}"));
+  ASSERT_TRUE(pack.has("a/binary"));
+  ASSERT_EQ((int) pack.size(),
+            2);
+
+  ASSERT_EQ(pack.read("a/binary"),
+            std::string("bin\0ary", 7));
+  ASSERT_EQ(pack.read("a/build.json"),
+            "{}");
+  ASSERT_EQ(pack.read("b/binary"),
+            "");
+
+  // Existing keys are not appended again
+  ASSERT_TRUE(pack.append("a/binary", "other"));
+  ASSERT_EQ(pack.read("a/binary"),
+            std::string("bin\0ary", 7));
+}
+
+void testReload() {
+  occa::io::pack_t pack(packFile);
+  ASSERT_EQ((int) pack.size(),
+            2);
+  ASSERT_EQ(pack.read("a/build.json"),
+            "{}");
+
+  // Records appended by other processes are picked up
+  occa::io::pack_t otherPack(packFile);
+  ASSERT_TRUE(otherPack.append("b/binary", "b"));
+  ASSERT_EQ(pack.read("b/binary"),
+            "b");
+}
+
+void testExtract() {
+  occa::io::pack_t pack(packFile);
+  const std::string extractedFile = occa::env::CWD + "test_extracted_binary";
+
+  ASSERT_FALSE(pack.extract("c/binary", extractedFile));
+  ASSERT_FALSE(occa::io::isFile(extractedFile));
+
+  ASSERT_TRUE(pack.extract("a/binary", extractedFile));
+  ASSERT_EQ(occa::io::read(extractedFile, true),
+            std::string("bin\0ary", 7));
+
+  occa::sys::rmrf(extractedFile);
+}
+
+void testTornRecord() {
+  // Simulate a process crashing halfway through an append
+  FILE *fp = fopen(packFile.c_str(), "ab");
+  fwrite(occa::io::pack_t::magic, sizeof(char), 4, fp);
+  fwrite("torn", sizeof(char), 4, fp);
+  fclose(fp);
+
+  occa::io::pack_t pack(packFile);
+  ASSERT_EQ((int) pack.size(),
+            3);
+
+  ASSERT_TRUE(pack.append("d/binary", "d"));
+  ASSERT_EQ((int) pack.size(),
+            4);
+
+  occa::io::pack_t otherPack(packFile);
+  ASSERT_EQ(otherPack.read("d/binary"),
+            "d");
+}
+
+void clearPack() {
+  if (occa::io::isFile(packFile)) {
+    occa::sys::rmrf(packFile);
+  }
+}
@@ -126,7 +126,7 @@ void testDirMethods() {
   // Find files
   occa::strVector files = occa::io::files(ioDir);
   ASSERT_EQ((int) files.size(),
-            5);
+            6);
   ASSERT_IN(ioDir + "cache.cpp", files);
   ASSERT_IN(ioDir + "fileOpener.cpp", files);
   ASSERT_IN(ioDir + "lock.cpp", files);
@@ -145,8 +145,9 @@ void testDirMethods() {
             0);
   dirs = occa::io::directories(testDir);
   ASSERT_EQ((int) dirs.size(),
-            7);
+            8);
 
+  ASSERT_IN(testDir + "array/", dirs);
   ASSERT_IN(testDir + "c/", dirs);
   ASSERT_IN(testDir + "io/", dirs);
   ASSERT_IN(testDir + "lang/", dirs);
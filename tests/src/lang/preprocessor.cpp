@@ -12,6 +12,8 @@ void testCppStandardTests();
 void testIfElse();
 void testIfElseDefines();
 void testIfWithUndefines();
+void testMacroReferences();
+void testUndefDefines();
 void testErrorDefines();
 void testOccaMacros();
 void testSpecialMacros();
@@ -81,6 +83,8 @@ int main(const int argc, const char **argv) {
   testIfElse();
   testIfElseDefines();
   testIfWithUndefines();
+  testMacroReferences();
+  testUndefDefines();
   testErrorDefines();
   testOccaMacros();
   testSpecialMacros();
@@ -503,6 +507,69 @@ void testIfWithUndefines() {
             (int) nextTokenPrimitiveValue());
 }
 
+void testMacroReferences() {
+  setStream(
+    "#define A 1\n"
+    "#undef B\n"
+    "#ifdef C\n"
+    "  D\n"
+    "#else\n"
+    "  E\n"
+    "#endif\n"
+  );
+  while (!tokenStream.isEmpty()) {
+    getToken();
+  }
+
+  // Defining a macro doesn't reference it and skipped branches
+  //   are never looked at
+  // Undefining a macro references it since it may be a define
+  //   from the kernel properties
+  preprocessor_t &pp = *((preprocessor_t*) tokenStream.getInput("preprocessor_t"));
+  occa::strVector references = pp.getMacroReferences();
+  ASSERT_EQ(3,
+            (int) references.size());
+  ASSERT_EQ("B", references[0]);
+  ASSERT_EQ("C", references[1]);
+  ASSERT_EQ("E", references[2]);
+}
+
+void testUndefDefines() {
+  // Defines from properties
+  setStream(
+    "#undef FOO\n"
+    "#ifdef FOO\n"
+    "  1\n"
+    "#else\n"
+    "  0\n"
+    "#endif\n"
+  );
+  preprocessor.addSourceDefine("FOO", "1");
+  ASSERT_EQ(0,
+            (int) nextTokenPrimitiveValue());
+
+  // Compiler defines
+  setStream(
+    "#undef BAR\n"
+    "#undef __OKL__\n"
+    "#if defined(BAR) || defined(__OKL__)\n"
+    "  1\n"
+    "#else\n"
+    "  0\n"
+    "#endif\n"
+  );
+  preprocessor.addCompilerDefine("BAR", "1");
+  ASSERT_EQ(0,
+            (int) nextTokenPrimitiveValue());
+
+  // Builtin compiler defines are added back when cleared
+  setStream(
+    "__OKL__"
+  );
+  ASSERT_EQ(1,
+            (int) nextTokenPrimitiveValue());
+}
+
 void testErrorDefines() {
   std::cerr << "Testing error and warning directives\n";
   setStream(
@@ -0,0 +1,290 @@
+#include <occa.hpp>
+#include <occa/mpi.hpp>
+#include <occa/tools/testing.hpp>
+
+void testHostTransfers();
+void testPipelinedTransfers();
+void testHaloExchange(const std::string &deviceInfo);
+void testReductions();
+
+int main(const int argc, const char **argv) {
+  MPI_Init(NULL, NULL);
+
+  testHostTransfers();
+  testPipelinedTransfers();
+  testHaloExchange("mode: 'Serial'");
+  testHaloExchange("mode: 'Serial', separate_memory_space: true");
+  testReductions();
+
+  MPI_Finalize();
+
+  return 0;
+}
+
+void testHostTransfers() {
+  occa::device device("mode: 'Serial'");
+  ASSERT_FALSE(device.hasSeparateMemorySpace());
+
+  const int entries = 10;
+  int values[entries];
+  for (int i = 0; i < entries; ++i) {
+    values[i] = i;
+  }
+
+  occa::memory src = device.malloc<int>(entries, values);
+  occa::memory dest = device.malloc<int>(entries);
+
+  const int self = occa::mpi::id();
+  occa::mpi::tags tags;
+  tags += occa::mpi::get<int>(self, dest);
+  tags += occa::mpi::send<int>(self, src);
+  tags.wait();
+
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(dest.ptr<int>()[i], i);
+  }
+}
+
+void testPipelinedTransfers() {
+  occa::device device("mode: 'Serial', separate_memory_space: true");
+  ASSERT_TRUE(device.hasSeparateMemorySpace());
+
+  // Split the transfer into uneven chunks
+  const int bufferSize = occa::mpi::buffer_t::size;
+  occa::mpi::buffer_t::size = 4 * sizeof(int);
+
+  const int entries = 23;
+  int values[entries];
+  for (int i = 0; i < entries; ++i) {
+    values[i] = 2 * i;
+  }
+
+  occa::memory src = device.malloc<int>(entries, values);
+  occa::memory dest = device.malloc<int>(entries);
+
+  const int self = occa::mpi::id();
+  occa::mpi::tag sendTag = occa::mpi::send<int>(self, src);
+  ASSERT_TRUE(sendTag.isInitialized());
+
+  // Copies share the chunk requests
+  occa::mpi::tags tags;
+  tags += sendTag;
+
+  // Receives are copied in while tags are waited on
+  occa::mpi::tag getTag = occa::mpi::get<int>(self, dest);
+  ASSERT_TRUE(getTag.isInitialized());
+  tags += getTag;
+  tags.wait();
+  sendTag.wait();
+  ASSERT_TRUE(sendTag.done);
+
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(dest.ptr<int>()[i], 2 * i);
+  }
+
+  // Transfers with the same message ID are matched in order, and sends
+  //   to a rank that is also sending back don't block
+  const int ranks = occa::mpi::size();
+  const int next = (self + 1) % ranks;
+  const int previous = (self + ranks - 1) % ranks;
+
+  for (int i = 0; i < entries; ++i) {
+    values[i] = 3 * i;
+  }
+  occa::memory src2 = device.malloc<int>(entries, values);
+  occa::memory dest2 = device.malloc<int>(entries);
+
+  occa::mpi::tags orderedTags;
+  orderedTags += occa::mpi::send<int>(next, src);
+  orderedTags += occa::mpi::send<int>(next, src2);
+  orderedTags += occa::mpi::get<int>(previous, dest);
+  orderedTags += occa::mpi::get<int>(previous, dest2);
+  orderedTags.wait();
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(dest.ptr<int>()[i], 2 * i);
+    ASSERT_EQ(dest2.ptr<int>()[i], 3 * i);
+  }
+
+  // Partial transfers
+  occa::memory partial = device.malloc<int>(entries);
+  occa::mpi::tag partialTag = occa::mpi::send<int>(self, src, 9);
+  occa::mpi::get<int>(self, partial, 9).wait();
+  partialTag.wait();
+  for (int i = 0; i < 9; ++i) {
+    ASSERT_EQ(partial.ptr<int>()[i], 2 * i);
+  }
+
+  // Empty transfers are done right away
+  occa::mpi::tag emptyTag = occa::mpi::get<int>(self, partial, 0);
+  ASSERT_TRUE(emptyTag.isInitialized());
+  ASSERT_TRUE(emptyTag.done);
+
+  occa::mpi::buffer_t::size = bufferSize;
+}
+
+void testHaloExchange(const std::string &deviceInfo) {
+  occa::device device(deviceInfo);
+  const int self = occa::mpi::id();
+
+  // Periodic 1D field with one ghost entry on each side
+  const int entries = 12;
+  int values[entries];
+  for (int i = 0; i < entries; ++i) {
+    values[i] = (0 < i && i < (entries - 1)) ? i : -1;
+  }
+  occa::memory field = device.malloc<int>(entries, values);
+
+  occa::mpi::haloNeighborVector neighbors;
+  neighbors.push_back(
+    occa::mpi::haloNeighbor(self)
+    .send(1, 2, entries - 3)
+    .receive(std::vector<int>(1, entries - 1))
+    .receive(std::vector<int>(1, 0))
+  );
+
+  occa::mpi::haloExchange halo(field, neighbors);
+  for (int step = 0; step < 2; ++step) {
+    occa::mpi::tags tags = halo.start();
+    ASSERT_EQ(tags.size(), 2);
+    halo.finish();
+
+    field.copyTo(values);
+    ASSERT_EQ(values[0], entries - 2);
+    ASSERT_EQ(values[entries - 1], 1);
+
+    // Updated interiors are picked up by the next exchange
+    values[1] = 100 + step;
+    values[entries - 2] = 200 + step;
+    field.copyFrom(values);
+    halo.exchange();
+
+    field.copyTo(values);
+    ASSERT_EQ(values[0], 200 + step);
+    ASSERT_EQ(values[entries - 1], 100 + step);
+
+    values[1] = 1;
+    values[entries - 2] = entries - 2;
+    field.copyFrom(values);
+  }
+
+  // Strided columns of a row-major 4x3 double field
+  const int rows = 4, columns = 3;
+  double grid[rows * columns];
+  for (int i = 0; i < (rows * columns); ++i) {
+    grid[i] = i;
+  }
+  occa::memory gridField = device.malloc<double>(rows * columns, grid);
+
+  occa::mpi::haloNeighborVector gridNeighbors;
+  gridNeighbors.push_back(
+    occa::mpi::haloNeighbor(self)
+    .send(1, rows, columns)
+    .receive(columns - 1, rows, columns)
+  );
+  occa::mpi::haloExchange gridHalo(gridField, gridNeighbors);
+  gridHalo.exchange();
+
+  gridField.copyTo(grid);
+  for (int r = 0; r < rows; ++r) {
+    ASSERT_EQ(grid[(r * columns) + columns - 1],
+              (double) ((r * columns) + 1));
+    ASSERT_EQ(grid[r * columns], (double) (r * columns));
+  }
+
+  // Out of bounds indices are rejected
+  occa::mpi::haloNeighborVector badNeighbors;
+  badNeighbors.push_back(
+    occa::mpi::haloNeighbor(self).send(entries, 1)
+  );
+  ASSERT_THROW(
+    occa::mpi::haloExchange badHalo(field, badNeighbors);
+  );
+
+  // The same rank as both neighbors, tagged by the direction halos travel
+  const int left = 0, right = 1;
+  for (int i = 0; i < entries; ++i) {
+    values[i] = (0 < i && i < (entries - 1)) ? i : -1;
+  }
+  field.copyFrom(values);
+
+  occa::mpi::haloNeighborVector taggedNeighbors;
+  taggedNeighbors.push_back(
+    occa::mpi::haloNeighbor(self, right, left)
+    .send(std::vector<int>(1, entries - 2))
+    .receive(std::vector<int>(1, entries - 1))
+  );
+  taggedNeighbors.push_back(
+    occa::mpi::haloNeighbor(self, left, right)
+    .send(std::vector<int>(1, 1))
+    .receive(std::vector<int>(1, 0))
+  );
+  occa::mpi::haloExchange taggedHalo(field, taggedNeighbors);
+  taggedHalo.exchange();
+
+  field.copyTo(values);
+  ASSERT_EQ(values[0], entries - 2);
+  ASSERT_EQ(values[entries - 1], 1);
+
+  // Repeated rank and tag pairs are rejected
+  occa::mpi::haloNeighborVector repeatedNeighbors;
+  repeatedNeighbors.push_back(
+    occa::mpi::haloNeighbor(self).send(1, 1)
+  );
+  repeatedNeighbors.push_back(
+    occa::mpi::haloNeighbor(self).send(2, 1)
+  );
+  ASSERT_THROW(
+    occa::mpi::haloExchange repeatedHalo(field, repeatedNeighbors);
+  );
+}
+
+void testReductions() {
+  occa::device device("mode: 'Serial'");
+  occa::setDevice(device);
+
+  const int ranks = occa::mpi::size();
+  const int entries = 10;
+  double values[entries];
+  for (int i = 0; i < entries; ++i) {
+    values[i] = i - 4;
+  }
+  occa::memory vec = device.malloc<double>(entries, values);
+
+  double absValues[entries];
+  for (int i = 0; i < entries; ++i) {
+    absValues[i] = fabs(values[i]);
+  }
+  occa::memory absVec = device.malloc<double>(entries, absValues);
+
+  // Sum-only reductions
+  occa::mpi::reductions sums;
+  const int dotIndex = sums.dot<double, double>(vec, vec);
+  const int sumIndex = sums.sum<double>(vec);
+  const int l2Index  = sums.l2Norm<double>(vec);
+  const int l3Index  = sums.lpNorm<double>(3, absVec);
+  sums.start();
+  ASSERT_EQ(sums[dotIndex], 85.0 * ranks);
+  ASSERT_EQ(sums[sumIndex], 5.0 * ranks);
+  ASSERT_LE(fabs(sums[l2Index] - sqrt(85.0 * ranks)), 1e-10);
+  ASSERT_LE(fabs(sums[l3Index] - pow(325.0 * ranks, 1.0 / 3.0)), 1e-10);
+
+  // Mixed operations share one request
+  occa::mpi::reductions mixed;
+  const int maxIndex = mixed.max<double>(vec);
+  const int l1Index  = mixed.l1Norm<double>(vec);
+  const int minIndex = mixed.min<double>(vec);
+  const int rankIndex = mixed.max((double) occa::mpi::id());
+  mixed.start();
+  mixed.wait();
+  ASSERT_TRUE(mixed.isDone());
+  ASSERT_EQ(mixed[maxIndex], 5.0);
+  ASSERT_EQ(mixed[l1Index], 25.0 * ranks);
+  ASSERT_EQ(mixed[minIndex], -4.0);
+  ASSERT_EQ(mixed[rankIndex], (double) (ranks - 1));
+
+  // Reuse after clearing
+  mixed.clear();
+  ASSERT_EQ(mixed.size(), 0);
+  const int minOnly = mixed.min(3.0);
+  ASSERT_EQ(mixed[minOnly], 3.0);
+}
@@ -16,6 +16,8 @@ void testMethods();
 void testSize();
 void testTruthyValues();
 void testComparisons();
+void testHash();
+void testCopyOnWrite();
 void testConversions();
 void testErrors();
 
@@ -31,6 +33,8 @@ int main(const int argc, const char **argv) {
   testSize();
   testTruthyValues();
   testComparisons();
+  testHash();
+  testCopyOnWrite();
   testConversions();
   testErrors();
 
@@ -236,12 +240,12 @@ void testKeywords() {
   j.load("true");
   ASSERT_TRUE(j.isBoolean());
   ASSERT_EQ(true,
-            j.value_.boolean);
+            j.value_.boolean());
 
   j.load("false");
   ASSERT_TRUE(j.isBoolean());
   ASSERT_EQ(false,
-            j.value_.boolean);
+            j.value_.boolean());
 
   j.load("null");
   ASSERT_TRUE(j.isNull());
@@ -395,6 +399,134 @@ void testComparisons() {
   }
 }
 
+void testHash() {
+  occa::json a = occa::json::parse("{ a: 1, b: { c: 'c', d: [1, 2] } }");
+  occa::json b = occa::json::parse("{ b: { d: [1, 2], c: 'c' }, a: 1 }");
+  ASSERT_EQ(a.hash(), b.hash());
+  ASSERT_EQ(a.hash(), occa::hash(a));
+
+  // Copies share the memoized hash
+  occa::json c = a;
+  ASSERT_EQ(a.hash(), c.hash());
+
+  // Nested mutations invalidate the memoized hash
+  const occa::hash_t aHash = a.hash();
+  a["b/c"] = "d";
+  ASSERT_NEQ(aHash, a.hash());
+  a["b"]["c"] = "c";
+  ASSERT_EQ(aHash, a.hash());
+
+  a["b/d"][1] = 3;
+  ASSERT_NEQ(aHash, a.hash());
+  a["b/d"][1] = 2;
+  ASSERT_EQ(aHash, a.hash());
+
+  a.remove("b/c");
+  ASSERT_NEQ(aHash, a.hash());
+  a["b"].set("c", "c");
+  ASSERT_EQ(aHash, a.hash());
+
+  a += occa::json::parse("{ e: true }");
+  ASSERT_NEQ(aHash, a.hash());
+
+  // Hashes of nodes written through mutable accessors are still memoized
+  occa::json props;
+  props["a/b"] = 1;
+  occa::hash_t cachedHash;
+  ASSERT_FALSE(props.value_.getCachedHash(props.type, cachedHash));
+  const occa::hash_t propsHash = props.hash();
+  ASSERT_TRUE(props.value_.getCachedHash(props.type, cachedHash));
+  ASSERT_EQ(propsHash, cachedHash);
+  ASSERT_EQ(propsHash, props.hash());
+  props["a/b"] = 2;
+  ASSERT_FALSE(props.value_.getCachedHash(props.type, cachedHash));
+  ASSERT_NEQ(propsHash, props.hash());
+
+  // Held references can mutate nodes after their parents were hashed
+  occa::json p = occa::json::parse("{ a: { b: 0 } }");
+  occa::json &pa = p["a"];
+  const occa::hash_t pHash = p.hash();
+  pa["b"] = 1;
+  ASSERT_NEQ(pHash, p.hash());
+  pa["b"] = 0;
+  ASSERT_EQ(pHash, p.hash());
+
+  // Copies don't share later mutations
+  occa::json q = p;
+  ASSERT_EQ(pHash, q.hash());
+  p["a/b"] = 2;
+  ASSERT_NEQ(pHash, p.hash());
+  ASSERT_EQ(pHash, q.hash());
+
+  // Direct writes to the value or type
+  q.value_.writeObject()["c"] = 3;
+  const occa::hash_t qHash = q.hash();
+  ASSERT_NEQ(pHash, qHash);
+  q.type = occa::json::null_;
+  ASSERT_NEQ(qHash, q.hash());
+
+  // Types are part of the hash
+  ASSERT_NEQ(occa::json::parse("1").hash(),
+             occa::json::parse("'1'").hash());
+  ASSERT_NEQ(occa::json::parse("[1, 1]").hash(),
+             occa::json::parse("[]").hash());
+  ASSERT_NEQ(occa::json::parse("{ a: [1] }").hash(),
+             occa::json::parse("{ a: 1 }").hash());
+}
+
+void testCopyOnWrite() {
+  occa::json a = occa::json::parse("{ a: 1, b: { c: 'c', d: [1, 2] } }");
+
+  // Copies share payloads until they're modified
+  occa::json b = a;
+  ASSERT_TRUE(a.value_.sharesPayload(b.value_));
+
+  b.set("e", 2);
+  ASSERT_FALSE(a.value_.sharesPayload(b.value_));
+  ASSERT_FALSE(a.has("e"));
+  ASSERT_TRUE(
+    a.object().find("b")->second.value_.sharesPayload(
+      b.object().find("b")->second.value_
+    )
+  );
+
+  // Merging only copies the objects along changed keys
+  occa::json sum = a + occa::json::parse("{ b: { c: 'd' } }");
+  ASSERT_EQ((std::string) a["b/c"], "c");
+  ASSERT_EQ((std::string) sum["b/c"], "d");
+  const occa::json &constA = a;
+  const occa::json &constSum = sum;
+  ASSERT_TRUE(
+    constA["b/d"].value_.sharesPayload(constSum["b/d"].value_)
+  );
+
+  // Values written through mutable references are shared again by copies
+  occa::json &d = a["b/d"];
+  d[0] = 3;
+  occa::json c = a;
+  ASSERT_TRUE(a.value_.sharesPayload(c.value_));
+  a["b/d"][0] = 4;
+  ASSERT_EQ((int) a["b/d"][0], 4);
+  ASSERT_EQ((int) c["b/d"][0], 3);
+
+  c.object()["f"] = true;
+  occa::json c2 = c;
+  ASSERT_TRUE(c.value_.sharesPayload(c2.value_));
+  c.object()["g"] = true;
+  ASSERT_TRUE(c.has("f"));
+  ASSERT_TRUE(c2.has("f"));
+  ASSERT_TRUE(c.has("g"));
+  ASSERT_FALSE(c2.has("g"));
+
+  // Scalars are stored inline
+  occa::json e = c["f"];
+  c["f"] = 1;
+  ASSERT_TRUE(e.isBoolean());
+  ASSERT_TRUE((bool) e);
+  ASSERT_TRUE(c["f"].isNumber());
+  ASSERT_EQ((int) c["f"], 1);
+}
+
 void testConversions() {
   occa::json j = occa::json::parse(
     "{"
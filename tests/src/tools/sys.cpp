@@ -7,11 +7,13 @@
 #include <occa/tools/testing.hpp>
 
 void testRmrf();
+void testCpuIsas();
 
 int main(const int argc, const char **argv) {
   srand(time(NULL));
 
   testRmrf();
+  testCpuIsas();
 
   return 0;
 }
@@ -64,3 +66,22 @@ void testRmrf() {
   occa::settings()["sys/safe_rmrf"] = false;
   occa::sys::rmrf(filename);
 }
+
+void testCpuIsas() {
+  const occa::strVector features = occa::sys::getCpuFeatures();
+  const occa::strVector isas = occa::sys::getCpuIsas();
+
+  // ISAs are derived from the detected features
+  ASSERT_LE(isas.size(),
+            features.size());
+  if (occa::indexOf(isas, std::string("avx2")) >= 0) {
+    ASSERT_TRUE(occa::indexOf(features, std::string("fma")) >= 0);
+  }
+
+  ASSERT_EQ(occa::sys::compilerIsaFlags(occa::sys::vendor::GNU, "avx2"),
+            "-mavx2 -mfma");
+  ASSERT_EQ(occa::sys::compilerIsaFlags(occa::sys::vendor::GNU, "foo"),
+            "");
+  ASSERT_EQ(occa::sys::compilerIsaFlags(occa::sys::vendor::VisualStudio, "avx2"),
+            "");
+}
@@ -3,11 +3,15 @@
 #include <occa.hpp>
 
 void testPtrRange();
+void testByteRangeSet();
+void testUvaRegistry();
 void testUva();
 void testUvaNull();
 
 int main(const int argc, const char **argv) {
   testPtrRange();
+  testByteRangeSet();
+  testUvaRegistry();
   testUva();
   testUvaNull();
 
@@ -64,6 +68,74 @@ void testPtrRange() {
   std::cout << "Testing ptrRange output: " << range << '\n';
 }
 
+void testByteRangeSet() {
+  occa::byteRangeSet ranges;
+  ASSERT_TRUE(ranges.isEmpty());
+
+  ranges.add(10, 20);
+  ranges.add(30, 40);
+  ranges.add(5, 5);
+  ASSERT_EQ((int) ranges.ranges.size(), 2);
+  ASSERT_EQ(ranges.bytes(), (occa::udim_t) 20);
+
+  // Adjacent and overlapping ranges are merged
+  ranges.add(20, 25);
+  ranges.add(24, 32);
+  ASSERT_EQ((int) ranges.ranges.size(), 1);
+  ASSERT_EQ(ranges.ranges[0].first, (occa::udim_t) 10);
+  ASSERT_EQ(ranges.ranges[0].second, (occa::udim_t) 40);
+
+  ranges.add(0, 2);
+  ranges.add(50, 60);
+  ASSERT_EQ((int) ranges.ranges.size(), 3);
+  ASSERT_EQ(ranges.ranges[0].first, (occa::udim_t) 0);
+  ASSERT_EQ(ranges.ranges[2].first, (occa::udim_t) 50);
+
+  // Removing splits ranges
+  ranges.remove(15, 20);
+  ASSERT_EQ((int) ranges.ranges.size(), 4);
+  ASSERT_EQ(ranges.ranges[1].second, (occa::udim_t) 15);
+  ASSERT_EQ(ranges.ranges[2].first, (occa::udim_t) 20);
+  ASSERT_EQ(ranges.bytes(), (occa::udim_t) (2 + 5 + 20 + 10));
+
+  ranges.remove(0, 100);
+  ASSERT_TRUE(ranges.isEmpty());
+}
+
+void testUvaRegistry() {
+  occa::uvaRegistry registry;
+  occa::modeMemory_t *mem1 = (occa::modeMemory_t*) 1;
+  occa::modeMemory_t *mem2 = (occa::modeMemory_t*) 2;
+
+  registry.insert(occa::ptrRange((void*) 10, 10), mem1);
+  registry.insert(occa::ptrRange((void*) 30, 10), mem2);
+  // Zero-sized ranges only match their start
+  registry.insert((void*) 50, mem1);
+  ASSERT_EQ(registry.size(), (size_t) 3);
+
+  ASSERT_EQ(registry.find((void*) 5), (occa::modeMemory_t*) NULL);
+  ASSERT_EQ(registry.find((void*) 10), mem1);
+  ASSERT_EQ(registry.find((void*) 19), mem1);
+  ASSERT_EQ(registry.find((void*) 20), (occa::modeMemory_t*) NULL);
+  ASSERT_EQ(registry.find((void*) 35), mem2);
+  ASSERT_EQ(registry.find((void*) 50), mem1);
+  ASSERT_EQ(registry.find((void*) 51), (occa::modeMemory_t*) NULL);
+
+  // Cached lookups are dropped on updates
+  registry.erase((void*) 15);
+  ASSERT_EQ(registry.find((void*) 10), (occa::modeMemory_t*) NULL);
+  ASSERT_EQ(registry.find((void*) 35), mem2);
+  registry.insert(occa::ptrRange((void*) 5, 10), mem2);
+  ASSERT_EQ(registry.find((void*) 5), mem2);
+  ASSERT_EQ(registry.find((void*) 10), mem2);
+
+  // Overlapping ranges are replaced
+  registry.insert(occa::ptrRange((void*) 35, 10), mem1);
+  ASSERT_EQ(registry.find((void*) 30), (occa::modeMemory_t*) NULL);
+  ASSERT_EQ(registry.find((void*) 35), mem1);
+  ASSERT_EQ(registry.size(), (size_t) 3);
+}
+
 void testUva() {
   int *ptr = occa::umalloc<int>(10);
 